@@ -0,0 +1,432 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+//!
+//! @file libwaei-bench.c
+//!
+//! @brief Micro and macro benchmarks for libwaei
+//!
+//! Times parse_result and compare for every installed dictionary, query
+//! parsing and complete synchronous searches over fixed query sets.  Each
+//! line reports nanoseconds per operation, dictionary lines per second and
+//! allocations per operation.  Dictionaries are taken from the usual
+//! gwaei directory, so point XDG_CONFIG_HOME somewhere else to benchmark a
+//! generated corpus.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libwaei/libwaei.h>
+
+
+static gint _allocations = 0;
+static gboolean _counting_allocations = FALSE;
+
+static const gchar *_edictionary_queries[] = { "日本", "にほん", "nihon", "English", "cat", "食べる", "日.語", "cats&dogs", "water|fire", NULL };
+static const gchar *_kanjidictionary_queries[] = { "日", "魚", "water", "S:4", "G:1", "J:3", NULL };
+static const gchar *_exampledictionary_queries[] = { "日本", "猫", "cat", "go home", NULL };
+static const gchar *_unknowndictionary_queries[] = { "日本", "cat", NULL };
+
+static const gchar *_relevance_names[] = { "low", "medium", "high" };
+
+static gint _iterations = 3;
+static gchar *_filter = NULL;
+
+static GOptionEntry _entries[] = {
+  { "iterations", 'n', 0, G_OPTION_ARG_INT, &_iterations, "Times each benchmark is repeated", "N" },
+  { "filter", 'f', 0, G_OPTION_ARG_STRING, &_filter, "Only benchmark dictionaries whose id contains TEXT", "TEXT" },
+  { NULL }
+};
+
+
+static gpointer
+bench_malloc (gsize n_bytes)
+{
+    g_atomic_int_inc (&_allocations);
+    return malloc (n_bytes);
+}
+
+
+static gpointer
+bench_realloc (gpointer mem, gsize n_bytes)
+{
+    g_atomic_int_inc (&_allocations);
+    return realloc (mem, n_bytes);
+}
+
+
+static gpointer
+bench_calloc (gsize n_blocks, gsize n_block_bytes)
+{
+    g_atomic_int_inc (&_allocations);
+    return calloc (n_blocks, n_block_bytes);
+}
+
+
+//!
+//! @brief Counts allocations made through GLib.  This only works with
+//!        versions of GLib that still honor g_mem_set_vtable.
+//!
+static void
+bench_count_allocations (void)
+{
+    //Declarations
+    GMemVTable vtable = { bench_malloc, bench_realloc, free, bench_calloc, bench_malloc, bench_realloc };
+    gpointer probe;
+
+    g_mem_set_vtable (&vtable);
+
+    probe = g_malloc (1);
+    _counting_allocations = (g_atomic_int_get (&_allocations) > 0);
+    g_free (probe);
+}
+
+
+static void
+bench_print (const gchar *NAME, const gchar *DETAIL, gint64 elapsed, gint64 operations, gint64 lines, gint allocations)
+{
+    //Declarations
+    gdouble ns_per_op;
+    gdouble lines_per_second;
+    gchar *allocations_text;
+
+    //Initializations
+    ns_per_op = (operations > 0) ? (gdouble) elapsed * 1000.0 / (gdouble) operations : 0.0;
+    lines_per_second = (elapsed > 0) ? (gdouble) lines * 1000000.0 / (gdouble) elapsed : 0.0;
+    if (_counting_allocations && operations > 0)
+      allocations_text = g_strdup_printf ("%.1f", (gdouble) allocations / (gdouble) operations);
+    else
+      allocations_text = g_strdup ("n/a");
+
+    printf ("%-20s %-24s %14.1f ns/op %14.0f lines/s %10s allocs/op\n", NAME, DETAIL, ns_per_op, lines_per_second, allocations_text);
+
+    g_free (allocations_text); allocations_text = NULL;
+}
+
+
+static const gchar**
+bench_get_queries (LwDictionary *dictionary)
+{
+    //Declarations
+    GType type;
+
+    //Initializations
+    type = G_OBJECT_TYPE (dictionary);
+
+    if (g_type_is_a (type, LW_TYPE_EDICTIONARY)) return _edictionary_queries;
+    if (g_type_is_a (type, LW_TYPE_KANJIDICTIONARY)) return _kanjidictionary_queries;
+    if (g_type_is_a (type, LW_TYPE_EXAMPLEDICTIONARY)) return _exampledictionary_queries;
+    return _unknowndictionary_queries;
+}
+
+
+static LwSearchFlags
+bench_get_flags (void)
+{
+    return (LW_SEARCH_FLAG_ROMAJI_TO_FURIGANA | LW_SEARCH_FLAG_HIRAGANA_TO_KATAKANA | LW_SEARCH_FLAG_KATAKANA_TO_HIRAGANA | LW_SEARCH_FLAG_DELIMIT_WHITESPACE);
+}
+
+
+static LwQuery*
+bench_new_query (LwDictionary *dictionary, const gchar *TEXT)
+{
+    //Declarations
+    LwQuery *query;
+    GError *error;
+
+    //Initializations
+    query = lw_query_new ();
+    query->flags = bench_get_flags () & 0xFFFF;
+    error = NULL;
+
+    lw_dictionary_parse_query (dictionary, query, TEXT, &error);
+    if (error != NULL)
+    {
+      fprintf (stderr, "Could not parse \"%s\": %s\n", TEXT, error->message);
+      g_error_free (error); error = NULL;
+    }
+
+    return query;
+}
+
+
+//!
+//! @brief Reads every line of a dictionary, optionally comparing each one
+//! @returns The number of lines read
+//!
+static gint64
+bench_scan (LwDictionary *dictionary, LwQuery *query, LwRelevance relevance, gint64 *elapsed, gint *allocations)
+{
+    //Declarations
+    LwResult *result;
+    FILE *file;
+    gint64 lines;
+    gint64 start;
+    gint start_allocations;
+
+    //Initializations
+    file = lw_dictionary_open (dictionary);
+    if (file == NULL) return 0;
+    result = lw_result_new ();
+    lines = 0;
+    start_allocations = g_atomic_int_get (&_allocations);
+    start = g_get_monotonic_time ();
+
+    while (lw_dictionary_parse_result (dictionary, result, file) > 0)
+    {
+      if (query != NULL) lw_dictionary_compare (dictionary, query, result, relevance);
+      lines++;
+    }
+
+    *elapsed += g_get_monotonic_time () - start;
+    *allocations += g_atomic_int_get (&_allocations) - start_allocations;
+
+    //Cleanup
+    lw_result_free (result);
+    fclose (file);
+
+    return lines;
+}
+
+
+static void
+bench_parse_result (LwDictionary *dictionary, gint64 *parse_elapsed, gint64 *parse_lines, gint *parse_allocations)
+{
+    //Declarations
+    gint i;
+
+    //Initializations
+    *parse_elapsed = 0;
+    *parse_lines = 0;
+    *parse_allocations = 0;
+
+    for (i = 0; i < _iterations; i++)
+      *parse_lines += bench_scan (dictionary, NULL, LW_RELEVANCE_LOW, parse_elapsed, parse_allocations);
+
+    bench_print (lw_dictionary_get_filename (dictionary), "parse_result", *parse_elapsed, *parse_lines, *parse_lines, *parse_allocations);
+}
+
+
+//!
+//! @brief Times compare by subtracting the cost of parsing the same lines
+//!
+static void
+bench_compare (LwDictionary *dictionary, gint64 parse_elapsed, gint64 parse_lines, gint parse_allocations)
+{
+    //Declarations
+    const gchar **queries;
+    LwQuery *query;
+    gint relevance;
+    gint64 elapsed;
+    gint64 lines;
+    gint allocations;
+    gchar *detail;
+    gint i, j;
+
+    //Initializations
+    queries = bench_get_queries (dictionary);
+
+    for (relevance = LW_RELEVANCE_HIGH; relevance >= LW_RELEVANCE_LOW; relevance--)
+    {
+      elapsed = 0;
+      lines = 0;
+      allocations = 0;
+
+      for (i = 0; queries[i] != NULL; i++)
+      {
+        query = bench_new_query (dictionary, queries[i]);
+        for (j = 0; j < _iterations; j++)
+          lines += bench_scan (dictionary, query, relevance, &elapsed, &allocations);
+        lw_query_free (query); query = NULL;
+      }
+
+      //Remove the share of the scan that was spent parsing
+      if (parse_lines > 0)
+      {
+        elapsed -= (gint64) ((gdouble) parse_elapsed * (gdouble) lines / (gdouble) parse_lines);
+        allocations -= (gint) ((gdouble) parse_allocations * (gdouble) lines / (gdouble) parse_lines);
+        if (elapsed < 0) elapsed = 0;
+        if (allocations < 0) allocations = 0;
+      }
+
+      detail = g_strdup_printf ("compare %s", _relevance_names[relevance]);
+      bench_print (lw_dictionary_get_filename (dictionary), detail, elapsed, lines, lines, allocations);
+      g_free (detail); detail = NULL;
+    }
+}
+
+
+static void
+bench_parse_query (LwDictionary *dictionary)
+{
+    //Declarations
+    const gchar **queries;
+    LwQuery *query;
+    gint64 elapsed;
+    gint64 operations;
+    gint64 start;
+    gint allocations;
+    gint start_allocations;
+    gint i, j;
+
+    //Initializations
+    queries = bench_get_queries (dictionary);
+    elapsed = 0;
+    operations = 0;
+    allocations = 0;
+
+    for (j = 0; j < _iterations * 100; j++)
+    {
+      for (i = 0; queries[i] != NULL; i++)
+      {
+        start_allocations = g_atomic_int_get (&_allocations);
+        start = g_get_monotonic_time ();
+
+        query = bench_new_query (dictionary, queries[i]);
+
+        elapsed += g_get_monotonic_time () - start;
+        allocations += g_atomic_int_get (&_allocations) - start_allocations;
+        operations++;
+
+        lw_query_free (query); query = NULL;
+      }
+    }
+
+    bench_print (lw_dictionary_get_filename (dictionary), "parse_query", elapsed, operations, 0, allocations);
+}
+
+
+static void
+bench_search (LwDictionary *dictionary, gint64 dictionary_lines)
+{
+    //Declarations
+    const gchar **queries;
+    LwSearch *search;
+    LwResult *result;
+    GError *error;
+    gint64 elapsed;
+    gint64 operations;
+    gint64 start;
+    gint allocations;
+    gint start_allocations;
+    gint i, j;
+
+    //Initializations
+    queries = bench_get_queries (dictionary);
+    elapsed = 0;
+    operations = 0;
+    allocations = 0;
+    error = NULL;
+
+    for (j = 0; j < _iterations; j++)
+    {
+      for (i = 0; queries[i] != NULL; i++)
+      {
+        start_allocations = g_atomic_int_get (&_allocations);
+        start = g_get_monotonic_time ();
+
+        search = lw_search_new (dictionary, queries[i], bench_get_flags (), &error);
+        if (search != NULL)
+        {
+          lw_search_start (search, FALSE);
+          while ((result = lw_search_get_result (search)) != NULL) lw_result_free (result);
+          lw_search_free (search); search = NULL;
+        }
+
+        elapsed += g_get_monotonic_time () - start;
+        allocations += g_atomic_int_get (&_allocations) - start_allocations;
+        operations++;
+
+        if (error != NULL) { g_error_free (error); error = NULL; }
+      }
+    }
+
+    bench_print (lw_dictionary_get_filename (dictionary), "search", elapsed, operations, dictionary_lines * operations, allocations);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    LwDictionaryList *dictionarylist;
+    LwDictionary *dictionary;
+    GList *link;
+    GError *error;
+    gint64 parse_elapsed;
+    gint64 parse_lines;
+    gint parse_allocations;
+    gchar *id;
+
+    bench_count_allocations ();
+    g_type_init ();
+
+    //Initializations
+    error = NULL;
+    context = g_option_context_new ("- benchmark libwaei");
+    g_option_context_add_main_entries (context, _entries, NULL);
+    if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error); error = NULL;
+      return 1;
+    }
+    if (_iterations < 1) _iterations = 1;
+
+    lw_regex_initialize ();
+    dictionarylist = lw_dictionarylist_new ();
+    lw_dictionarylist_load_installed (dictionarylist);
+
+    if (lw_dictionarylist_get_total (dictionarylist) == 0)
+    {
+      printf ("No installed dictionaries were found.  Install some or set XDG_CONFIG_HOME to a directory with a generated corpus.\n");
+    }
+
+    for (link = lw_dictionarylist_get_list (dictionarylist); link != NULL; link = link->next)
+    {
+      dictionary = LW_DICTIONARY (link->data);
+      id = lw_dictionary_build_id (dictionary);
+
+      if (_filter == NULL || strstr (id, _filter) != NULL)
+      {
+        bench_parse_result (dictionary, &parse_elapsed, &parse_lines, &parse_allocations);
+        bench_compare (dictionary, parse_elapsed, parse_lines, parse_allocations);
+        bench_parse_query (dictionary);
+        bench_search (dictionary, parse_lines / _iterations);
+      }
+
+      g_free (id); id = NULL;
+    }
+
+    //Cleanup
+    g_object_unref (dictionarylist); dictionarylist = NULL;
+    lw_regex_free ();
+    g_option_context_free (context); context = NULL;
+    g_free (_filter); _filter = NULL;
+
+    return 0;
+}
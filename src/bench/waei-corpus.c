@@ -0,0 +1,572 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+//!
+//! @file waei-corpus.c
+//!
+//! @brief Writes synthetic dictionaries for reproducible load tests
+//!
+//! Generates edict, kanjidic, kradfile, examples and enamdict files in the
+//! same layout as the real ones so they can be installed from local paths
+//! through the normal installer, for example by pointing the English source
+//! key at the generated edict.  Every character comes from JIS X 0208 so the
+//! files can be written in EUC-JP like the originals.  The same seed and
+//! scale always produce the same files.
+//!
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+//Approximate entry counts of the real dictionaries at scale 1
+#define CORPUS_EDICT_ENTRIES 170000
+#define CORPUS_KANJIDIC_ENTRIES 6355
+#define CORPUS_EXAMPLES_ENTRIES 150000
+#define CORPUS_ENAMDICT_ENTRIES 740000
+
+#define CORPUS_VOCABULARY_SIZE 8192
+
+
+typedef struct {
+  GRand *rand;
+  GPtrArray *kanji;         //!< Every JIS X 0208 kanji in UTF-8
+  GPtrArray *words;         //!< Kanji headwords reused by the examples
+  GPtrArray *readings;      //!< Hiragana readings of words
+  const gchar *encoding;
+} Corpus;
+
+
+static const gchar *_hiragana[] = {
+  "あ", "い", "う", "え", "お", "か", "き", "く", "け", "こ", "さ", "し", "す", "せ", "そ",
+  "た", "ち", "つ", "て", "と", "な", "に", "ぬ", "ね", "の", "は", "ひ", "ふ", "へ", "ほ",
+  "ま", "み", "む", "め", "も", "や", "ゆ", "よ", "ら", "り", "る", "れ", "ろ", "わ", "ん",
+  "が", "ぎ", "ぐ", "げ", "ご", "ざ", "じ", "ず", "ぜ", "ぞ", "だ", "で", "ど", "ば", "び",
+  "ぶ", "べ", "ぼ", "ぱ", "ぴ", "ぷ", "ぺ", "ぽ", "きょ", "しょ", "ちょ", "りょ", "じゅ", "にゅ", NULL
+};
+
+static const gchar *_katakana[] = {
+  "ア", "イ", "ウ", "エ", "オ", "カ", "キ", "ク", "ケ", "コ", "サ", "シ", "ス", "セ", "ソ",
+  "タ", "チ", "ツ", "テ", "ト", "ナ", "ニ", "ヌ", "ネ", "ノ", "ハ", "ヒ", "フ", "ヘ", "ホ",
+  "マ", "ミ", "ム", "メ", "モ", "ヤ", "ユ", "ヨ", "ラ", "リ", "ル", "レ", "ロ", "ワ", "ン",
+  "ガ", "ギ", "グ", "ゲ", "ゴ", "ザ", "ジ", "ズ", "ゼ", "ゾ", "ダ", "デ", "ド", "バ", "ビ",
+  "キョウ", "ショウ", "チョウ", "リョウ", "ジュウ", "コウ", "トウ", "セイ", "ケイ", "ガク", NULL
+};
+
+static const gchar *_radicals[] = {
+  "一", "｜", "丶", "ノ", "乙", "亅", "二", "亠", "人", "儿", "入", "八", "冂", "冖", "几",
+  "凵", "刀", "力", "勹", "匕", "匚", "十", "卜", "卩", "厂", "厶", "又", "口", "囗", "土",
+  "士", "夂", "夕", "大", "女", "子", "宀", "寸", "小", "尸", "山", "川", "工", "己", "巾",
+  "干", "广", "廴", "弋", "弓", "彡", "彳", "心", "戈", "戸", "手", "支", "文", "斗", "斤",
+  "方", "日", "月", "木", "欠", "止", "殳", "毋", "比", "毛", "氏", "水", "火", "父", "片",
+  "牛", "犬", "玉", "瓦", "甘", "生", "用", "田", "疋", "白", "皮", "皿", "目", "矛", "矢",
+  "石", "示", "禾", "穴", "立", "竹", "米", "糸", "缶", "羊", "羽", "耳", "肉", "臣", "自",
+  "至", "舌", "舟", "色", "虫", "血", "行", "衣", "見", "角", "言", "谷", "豆", "貝", "赤",
+  "走", "足", "身", "車", "辛", "辰", "酉", "釆", "里", "金", "長", "門", "雨", "青", "非",
+  "面", "革", "音", "頁", "風", "飛", "食", "首", "香", "馬", "骨", "高", "魚", "鳥", "黒", NULL
+};
+
+static const gchar *_english[] = {
+  "water", "fire", "mountain", "river", "tree", "person", "book", "cat", "dog", "house",
+  "school", "teacher", "student", "car", "train", "station", "city", "country", "language", "word",
+  "time", "day", "night", "morning", "evening", "year", "month", "week", "hour", "minute",
+  "big", "small", "long", "short", "new", "old", "good", "bad", "high", "low",
+  "eat", "drink", "see", "hear", "speak", "read", "write", "go", "come", "return",
+  "buy", "sell", "make", "use", "think", "know", "wait", "stand", "sit", "sleep",
+  "red", "blue", "white", "black", "green", "light", "dark", "heavy", "fast", "slow",
+  "friend", "family", "mother", "father", "child", "company", "work", "money", "shop", "food",
+  "rice", "fish", "meat", "tea", "sake", "flower", "sky", "rain", "snow", "wind",
+  "east", "west", "south", "north", "left", "right", "inside", "outside", "before", "after",
+  "music", "picture", "letter", "paper", "door", "window", "road", "bridge", "island", "sea",
+  "heart", "body", "hand", "foot", "eye", "ear", "mouth", "head", "voice", "name", NULL
+};
+
+static const gchar *_pos[] = { "n", "n,vs", "v5r", "v5k", "v1,vt", "adj-i", "adj-na", "adv", "exp", "n,adj-no", NULL };
+static const gchar *_enamdict_tags[] = { "s", "s", "p", "p", "u", "u", "g", "f", "f", "m", "h", "pr", "co", "st", NULL };
+static const gchar *_particles[] = { "は", "が", "を", "に", "で", "と", "の", "も", NULL };
+
+static gint _seed = 1;
+static gdouble _scale = 1.0;
+static gchar *_output = NULL;
+static gchar *_encoding = NULL;
+
+static GOptionEntry _entries[] = {
+  { "output", 'o', 0, G_OPTION_ARG_FILENAME, &_output, "Directory to write the dictionaries to", "DIR" },
+  { "scale", 's', 0, G_OPTION_ARG_DOUBLE, &_scale, "Size relative to the real dictionaries", "FACTOR" },
+  { "seed", 'r', 0, G_OPTION_ARG_INT, &_seed, "Seed for the random generator", "N" },
+  { "encoding", 'e', 0, G_OPTION_ARG_STRING, &_encoding, "Encoding of the written files, EUC-JP by default", "NAME" },
+  { NULL }
+};
+
+
+static gint
+corpus_count (const gchar **list)
+{
+    gint i;
+    for (i = 0; list[i] != NULL; i++);
+    return i;
+}
+
+
+static const gchar*
+corpus_pick (Corpus *corpus, const gchar **list)
+{
+    return list[g_rand_int_range (corpus->rand, 0, corpus_count (list))];
+}
+
+
+//!
+//! @brief Collects every kanji of JIS X 0208 (rows 16 through 84)
+//!
+static GPtrArray*
+corpus_build_kanji (void)
+{
+    //Declarations
+    GPtrArray *kanji;
+    gchar euc[3];
+    gchar *utf8;
+    gint row, cell;
+
+    //Initializations
+    kanji = g_ptr_array_new_with_free_func (g_free);
+    euc[2] = '\0';
+
+    for (row = 0xB0; row <= 0xF4; row++)
+    {
+      for (cell = 0xA1; cell <= 0xFE; cell++)
+      {
+        euc[0] = (gchar) row;
+        euc[1] = (gchar) cell;
+        utf8 = g_convert (euc, 2, "UTF-8", "EUC-JP", NULL, NULL, NULL);
+        if (utf8 != NULL && g_unichar_isdefined (g_utf8_get_char (utf8)) && g_utf8_strlen (utf8, -1) == 1)
+          g_ptr_array_add (kanji, utf8);
+        else
+          g_free (utf8);
+      }
+    }
+
+    return kanji;
+}
+
+
+static void
+corpus_append_kana (Corpus *corpus, GString *text, const gchar **syllables, gint min, gint max)
+{
+    gint i, length;
+
+    length = g_rand_int_range (corpus->rand, min, max + 1);
+    for (i = 0; i < length; i++)
+      g_string_append (text, corpus_pick (corpus, syllables));
+}
+
+
+static void
+corpus_append_english (Corpus *corpus, GString *text, gint min, gint max)
+{
+    gint i, length;
+
+    length = g_rand_int_range (corpus->rand, min, max + 1);
+    for (i = 0; i < length; i++)
+    {
+      if (i > 0) g_string_append_c (text, ' ');
+      g_string_append (text, corpus_pick (corpus, _english));
+    }
+}
+
+
+static const gchar*
+corpus_random_kanji (Corpus *corpus)
+{
+    //Common kanji show up much more often than rare ones
+    guint limit;
+
+    limit = (g_rand_int_range (corpus->rand, 0, 4) == 0) ? corpus->kanji->len : MIN (2000, corpus->kanji->len);
+
+    return g_ptr_array_index (corpus->kanji, g_rand_int_range (corpus->rand, 0, limit));
+}
+
+
+static void
+corpus_build_vocabulary (Corpus *corpus)
+{
+    //Declarations
+    GString *word;
+    GString *reading;
+    gint i, j, length;
+
+    //Initializations
+    corpus->words = g_ptr_array_new_with_free_func (g_free);
+    corpus->readings = g_ptr_array_new_with_free_func (g_free);
+    word = g_string_new (NULL);
+    reading = g_string_new (NULL);
+
+    for (i = 0; i < CORPUS_VOCABULARY_SIZE; i++)
+    {
+      g_string_truncate (word, 0);
+      g_string_truncate (reading, 0);
+      length = g_rand_int_range (corpus->rand, 1, 4);
+      for (j = 0; j < length; j++)
+      {
+        g_string_append (word, corpus_random_kanji (corpus));
+        corpus_append_kana (corpus, reading, _hiragana, 1, 2);
+      }
+      g_ptr_array_add (corpus->words, g_strdup (word->str));
+      g_ptr_array_add (corpus->readings, g_strdup (reading->str));
+    }
+
+    g_string_free (word, TRUE);
+    g_string_free (reading, TRUE);
+}
+
+
+//!
+//! @brief Writes a UTF-8 line converted to the output encoding
+//!
+static gboolean
+corpus_write (Corpus *corpus, FILE *file, GString *line)
+{
+    //Declarations
+    gchar *converted;
+    gsize length;
+    gboolean written;
+
+    if (g_ascii_strcasecmp (corpus->encoding, "UTF-8") == 0)
+      return (fwrite (line->str, 1, line->len, file) == line->len);
+
+    converted = g_convert_with_fallback (line->str, line->len, corpus->encoding, "UTF-8", "?", NULL, &length, NULL);
+    if (converted == NULL) return FALSE;
+    written = (fwrite (converted, 1, length, file) == length);
+    g_free (converted);
+
+    return written;
+}
+
+
+static FILE*
+corpus_open (const gchar *FILENAME)
+{
+    //Declarations
+    gchar *path;
+    FILE *file;
+
+    //Initializations
+    path = g_build_filename (_output, FILENAME, NULL);
+    file = g_fopen (path, "wb");
+
+    if (file == NULL)
+      fprintf (stderr, "Could not open %s for writing\n", path);
+    else
+      printf ("Writing %s\n", path);
+
+    g_free (path);
+
+    return file;
+}
+
+
+static gint
+corpus_get_total (gint entries)
+{
+    return MAX (1, (gint) ((gdouble) entries * _scale));
+}
+
+
+static void
+corpus_append_senses (Corpus *corpus, GString *line, const gchar *POS)
+{
+    //Declarations
+    gint i, senses;
+
+    //Initializations
+    senses = g_rand_int_range (corpus->rand, 1, 5);
+
+    g_string_append_printf (line, "/(%s) ", POS);
+    for (i = 0; i < senses; i++)
+    {
+      if (senses > 1) g_string_append_printf (line, "(%d) ", i + 1);
+      corpus_append_english (corpus, line, 1, 3);
+      g_string_append_c (line, '/');
+    }
+}
+
+
+static void
+corpus_write_edict (Corpus *corpus)
+{
+    //Declarations
+    FILE *file;
+    GString *line;
+    gint i, total, index;
+
+    //Initializations
+    file = corpus_open ("edict");
+    if (file == NULL) return;
+    line = g_string_sized_new (256);
+    total = corpus_get_total (CORPUS_EDICT_ENTRIES);
+
+    g_string_assign (line, "　？？？ /EDICT, synthetic corpus generated by waei-corpus/\n");
+    corpus_write (corpus, file, line);
+
+    for (i = 0; i < total; i++)
+    {
+      g_string_truncate (line, 0);
+      index = g_rand_int_range (corpus->rand, 0, corpus->words->len);
+
+      //A few entries are kana only like in the real edict
+      if (g_rand_int_range (corpus->rand, 0, 10) == 0)
+      {
+        corpus_append_kana (corpus, line, _katakana, 2, 4);
+        g_string_append_c (line, ' ');
+      }
+      else
+      {
+        g_string_append_printf (line, "%s [%s] ", (gchar*) g_ptr_array_index (corpus->words, index), (gchar*) g_ptr_array_index (corpus->readings, index));
+      }
+      corpus_append_senses (corpus, line, corpus_pick (corpus, _pos));
+      if (g_rand_int_range (corpus->rand, 0, 8) == 0) g_string_append (line, "(P)/");
+      g_string_append_c (line, '\n');
+
+      if (!corpus_write (corpus, file, line)) break;
+    }
+
+    g_string_free (line, TRUE);
+    fclose (file);
+}
+
+
+//!
+//! @brief Writes kanjidic and the kradfile used to merge in radicals
+//!
+static void
+corpus_write_kanjidic (Corpus *corpus)
+{
+    //Declarations
+    FILE *file;
+    FILE *radicals_file;
+    GString *line;
+    const gchar *kanji;
+    gunichar c;
+    gint i, j, total, radicals;
+    gchar *euc;
+
+    //Initializations
+    file = corpus_open ("kanjidic");
+    radicals_file = corpus_open ("kradfile");
+    if (file == NULL || radicals_file == NULL) goto errored;
+    line = g_string_sized_new (256);
+    total = corpus_get_total (CORPUS_KANJIDIC_ENTRIES);
+
+    g_string_assign (line, "# KANJIDIC, synthetic corpus generated by waei-corpus\n");
+    corpus_write (corpus, file, line);
+    g_string_assign (line, "# KRADFILE, synthetic corpus generated by waei-corpus\n");
+    corpus_write (corpus, radicals_file, line);
+
+    for (i = 0; i < total; i++)
+    {
+      //Past the size of JIS X 0208 the characters repeat
+      kanji = g_ptr_array_index (corpus->kanji, i % corpus->kanji->len);
+      c = g_utf8_get_char (kanji);
+      euc = g_convert (kanji, -1, "EUC-JP", "UTF-8", NULL, NULL, NULL);
+
+      g_string_truncate (line, 0);
+      g_string_append_printf (line, "%s %02X%02X U%04x", kanji, (euc != NULL) ? (guchar) euc[0] - 0x80 : 0, (euc != NULL) ? (guchar) euc[1] - 0x80 : 0, c);
+      if (euc != NULL) g_free (euc); euc = NULL;
+      g_string_append_printf (line, " B%d", g_rand_int_range (corpus->rand, 1, 215));
+      if (i < 2136) g_string_append_printf (line, " G%d", (i < 1006) ? i / 170 + 1 : 8);
+      g_string_append_printf (line, " S%d", g_rand_int_range (corpus->rand, 1, 30));
+      if (i < 2500) g_string_append_printf (line, " F%d", i + 1);
+      if (i < 2000) g_string_append_printf (line, " J%d", 4 - i / 500);
+      g_string_append_c (line, ' ');
+      corpus_append_kana (corpus, line, _katakana, 1, 2);
+      g_string_append_c (line, ' ');
+      corpus_append_kana (corpus, line, _hiragana, 1, 2);
+      g_string_append_c (line, '.');
+      corpus_append_kana (corpus, line, _hiragana, 1, 1);
+      if (g_rand_int_range (corpus->rand, 0, 4) == 0)
+      {
+        g_string_append (line, " T1 ");
+        corpus_append_kana (corpus, line, _hiragana, 1, 3);
+      }
+      for (j = g_rand_int_range (corpus->rand, 1, 4); j > 0; j--)
+      {
+        g_string_append (line, " {");
+        corpus_append_english (corpus, line, 1, 2);
+        g_string_append_c (line, '}');
+      }
+      g_string_append (line, " \n");
+      if (!corpus_write (corpus, file, line)) break;
+
+      //Only the first occurence of a character gets a radicals line
+      if (i < (gint) corpus->kanji->len)
+      {
+        g_string_truncate (line, 0);
+        g_string_append_printf (line, "%s :", kanji);
+        radicals = g_rand_int_range (corpus->rand, 1, 5);
+        for (j = 0; j < radicals; j++)
+          g_string_append_printf (line, " %s", corpus_pick (corpus, _radicals));
+        g_string_append_c (line, '\n');
+        if (!corpus_write (corpus, radicals_file, line)) break;
+      }
+    }
+
+    g_string_free (line, TRUE);
+
+errored:
+
+    if (file != NULL) fclose (file);
+    if (radicals_file != NULL) fclose (radicals_file);
+}
+
+
+static void
+corpus_write_examples (Corpus *corpus)
+{
+    //Declarations
+    FILE *file;
+    GString *line;
+    GString *b;
+    const gchar *word;
+    const gchar *particle;
+    gint i, j, total, length, index;
+
+    //Initializations
+    file = corpus_open ("examples");
+    if (file == NULL) return;
+    line = g_string_sized_new (512);
+    b = g_string_sized_new (512);
+    total = corpus_get_total (CORPUS_EXAMPLES_ENTRIES);
+
+    for (i = 0; i < total; i++)
+    {
+      g_string_assign (line, "A: ");
+      g_string_assign (b, "B:");
+      length = g_rand_int_range (corpus->rand, 2, 6);
+
+      for (j = 0; j < length; j++)
+      {
+        index = g_rand_int_range (corpus->rand, 0, corpus->words->len);
+        word = g_ptr_array_index (corpus->words, index);
+        particle = corpus_pick (corpus, _particles);
+        g_string_append_printf (line, "%s%s", word, particle);
+        g_string_append_printf (b, " %s(%s) %s", word, (gchar*) g_ptr_array_index (corpus->readings, index), particle);
+      }
+      g_string_append (line, "。\t");
+      corpus_append_english (corpus, line, 3, 10);
+      g_string_append_printf (line, ".#ID=%d_%d\n", i * 2 + 1, i * 2 + 2);
+      g_string_append_c (b, '\n');
+      g_string_append_len (line, b->str, b->len);
+
+      if (!corpus_write (corpus, file, line)) break;
+    }
+
+    g_string_free (line, TRUE);
+    g_string_free (b, TRUE);
+    fclose (file);
+}
+
+
+static void
+corpus_write_enamdict (Corpus *corpus)
+{
+    //Declarations
+    FILE *file;
+    GString *line;
+    const gchar *tag;
+    gint i, total, index;
+
+    //Initializations
+    file = corpus_open ("enamdict");
+    if (file == NULL) return;
+    line = g_string_sized_new (256);
+    total = corpus_get_total (CORPUS_ENAMDICT_ENTRIES);
+
+    g_string_assign (line, "　？？？ /ENAMDICT, synthetic corpus generated by waei-corpus/\n");
+    corpus_write (corpus, file, line);
+
+    for (i = 0; i < total; i++)
+    {
+      g_string_truncate (line, 0);
+      index = g_rand_int_range (corpus->rand, 0, corpus->words->len);
+      tag = corpus_pick (corpus, _enamdict_tags);
+
+      g_string_append_printf (line, "%s [%s] /", (gchar*) g_ptr_array_index (corpus->words, index), (gchar*) g_ptr_array_index (corpus->readings, index));
+      //Some entries carry two classifications like "(s,f)"
+      if (g_rand_int_range (corpus->rand, 0, 10) == 0)
+        g_string_append_printf (line, "(%s,%s) ", tag, corpus_pick (corpus, _enamdict_tags));
+      else
+        g_string_append_printf (line, "(%s) ", tag);
+      corpus_append_english (corpus, line, 1, 2);
+      g_string_append (line, "/\n");
+
+      if (!corpus_write (corpus, file, line)) break;
+    }
+
+    g_string_free (line, TRUE);
+    fclose (file);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+    //Declarations
+    GOptionContext *context;
+    GError *error;
+    Corpus corpus;
+
+    //Initializations
+    error = NULL;
+    context = g_option_context_new ("- write synthetic dictionaries");
+    g_option_context_add_main_entries (context, _entries, NULL);
+    if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      fprintf (stderr, "%s\n", error->message);
+      g_error_free (error); error = NULL;
+      return 1;
+    }
+    if (_output == NULL) _output = g_strdup (".");
+    if (_encoding == NULL) _encoding = g_strdup ("EUC-JP");
+    if (_scale <= 0.0) _scale = 1.0;
+    g_mkdir_with_parents (_output, 0755);
+
+    corpus.rand = g_rand_new_with_seed ((guint32) _seed);
+    corpus.encoding = _encoding;
+    corpus.kanji = corpus_build_kanji ();
+    corpus_build_vocabulary (&corpus);
+
+    corpus_write_edict (&corpus);
+    corpus_write_kanjidic (&corpus);
+    corpus_write_examples (&corpus);
+    corpus_write_enamdict (&corpus);
+
+    //Cleanup
+    g_ptr_array_free (corpus.kanji, TRUE);
+    g_ptr_array_free (corpus.words, TRUE);
+    g_ptr_array_free (corpus.readings, TRUE);
+    g_rand_free (corpus.rand);
+    g_option_context_free (context);
+    g_free (_output); _output = NULL;
+    g_free (_encoding); _encoding = NULL;
+
+    return 0;
+}
@@ -91,7 +91,6 @@ gw_application_constructed (GObject *object)
       G_OBJECT_CLASS (gw_application_parent_class)->constructed (object);
     }
 
-    lw_regex_initialize ();
     gw_application_initialize_accelerators (GW_APPLICATION (object));
 
 /*
@@ -136,6 +135,7 @@ gw_application_finalize (GObject *object)
     if (priv->context != NULL) g_option_context_free (priv->context); priv->context = NULL;
     if (priv->arg_query != NULL) g_free(priv->arg_query); priv->arg_query = NULL;
     if (priv->preferences != NULL) lw_preferences_free (priv->preferences); priv->preferences = NULL;
+    if (priv->historylog != NULL) lw_historylog_free (priv->historylog); priv->historylog = NULL;
 #if WITH_MECAB
     if (lw_morphologyengine_has_default ()) 
     {
@@ -521,6 +521,34 @@ gw_application_get_preferences (GwApplication *application)
 }
 
 
+//!
+//! @brief Gets the log of searches shared by the search windows, opening it
+//!        the first time it is asked for
+//!
+LwHistoryLog*
+gw_application_get_historylog (GwApplication *application)
+{
+    //Declarations
+    GwApplicationPrivate *priv;
+    gchar *path;
+
+    //Initializations
+    priv = application->priv;
+
+    if (priv->historylog == NULL)
+    {
+      path = lw_util_build_filename (LW_PATH_BASE, "history");
+      if (path != NULL)
+      {
+        priv->historylog = lw_historylog_new (path);
+        g_free (path); path = NULL;
+      }
+    }
+
+    return priv->historylog;
+}
+
+
 GwDictionaryList* 
 gw_application_get_installed_dictionarylist (GwApplication *application)
 {
@@ -272,25 +272,27 @@ gw_flashcardwindow_user_answer_is_correct (GwFlashCardWindow *window)
     gchar *user;
     gchar *card;
     gboolean is_correct;
-    gboolean convertable;
-    const gint MAX = 100;
-    gchar hiragana[MAX];
-    gchar katakana[MAX];
+    gchar *hiragana;
+    gchar *katakana;
 
     //Initializations
     priv = window->priv;
     user = lw_util_collapse_string (gtk_entry_get_text (priv->answer_entry));
     card = lw_util_collapse_string (priv->answer);
-    convertable = lw_util_str_roma_to_hira (user, hiragana, MAX);
+    hiragana = NULL;
+    katakana = NULL;
+    if (user != NULL)
+    {
+      hiragana = lw_util_romaji_to_kana (user, LW_KANA_SCRIPT_HIRAGANA);
+      katakana = lw_util_romaji_to_kana (user, LW_KANA_SCRIPT_KATAKANA);
+    }
 
     if (user == NULL || card == NULL || *user == '\0')
     {
       is_correct = FALSE;
     }
-    else if (convertable)
+    else if (hiragana != NULL && katakana != NULL)
     {
-      strcpy(katakana, hiragana);
-      lw_util_str_shift_hira_to_kata (katakana);
       is_correct = (strstr(card, user) != NULL || strstr(card, hiragana) != NULL || strstr(card, katakana) != NULL);
     }
     else
@@ -300,6 +302,8 @@ gw_flashcardwindow_user_answer_is_correct (GwFlashCardWindow *window)
 
     if (user != NULL) g_free (card);
     if (card != NULL) g_free (user);
+    if (hiragana != NULL) g_free (hiragana);
+    if (katakana != NULL) g_free (katakana);
 
     return is_correct;
 }
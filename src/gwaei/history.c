@@ -171,7 +171,7 @@ gw_history_sync_menumodels (GwHistory *history)
       GList *link;
       GMenuModel *menumodel;
       GMenu *menu;
-      LwSearch *search;
+      LwHistoryRecord *record;
       const gchar *label;
       gchar *detailed_action;
       gint i;
@@ -187,8 +187,8 @@ gw_history_sync_menumodels (GwHistory *history)
 
       while (link != NULL)
       {
-        search = LW_SEARCH (link->data);
-        label = lw_query_get_text (search->query);
+        record = (LwHistoryRecord*) link->data;
+        label = record->query;
         detailed_action = g_strdup_printf ("win.go-back-index::%d", i);
 
         g_menu_append (menu, label, detailed_action);
@@ -205,7 +205,7 @@ gw_history_sync_menumodels (GwHistory *history)
       GList *link;
       GMenuModel *menumodel;
       GMenu *menu;
-      LwSearch *search;
+      LwHistoryRecord *record;
       const gchar *label;
       gchar *detailed_action;
       gint i;
@@ -221,8 +221,8 @@ gw_history_sync_menumodels (GwHistory *history)
 
       while (link != NULL)
       {
-        search = LW_SEARCH (link->data);
-        label = lw_query_get_text (search->query);
+        record = (LwHistoryRecord*) link->data;
+        label = record->query;
         detailed_action = g_strdup_printf ("win.go-forward-index::%d", i);
 
         g_menu_append (menu, label, detailed_action);
@@ -21,6 +21,7 @@ struct _GwApplicationPrivate {
   GError *error;
 
   LwPreferences *preferences;
+  LwHistoryLog *historylog;
   GwDictionaryList *installed_dictionarylist;
   GwDictionaryList *installable_dictionarylist;
   GwSearchWindow *last_focused;
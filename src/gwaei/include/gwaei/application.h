@@ -69,6 +69,7 @@ void gw_application_set_last_focused_searchwindow (GwApplication*, struct _GwSea
 struct _GwSearchWindow* gw_application_get_last_focused_searchwindow (GwApplication*);
 
 LwPreferences* gw_application_get_preferences (GwApplication*);
+LwHistoryLog* gw_application_get_historylog (GwApplication*);
 GtkListStore* gw_application_get_dictionarystore (GwApplication*);
 GwDictionaryList* gw_application_get_installed_dictionarylist (GwApplication*);
 GwDictionaryList* gw_application_get_installable_dictionarylist (GwApplication*);
@@ -3,6 +3,5 @@
 
 gboolean gw_installprogresswindow_update_ui_timeout (gpointer);
 void gw_installprogresswindow_start_cb (GtkWidget*, gpointer);
-void gw_installprogresswindow_update_dictionary_cb (LwDictionary*, gpointer);
 
 #endif
@@ -12,10 +12,11 @@ struct _GwInstallProgressWindowPrivate {
   GtkProgressBar* progressbar;
   GtkButton *cancel_button;
 
-  gdouble install_fraction;
   GMutex mutex;
 };
 
+#define GW_INSTALLPROGRESSWINDOW_INSTALL_JOBS 4
+
 #define GW_INSTALLPROGRESSWINDOW_GET_PRIVATE(object)(G_TYPE_INSTANCE_GET_PRIVATE ((object), GW_TYPE_INSTALLPROGRESSWINDOW, GwInstallProgressWindowPrivate))
 
 G_END_DECLS
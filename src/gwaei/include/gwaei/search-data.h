@@ -5,12 +5,15 @@
 
 struct _GwSearchData {
   GtkTextView *view;
+  GtkTreeView *list;  //!< The result list of the tab, which takes the results once there are many
   GwSearchWindow *window;
   LwResult *result;
+  gint appended;      //!< How many results were appended so far
+  gdouble scroll;     //!< Where to scroll to once every result was appended, from 0.0 to 1.0, or negative
 };
 typedef struct _GwSearchData GwSearchData;
 
-GwSearchData* gw_searchdata_new (GtkTextView*, GwSearchWindow*);
+GwSearchData* gw_searchdata_new (GtkTextView*, GtkTreeView*, GwSearchWindow*);
 void gw_searchdata_free (GwSearchData*);
 
 void gw_searchdata_set_result (GwSearchData*, LwResult*);
@@ -21,6 +21,7 @@ void gw_searchwindow_search_cb (GtkWidget *widget, gpointer data);
 void gw_searchwindow_search_from_history_cb (GtkWidget*, gpointer);
 void gw_searchwindow_clear_search_cb (GSimpleAction*, GVariant*, gpointer);
 void gw_searchwindow_update_button_states_based_on_entry_text_cb (GtkEditable*, gpointer);
+void gw_searchwindow_complete_from_history_cb (GtkEditable*, gpointer);
 void gw_searchwindow_go_menuitem_action_cb (GtkWidget*, gpointer);
 void gw_searchwindow_close_kanji_results_cb (GtkWidget*, gpointer);
 void gw_searchwindow_dictionary_combobox_changed_cb (GtkWidget*, gpointer);
@@ -74,6 +75,7 @@ void gw_searchwindow_sync_tabbar_show_cb (GSettings*, gchar*, gpointer);
 void gw_searchwindow_sync_statusbar_show_cb (GSettings*, gchar*, gpointer);
 void gw_searchwindow_sync_font_cb (GSettings*, gchar*, gpointer);
 void gw_searchwindow_sync_search_as_you_type_cb (GSettings*, gchar*, gpointer);
+void gw_searchwindow_sync_history_cache_size_cb (GSettings*, gchar*, gpointer);
 void gw_searchwindow_sync_spellcheck_cb (GSettings*, gchar*, gpointer);
 
 gboolean gw_searchwindow_key_release_modify_status_update_cb (GtkWidget*, GdkEvent*, gpointer);
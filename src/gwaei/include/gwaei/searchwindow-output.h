@@ -1,8 +1,20 @@
 #ifndef GW_SEARCHWINDOW_OUTPUT_INCLUDED
 #define GW_SEARCHWINDOW_OUTPUT_INCLUDED
 
+typedef enum {
+  GW_RESULTLIST_COLUMN_RESULT,
+  GW_RESULTLIST_COLUMN_TYPE,
+  TOTAL_GW_RESULTLIST_COLUMNS
+} GwResultListColumn;
+
 void gw_searchwindow_append_result (GwSearchWindow*, LwSearch*);
-void gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow*, LwSearch*);
+gint gw_searchwindow_append_results (GwSearchWindow*, LwSearch*, gint);
+void gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow*, LwResult*);
 void gw_searchwindow_display_no_results_found_page (GwSearchWindow*, LwSearch*);
 
+GtkTreeView* gw_searchwindow_resultlist_new (void);
+void gw_searchwindow_resultlist_append (GtkTreeView*, LwResult*, GType);
+void gw_searchwindow_resultlist_clear (GtkTreeView*);
+gchar* gw_searchwindow_resultlist_get_text (GtkTreeView*);
+
 #endif
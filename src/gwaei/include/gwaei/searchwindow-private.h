@@ -15,6 +15,7 @@ typedef enum {
   GW_SEARCHWINDOW_SIGNALID_SPELLCHECK,
 #endif
   GW_SEARCHWINDOW_SIGNALID_KEEP_SEARCHING,
+  GW_SEARCHWINDOW_SIGNALID_HISTORY_CACHE_SIZE,
   GW_SEARCHWINDOW_SIGNALID_TABBAR_SHOW,
   GW_SEARCHWINDOW_SIGNALID_MENUBAR_SHOW,
   GW_SEARCHWINDOW_SIGNALID_TOOLBAR_SHOW,
@@ -71,7 +72,6 @@ struct _GwSearchWindowPrivate {
   LwSearchStatus feedback_status;
 
   //Mouse variables
-  LwSearch *mouse_item;
   gint mouse_button_press_x;
   gint mouse_button_press_y;
   gint mouse_button_press_root_x;
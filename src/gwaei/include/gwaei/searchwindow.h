@@ -24,6 +24,10 @@ typedef struct _GwSearchWindowPrivate GwSearchWindowPrivate;
 #define GW_SEARCHWINDOW_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS((obj), GW_TYPE_SEARCHWINDOW, GwSearchWindowClass))
 
 #define GW_SEARCHWINDOW_KEEP_SEARCHING_MAX_DELAY 3
+#define GW_SEARCHWINDOW_HISTORY_COMPLETIONS 10
+#define GW_SEARCHWINDOW_APPEND_BATCH_SIZE 500 //!< The most results inserted into the buffer per timeout
+#define GW_SEARCHWINDOW_TEXT_RESULTS_MAX 500 //!< Results past this many are only shown in the result list
+#define GW_SEARCHWINDOW_MAX_RESULTS 5000 //!< The most results a search keeps per relevance
 
 struct _GwSearchWindow {
   GwWindow window;
@@ -114,6 +118,13 @@ void gw_searchwindow_guarantee_first_tab (GwSearchWindow*);
 GtkTextView* gw_searchwindow_get_textview (GwSearchWindow*, int);
 GtkInfoBar* gw_searchwindow_get_infobar (GwSearchWindow*, int);
 GtkTextView* gw_searchwindow_get_current_textview (GwSearchWindow*);
+GtkTreeView* gw_searchwindow_get_resultlist (GwSearchWindow*, int);
+GtkTreeView* gw_searchwindow_get_current_resultlist (GwSearchWindow*);
+void gw_searchwindow_show_resultlist (GwSearchWindow*, GtkTreeView*, gboolean);
+gboolean gw_searchwindow_resultlist_is_shown (GtkTreeView*);
+GtkTreeView* gw_searchwindow_get_current_shown_resultlist (GwSearchWindow*);
+gdouble gw_searchwindow_get_scroll_by_index (GwSearchWindow*, gint);
+void gw_searchwindow_set_scroll_by_index (GwSearchWindow*, gint, gdouble);
 GtkInfoBar* gw_searchwindow_get_current_infobar (GwSearchWindow*);
 
 void gw_searchwindow_show_current_infobar (GwSearchWindow*, char*);
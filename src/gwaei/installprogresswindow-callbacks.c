@@ -56,25 +56,6 @@ gw_installprogresswindow_cancel_cb (GtkWidget *widget, gpointer data)
 }
 
 
-void 
-gw_installprogresswindow_update_dictionary_cb (LwDictionary *dictionary, gpointer data)
-{
-    //Declarations
-    GwInstallProgressWindow *window;
-    GwInstallProgressWindowPrivate *priv;
-    gdouble fraction;
-
-    //Initializations
-    window = GW_INSTALLPROGRESSWINDOW (data);
-    priv = window->priv;
-    fraction = lw_dictionary_installer_get_stage_progress (LW_DICTIONARY (dictionary));
-
-    g_mutex_lock (&priv->mutex); 
-    priv->install_fraction = fraction;
-    g_mutex_unlock (&priv->mutex);
-}
-
-
 static void
 gw_installprogresswindow_finish (GwInstallProgressWindow *window)
 {
@@ -112,6 +93,8 @@ gw_installprogresswindow_sync_progress (GwInstallProgressWindow *window)
     GwApplication *application;
     LwDictionaryList *dictionarylist;
     LwDictionary *dictionary;
+    LwDictionary *running;
+    LwDictionaryInstallerStatus status;
     GList *link;
     gint current_to_install;
     gint total_to_install;
@@ -127,31 +110,39 @@ gw_installprogresswindow_sync_progress (GwInstallProgressWindow *window)
     priv = window->priv;
     current_to_install = 0;
     total_to_install = 0;
+    running = NULL;
+    text_progressbar = NULL;
+    text_left = NULL;
+    text_left_markup = NULL;
+    text_installing = NULL;
+    text_installing_markup = NULL;
 
     g_mutex_lock (&priv->mutex);
 
-    //Calculate the number of dictionaries left to install
+    //Several dictionaries install at once, so count the finished ones and show the first running one
     for (link = lw_dictionarylist_get_list (dictionarylist); link != NULL; link = link->next)
     {
       dictionary = LW_DICTIONARY (link->data);
-      if (dictionary != NULL && lw_dictionary_is_selected (dictionary))
+      if (dictionary == NULL || !lw_dictionary_is_selected (dictionary)) continue;
+
+      total_to_install++;
+      status = lw_dictionary_installer_get_status (dictionary);
+      if (status == LW_DICTIONARY_INSTALLER_STATUS_INSTALLED)
       {
         current_to_install++;
       }
-      if (link->data == priv->dictionary) break;
-    }
-
-    //Calculate the number of dictionaries left to install
-    for (link = lw_dictionarylist_get_list (dictionarylist); link != NULL; link = link->next)
-    {
-      dictionary = LW_DICTIONARY (link->data);
-      if (lw_dictionary_is_selected (dictionary))
+      else if (status != LW_DICTIONARY_INSTALLER_STATUS_UNINSTALLED && running == NULL)
       {
-        total_to_install++;
+        running = dictionary;
       }
     }
+    if (current_to_install < total_to_install) current_to_install++;
+
+    //A NULL dictionary means the install thread finished
+    if (running != NULL && priv->dictionary != NULL) priv->dictionary = running;
     
     dictionary = priv->dictionary;
+    if (dictionary == NULL) goto errored;
 
     text_progressbar =  g_markup_printf_escaped (gettext("Installing %s..."), lw_dictionary_get_name (dictionary));
     if (text_progressbar == NULL) goto errored;
@@ -166,7 +157,7 @@ gw_installprogresswindow_sync_progress (GwInstallProgressWindow *window)
 
     gtk_label_set_markup (priv->label, text_left_markup);
     gtk_label_set_markup (priv->sublabel, text_installing_markup);
-    gtk_progress_bar_set_fraction (priv->progressbar, priv->install_fraction);
+    gtk_progress_bar_set_fraction (priv->progressbar, lw_dictionarylist_installer_get_total_progress (dictionarylist));
     gtk_progress_bar_set_text (priv->progressbar, text_progressbar);
 
 errored:
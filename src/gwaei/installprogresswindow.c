@@ -188,7 +188,6 @@ gw_installprogresswindow_install_thread (gpointer data)
     GList *link;
     LwDictionary *dictionary;
     GError *error;
-    gulong signalid;
     GCancellable *cancellable;
 
     //Initializations
@@ -199,26 +198,23 @@ gw_installprogresswindow_install_thread (gpointer data)
     dictionarylist = gw_application_get_installable_dictionarylist (application);
     cancellable = priv->cancellable;
     error = NULL;
-    link = lw_dictionarylist_get_list (LW_DICTIONARYLIST (dictionarylist));
 
-    //Do the installation
-    g_timeout_add (100, gw_installprogresswindow_update_ui_timeout, window);
-    while (link != NULL && error == NULL)
+    //Show the first selected dictionary until the progress timeout finds a running one
+    for (link = lw_dictionarylist_get_list (LW_DICTIONARYLIST (dictionarylist)); link != NULL; link = link->next)
     {
       dictionary = LW_DICTIONARY (link->data);
-      if (dictionary != NULL && lw_dictionary_is_selected (dictionary))
-      {
-        g_mutex_lock (&priv->mutex);
-        priv->dictionary = dictionary;
-        g_mutex_unlock (&priv->mutex);
-        signalid = g_signal_connect (dictionary, "progress-changed", G_CALLBACK (gw_installprogresswindow_update_dictionary_cb), window);
-        lw_dictionary_install (dictionary, cancellable, &error);
-        if (g_signal_handler_is_connected (dictionary, signalid))
-          g_signal_handler_disconnect (dictionary, signalid);
-      }
-
-      link = link->next;
+      if (dictionary != NULL && lw_dictionary_is_selected (dictionary)) break;
     }
+    if (link == NULL) dictionary = NULL;
+
+    g_mutex_lock (&priv->mutex);
+    priv->dictionary = dictionary;
+    g_mutex_unlock (&priv->mutex);
+
+    //Do the installation
+    g_timeout_add (100, gw_installprogresswindow_update_ui_timeout, window);
+    if (dictionary != NULL)
+      lw_dictionarylist_install (LW_DICTIONARYLIST (dictionarylist), GW_INSTALLPROGRESSWINDOW_INSTALL_JOBS, cancellable, &error);
 
     gw_application_set_error (application, error);
     error = NULL;
@@ -84,6 +84,7 @@ void gw_pageinfo_free (GwPageInfo *pi) {
 struct _GwPrintData {
   GList *pages;
   GwSearchWindow *window;
+  GtkTextBuffer *buffer;        //!< The text that is printed
 };
 typedef struct _GwPrintData GwPrintData;
 
@@ -91,6 +92,9 @@ typedef struct _GwPrintData GwPrintData;
 GwPrintData* gw_printdata_new (GwSearchWindow *window)
 {
     GwPrintData *temp;
+    GtkTreeView *list;
+    GtkTextView *view;
+    gchar *text;
 
     temp = (GwPrintData*) malloc(sizeof(GwPrintData));
 
@@ -98,6 +102,21 @@ GwPrintData* gw_printdata_new (GwSearchWindow *window)
     {
       temp->pages = NULL;
       temp->window = window;
+
+      //Once a search has too many results for the text view, only the result list has every one
+      list = gw_searchwindow_get_current_shown_resultlist (window);
+      if (list != NULL)
+      {
+        text = gw_searchwindow_resultlist_get_text (list);
+        temp->buffer = gtk_text_buffer_new (NULL);
+        gtk_text_buffer_set_text (temp->buffer, text, -1);
+        g_free (text); text = NULL;
+      }
+      else
+      {
+        view = gw_searchwindow_get_current_textview (window);
+        temp->buffer = g_object_ref (gtk_text_view_get_buffer (view));
+      }
     }
     
     return temp;
@@ -117,6 +136,7 @@ void gw_printdata_free (GwPrintData *data)
 
     }
     g_list_free (data->pages);
+    if (data->buffer != NULL) g_object_unref (data->buffer); data->buffer = NULL;
     
     free (data);
 }
@@ -210,7 +230,6 @@ static void _draw_page_number (GtkPrintContext *context, gint page_nr, GwPageInf
 static void _draw_page_results (GtkPrintContext *context, GwPageInfo *page, GwPrintData *data)
 {
     //Declarations
-    GtkTextView *view;
     GtkTextBuffer *buffer;
     PangoLayout *layout;
     char *text;
@@ -223,8 +242,7 @@ static void _draw_page_results (GtkPrintContext *context, GwPageInfo *page, GwPr
     gint line_end;
 
     //Initializations
-    view = gw_searchwindow_get_current_textview (data->window);
-    buffer = gtk_text_view_get_buffer (view);
+    buffer = data->buffer;
     text = gtk_text_buffer_get_text (buffer, &(page->start), &(page->end), FALSE);
     layout = gtk_print_context_create_pango_layout (context);
     desc = pango_font_description_from_string ("sans 10");
@@ -280,12 +298,10 @@ static gboolean _paginate (GtkPrintOperation *operation,
     GList *iter;
     GtkTextIter end_bound;
     GtkTextIter start_bound;
-    GtkTextView *view;
     GtkTextBuffer *buffer;
 
     //Initializations
-    view = gw_searchwindow_get_current_textview (data->window);
-    buffer = gtk_text_view_get_buffer (view);
+    buffer = data->buffer;
 
     //Get the draw bounds
     if (gtk_text_buffer_get_has_selection (buffer))
@@ -39,7 +39,7 @@
 
 
 GwSearchData* 
-gw_searchdata_new (GtkTextView *view, GwSearchWindow *window)
+gw_searchdata_new (GtkTextView *view, GtkTreeView *list, GwSearchWindow *window)
 {
     GwSearchData *temp;
     temp = (GwSearchData*) malloc(sizeof(GwSearchData));
@@ -47,7 +47,10 @@ gw_searchdata_new (GtkTextView *view, GwSearchWindow *window)
     {
       temp->window = window;
       temp->view = view;
+      temp->list = list;
       temp->result = NULL;
+      temp->appended = 0;
+      temp->scroll = -1.0;
     }
     return temp;
 }
@@ -62,6 +65,7 @@ gw_searchdata_free (GwSearchData *data)
 
     data->window = NULL;
     data->view = NULL;
+    data->list = NULL;
     data->result = NULL;
 
     free (data);
@@ -235,33 +235,21 @@ gw_searchwindow_get_iter_for_button_release_cb (GtkWidget      *widget,
     // Characters above 0xFF00 represent inserted images
     if (character && dictionary != NULL)
     {
-      //Convert the unicode character into to a utf8 string
-      gchar query[7];
-      gint length = g_unichar_to_utf8 (character, query);
-      query[length] = '\0'; 
-      LwSearch *search;
-      GError *error;
-
-      //Start the search
-      if (priv->mouse_item != NULL)
-      {
-        lw_search_cancel (priv->mouse_item);
-        lw_search_free (priv->mouse_item);
-        priv->mouse_item = NULL;
-      }
+      LwResult *result;
+
       priv->mouse_button_press_x = event->x;
       priv->mouse_button_press_y = event->y;
       priv->mouse_button_press_root_x = event->x_root; //x position of the tooltip
       priv->mouse_button_press_root_y = event->y_root; //y position of the tooltip
       priv->mouse_button_character = character;
-      error = NULL;
-      search = lw_search_new (dictionary, query, 0, &error);
-      if (search != NULL && error == NULL)
+
+      //Look the kanji up directly instead of starting a search for it
+      result = lw_kanjidictionary_lookup (dictionary, character);
+      if (result != NULL)
       {
-        lw_search_start (search, TRUE);
-        priv->mouse_item = search;
+        gw_searchwindow_append_kanjidict_tooltip_result (window, result);
+        lw_result_free (result); result = NULL;
       }
-      gw_application_handle_error (application, NULL, FALSE, &error);
     }
     else if (vocabulary_data)
     {
@@ -1057,7 +1045,7 @@ gw_searchwindow_search_cb (GtkWidget *widget, gpointer data)
     if (!gw_application_can_start_search (application)) return;
 
     preferences = gw_application_get_preferences (application);
-    flags = lw_search_get_flags_from_preferences (preferences);
+    flags = lw_search_get_flags_from_preferences (preferences) | LW_SEARCH_FLAG_SPANS;
     strncpy (query, gtk_entry_get_text (priv->entry), 50);
     index = gw_searchwindow_get_current_tab_index (window);
     search = gw_searchwindow_get_searchitem_by_index (window, index);
@@ -1078,7 +1066,7 @@ gw_searchwindow_search_cb (GtkWidget *widget, gpointer data)
       gw_application_handle_error (application, NULL, FALSE, &error);
       return;
     }
-    sdata = gw_searchdata_new (view, window);
+    sdata = gw_searchdata_new (view, gw_searchwindow_get_current_resultlist (window), window);
     lw_search_set_data (new_item, sdata, LW_SEARCH_DATA_FREE_FUNC (gw_searchdata_free));
 
     //Check for problems, and quit if there are
@@ -1114,7 +1102,7 @@ gw_searchwindow_search_cb (GtkWidget *widget, gpointer data)
       search = gw_searchwindow_steal_searchitem_by_index (window, index);
       if (search != NULL) 
       {
-        lw_history_add_search (history, search);
+        lw_history_add_search (history, search, gw_searchwindow_get_scroll_by_index (window, index));
       }
     }
 
@@ -1410,6 +1398,51 @@ gw_searchwindow_update_button_states_based_on_entry_text_cb (GtkEditable *editab
 }
 
 
+//!
+//! @brief Fills the completions of the search entry with past queries that
+//!        start with its text
+//! @param editable The search entry
+//! @param data A pointer to the GwSearchWindow
+//!
+G_MODULE_EXPORT void
+gw_searchwindow_complete_from_history_cb (GtkEditable *editable,
+                                          gpointer     data   )
+{
+    //Declarations
+    GwSearchWindow *window;
+    GwApplication *application;
+    LwHistoryLog *log;
+    GtkEntryCompletion *completion;
+    GtkListStore *store;
+    GtkTreeIter iter;
+    const gchar *TEXT;
+    gchar **querylist;
+    gint i;
+
+    //Initializations
+    window = GW_SEARCHWINDOW (data);
+    application = gw_window_get_application (GW_WINDOW (window));
+    log = gw_application_get_historylog (application);
+    completion = gtk_entry_get_completion (GTK_ENTRY (editable));
+    if (log == NULL || completion == NULL) return;
+    store = GTK_LIST_STORE (gtk_entry_completion_get_model (completion));
+    TEXT = gtk_entry_get_text (GTK_ENTRY (editable));
+
+    gtk_list_store_clear (store);
+    if (TEXT == NULL || *TEXT == '\0') return;
+
+    querylist = lw_historylog_complete (log, TEXT, GW_SEARCHWINDOW_HISTORY_COMPLETIONS);
+    for (i = 0; querylist != NULL && querylist[i] != NULL; i++)
+    {
+      gtk_list_store_append (store, &iter);
+      gtk_list_store_set (store, &iter, 0, querylist[i], -1);
+    }
+
+    //Cleanup
+    g_strfreev (querylist); querylist = NULL;
+}
+
+
 //!
 //! @brief Emulates web browsers font size control with (ctrl + wheel)
 //! @param widget Unused GtkWidget pointer.
@@ -1893,6 +1926,30 @@ gw_searchwindow_sync_search_as_you_type_cb (GSettings *settings,
 }
 
 
+//!
+//! @brief Sets how many megabytes of search results the history keeps
+//!
+G_MODULE_EXPORT void 
+gw_searchwindow_sync_history_cache_size_cb (GSettings *settings, 
+                                            gchar     *KEY, 
+                                            gpointer   data     )
+{
+    //Declarations
+    GwSearchWindow *window;
+    GwSearchWindowPrivate *priv;
+    gint megabytes;
+
+    //Initializations
+    window = GW_SEARCHWINDOW (data);
+    g_return_if_fail (window != NULL);
+    priv = window->priv;
+    megabytes = lw_preferences_get_int (settings, KEY);
+    if (megabytes < 0) megabytes = 0;
+
+    if (priv->history != NULL) g_object_set (priv->history, "result-cache-size", (guint) megabytes * 1024 * 1024, NULL);
+}
+
+
 static void
 gw_searchwindow_kanjipadwindow_kanji_selected_cb (GwKanjipadWindow *window, const gchar *text, gpointer data)
 {
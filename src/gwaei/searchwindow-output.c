@@ -39,502 +39,530 @@
 #include <gwaei/gwaei.h>
 #include <gwaei/searchwindow-private.h>
 
-static void gw_searchwindow_append_edict_result (GwSearchWindow*, LwSearch*);
-static void gw_searchwindow_append_kanjidict_result (GwSearchWindow*, LwSearch*);
-static void gw_searchwindow_append_examplesdict_result (GwSearchWindow*, LwSearch*);
-static void gw_searchwindow_append_unknowndict_result (GwSearchWindow*, LwSearch*);
+//!
+//! Results are appended in batches.  The text and tag runs of every result in
+//! a batch are built up in memory first, then inserted into the GtkTextBuffer
+//! with a single insertion and the tags applied by offset, so the view only
+//! has to lay out the new text once per batch instead of once per field.
+//! Matches are tagged from the spans the search recorded in each LwResult.
+//!
+struct _GwOutputRun {
+  GtkTextTag *tag;
+  gint start;                   //!< Character offset of the start of the run in the batch
+  gint end;                     //!< Character offset of the end of the run in the batch
+};
+typedef struct _GwOutputRun GwOutputRun;
+
+struct _GwOutputBatch {
+  GwSearchWindow *window;
+  LwSearch *search;
+  GtkTextBuffer *buffer;
+  GtkTextTagTable *tagtable;
+  GString *text;
+  gint length;                  //!< Characters in text
+  GArray *runs;                 //!< A GArray of GwOutputRun to apply once the text is inserted
+  GList *results;               //!< The LwResult of every result in the batch, last first
+  GType type;                   //!< The type of the dictionary the results are from
+  GQuark quark;                 //!< The detail word-added is emitted with
+  const gchar *mark_name;       //!< The name of the mark the text is inserted at
+  gint headline_end;            //!< Character offset of the end of the last edict headline in the batch or -1
+};
+typedef struct _GwOutputBatch GwOutputBatch;
+
+static void gw_searchwindow_append_edict_result (GwOutputBatch*, LwResult*);
+static void gw_searchwindow_append_edict_alternate (GwOutputBatch*, LwResult*);
+static void gw_searchwindow_append_kanjidict_result (GwOutputBatch*, LwResult*);
+static void gw_searchwindow_append_examplesdict_result (GwOutputBatch*, LwResult*);
+static void gw_searchwindow_append_unknowndict_result (GwOutputBatch*, LwResult*);
+
 
 static void
-gw_searchwindow_insert_addlink (GwSearchWindow   *window,
-                                GtkTextBuffer    *buffer,
-                                GtkTextIter      *iter,
-                                LwWord     *word   )
+gw_outputbatch_init (GwOutputBatch *batch, GwSearchWindow *window, LwSearch *search, GtkTextBuffer *buffer)
 {
-    //Sanity checks
-    g_return_if_fail (window != NULL);
-    g_return_if_fail (buffer != NULL);
-    g_return_if_fail (word != NULL);
+    memset(batch, 0, sizeof(GwOutputBatch));
+
+    batch->window = window;
+    batch->search = search;
+    batch->buffer = buffer;
+    batch->tagtable = gtk_text_buffer_get_tag_table (buffer);
+    batch->text = g_string_sized_new (4096);
+    batch->runs = g_array_new (FALSE, FALSE, sizeof(GwOutputRun));
+    batch->mark_name = "content_insertion_mark";
+    batch->headline_end = -1;
+}
 
-    //Declarations
-    GtkTextTag *tag;
-    gchar *data;
-    
-    //Initializations
-    tag = gtk_text_buffer_create_tag (buffer, NULL, 
-        "rise",   5000, 
-        "scale",  0.75, 
-        "weight", PANGO_WEIGHT_BOLD,
-        NULL);
-    data = lw_word_to_string (word);
-    g_object_set_data_full (G_OBJECT (tag), "word-data", data, g_free);
-    g_object_set_data (G_OBJECT (tag), "buffer", (gpointer) buffer);
 
-    gtk_text_buffer_insert (buffer, iter, " ", -1);
-    gtk_text_buffer_insert_with_tags (buffer, iter, "+", -1, tag, NULL);
-    gtk_text_buffer_insert (buffer, iter, " ", -1 );
+static void
+gw_outputbatch_clear (GwOutputBatch *batch)
+{
+    if (batch->text != NULL) g_string_free (batch->text, TRUE); batch->text = NULL;
+    if (batch->runs != NULL) g_array_free (batch->runs, TRUE); batch->runs = NULL;
+    if (batch->results != NULL) g_list_free_full (batch->results, (GDestroyNotify) lw_result_free); batch->results = NULL;
 }
 
 
-void
-gw_searchwindow_insert_edict_addlink (GwSearchWindow *window, 
-                                      LwResult       *result, 
-                                      GtkTextBuffer  *buffer, 
-                                      GtkTextIter    *iter)
+static void
+gw_outputbatch_add_run (GwOutputBatch *batch, GtkTextTag *tag, gint start, gint end)
 {
     //Declarations
-    gchar *kanji, *furigana, *definitions;
-    LwWord *word;
+    GwOutputRun run;
 
-    //Initializations
-    kanji = result->kanji_start;
-    furigana = result->furigana_start;
-    if (furigana == NULL || strlen (furigana) == 0)
-      furigana = kanji;
-    definitions = g_strjoinv ("/", result->def_start);
-
-    if (definitions != NULL)
-    {
-      word = lw_word_new ();
-      if (word != NULL)
-      {
-        lw_word_set_kanji (word, kanji);
-        lw_word_set_furigana (word, furigana);
-        lw_word_set_definitions (word, definitions);
+    if (tag == NULL || start >= end) return;
 
-        gw_searchwindow_insert_addlink (window, buffer, iter, word);
+    run.tag = tag;
+    run.start = start;
+    run.end = end;
 
-        lw_word_free (word);
-      }
-      g_free (definitions);
-    }
+    g_array_append_val (batch->runs, run);
 }
 
+
 //!
-//! @brief Appends a result to the output
-//! @param engine The LwEngine to use for output
-//! @param search The data from the LwSearch
+//! @brief Appends text to the batch, tagged with tag if it isn't NULL
 //!
-void 
-gw_searchwindow_append_result (GwSearchWindow *window, LwSearch* search)
+static void
+gw_outputbatch_append_with_tag (GwOutputBatch *batch, const gchar *TEXT, GtkTextTag *tag)
 {
-    //Sanity checks
-    g_return_if_fail (window != NULL);
-    g_return_if_fail (search != NULL);
+    //Declarations
+    gint start;
+
+    if (TEXT == NULL) return;
+
+    start = batch->length;
+    g_string_append (batch->text, TEXT);
+    batch->length += g_utf8_strlen (TEXT, -1);
+
+    gw_outputbatch_add_run (batch, tag, start, batch->length);
+}
 
+
+//!
+//! @brief Appends text to the batch, tagged with the named tag if it isn't NULL
+//!
+static void
+gw_outputbatch_append (GwOutputBatch *batch, const gchar *TEXT, const gchar *TAG_NAME)
+{
     //Declarations
-    GType type;
+    GtkTextTag *tag;
 
     //Initializations
-    type = G_OBJECT_TYPE (search->dictionary);
+    tag = (TAG_NAME != NULL) ? gtk_text_tag_table_lookup (batch->tagtable, TAG_NAME) : NULL;
 
-    if (g_type_is_a (type, LW_TYPE_EDICTIONARY))
-      gw_searchwindow_append_edict_result (window, search);
-    else if (g_type_is_a (type, LW_TYPE_KANJIDICTIONARY))
-        gw_searchwindow_append_kanjidict_result (window, search);
-    else if (g_type_is_a (type, LW_TYPE_EXAMPLEDICTIONARY))
-      gw_searchwindow_append_examplesdict_result (window, search);
-    else if (g_type_is_a (type, LW_TYPE_UNKNOWNDICTIONARY))
-      gw_searchwindow_append_unknowndict_result (window, search);
-    else
-      g_warning ("%s\n", gettext("This is an unknown dictionary type!"));
+    gw_outputbatch_append_with_tag (batch, TEXT, tag);
 }
 
 
 //!
-//! @brief PRIVATE FUNCTION. Applies a tag to a section of text
+//! @brief Appends a field of a result to the batch, tagging where the search
+//!        found the query in it
 //!
-//! @param line An integer showing the line in the buffer to tag
-//! @param start_offset the ending character in the line to highlight
-//! @param end_offset The ending character in the line to highlight
-//! @param search A LwSearch to get general information from
+//! @param batch The GwOutputBatch being built
+//! @param result The LwResult the field belongs to
+//! @param FIELD The field of the result to append
+//! @param TAG_NAME The name of a tag for the whole field or NULL
 //!
-static void 
-gw_add_match_highlights (gint line, gint start_offset, gint end_offset, LwSearch* search)
+static void
+gw_outputbatch_append_field (GwOutputBatch *batch, LwResult *result, const gchar *FIELD, const gchar *TAG_NAME)
 {
-    //Sanity check
-    g_assert (lw_search_has_data (search));
+    //Declarations
+    GtkTextTag *tag;
+    gint offset;
+    gint index;
+    gint start;
+    gint end;
+
+    if (FIELD == NULL) return;
+
+    //Initializations
+    tag = gtk_text_tag_table_lookup (batch->tagtable, "match");
+    offset = batch->length;
+    index = 0;
+
+    gw_outputbatch_append (batch, FIELD, TAG_NAME);
 
+    while (lw_result_next_span (result, FIELD, &index, &start, &end))
+    {
+      gw_outputbatch_add_run (batch, tag,
+        offset + g_utf8_pointer_to_offset (FIELD, FIELD + start),
+        offset + g_utf8_pointer_to_offset (FIELD, FIELD + end)
+      );
+    }
+}
+
+
+//!
+//! @brief Inserts the text of the batch at its mark with one insertion and
+//!        applies its tags.  The "previous_result" mark is moved to the end of
+//!        the last edict headline so later entries with the same definitions
+//!        can add their headword to it.
+//!
+static void
+gw_outputbatch_flush (GwOutputBatch *batch)
+{
     //Declarations
+    GwSearchWindowClass *klass;
     GwSearchData *sdata;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    LwQuery *query;
-    gint match_start_byte_offset;
-    gint match_end_byte_offset;
-    gint match_character_offset;
+    GtkTextMark *mark;
+    GtkTextIter iter;
     GtkTextIter start_iter;
     GtkTextIter end_iter;
-    gchar *text;
-    GRegex *regex;
+    GwOutputRun *run;
     GList *link;
-    GMatchInfo *match_info;
+    gint offset;
+    gint i;
 
     //Initializations
-    sdata = GW_SEARCHDATA (lw_search_get_data (search));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
-    query = search->query;
-    gtk_text_buffer_get_iter_at_line_offset (buffer, &start_iter, line, start_offset);
-    gtk_text_buffer_get_iter_at_line_offset (buffer, &end_iter, line, end_offset);
-    text = gtk_text_buffer_get_slice (buffer, &start_iter, &end_iter, FALSE);
-
-    //Look for kanji atoms
-    link = lw_query_regexgroup_get (query, LW_QUERY_TYPE_KANJI, LW_RELEVANCE_LOW);
-    while (link != NULL)
-    {
-      regex = link->data;
-      if (regex != NULL && g_regex_match (regex, text, 0, &match_info))
-      { 
-        while (g_match_info_matches (match_info))
-        {
-          g_match_info_fetch_pos (match_info, 0, &match_start_byte_offset, &match_end_byte_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_start_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &start_iter, line, match_character_offset + start_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_end_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &end_iter, line, match_character_offset + start_offset);
-          gtk_text_buffer_apply_tag_by_name (buffer, "match", &start_iter, &end_iter);
-          g_match_info_next (match_info, NULL);
-        }
-        g_match_info_free (match_info); match_info = NULL;
-      }
-      link = link->next;
-    }
+    klass = GW_SEARCHWINDOW_CLASS (G_OBJECT_GET_CLASS (batch->window));
+    sdata = GW_SEARCHDATA (lw_search_get_data (batch->search));
 
-    //Look for furigana atoms
-    link = lw_query_regexgroup_get (query, LW_QUERY_TYPE_FURIGANA, LW_RELEVANCE_LOW);
-    while (link != NULL)
+    if (batch->text->len > 0)
     {
-      regex = link->data;
-      if (regex != NULL && g_regex_match (regex, text, 0, &match_info))
-      { 
-        while (g_match_info_matches (match_info))
-        {
-          g_match_info_fetch_pos (match_info, 0, &match_start_byte_offset, &match_end_byte_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_start_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &start_iter, line, match_character_offset + start_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_end_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &end_iter, line, match_character_offset + start_offset);
-          gtk_text_buffer_apply_tag_by_name (buffer, "match", &start_iter, &end_iter);
-          g_match_info_next (match_info, NULL);
-        }
-        g_match_info_free (match_info); match_info = NULL;
+      mark = gtk_text_buffer_get_mark (batch->buffer, batch->mark_name);
+      gtk_text_buffer_get_iter_at_mark (batch->buffer, &iter, mark);
+      offset = gtk_text_iter_get_offset (&iter);
+
+      gtk_text_buffer_insert (batch->buffer, &iter, batch->text->str, batch->text->len);
+
+      for (i = 0; i < batch->runs->len; i++)
+      {
+        run = &g_array_index (batch->runs, GwOutputRun, i);
+        gtk_text_buffer_get_iter_at_offset (batch->buffer, &start_iter, offset + run->start);
+        gtk_text_buffer_get_iter_at_offset (batch->buffer, &end_iter, offset + run->end);
+        gtk_text_buffer_apply_tag (batch->buffer, run->tag, &start_iter, &end_iter);
       }
-      link = link->next;
-    }
 
-    //Look for romaji atoms
-    link = lw_query_regexgroup_get (query, LW_QUERY_TYPE_ROMAJI, LW_RELEVANCE_LOW);
-    while (link != NULL)
-    {
-      regex = link->data;
-      if (regex != NULL && g_regex_match (regex, text, 0, &match_info))
+      if (batch->headline_end >= 0)
       {
-        while (g_match_info_matches (match_info))
-        {
-          g_match_info_fetch_pos (match_info, 0, &match_start_byte_offset, &match_end_byte_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_start_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &start_iter, line, match_character_offset + start_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_end_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &end_iter, line, match_character_offset + start_offset);
-          gtk_text_buffer_apply_tag_by_name (buffer, "match", &start_iter, &end_iter);
-          g_match_info_next (match_info, NULL);
-        }
-        g_match_info_free (match_info); match_info = NULL;
+        gtk_text_buffer_get_iter_at_offset (batch->buffer, &iter, offset + batch->headline_end);
+        mark = gtk_text_buffer_get_mark (batch->buffer, "previous_result");
+        if (mark == NULL)
+          gtk_text_buffer_create_mark (batch->buffer, "previous_result", &iter, FALSE);
+        else
+          gtk_text_buffer_move_mark (batch->buffer, mark, &iter);
       }
-      link = link->next;
     }
 
-    //Look for mix atoms
-    link = lw_query_regexgroup_get (query, LW_QUERY_TYPE_MIX, LW_RELEVANCE_LOW);
-    while (link != NULL)
+    //The result list of the tab keeps every result, otherwise the search data keeps the last one
+    batch->results = g_list_reverse (batch->results);
+    for (link = batch->results; link != NULL; link = link->next)
     {
-      regex = link->data;
-      if (regex != NULL && g_regex_match (regex, text, 0, &match_info))
-      {
-        while (g_match_info_matches (match_info))
-        {
-          g_match_info_fetch_pos (match_info, 0, &match_start_byte_offset, &match_end_byte_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_start_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &start_iter, line, match_character_offset + start_offset);
-          match_character_offset = g_utf8_pointer_to_offset (text, text + match_end_byte_offset);
-          gtk_text_buffer_get_iter_at_line_offset (buffer, &end_iter, line, match_character_offset + start_offset);
-          gtk_text_buffer_apply_tag_by_name (buffer, "match", &start_iter, &end_iter);
-          g_match_info_next (match_info, NULL);
-        }
-        g_match_info_free (match_info); match_info = NULL;
-      }
-      link = link->next;
+      g_signal_emit (batch->window, 
+        klass->signalid[GW_SEARCHWINDOW_CLASS_SIGNALID_WORD_ADDED], 
+        batch->quark, 
+        link->data
+      );
+      if (sdata->list != NULL)
+        gw_searchwindow_resultlist_append (sdata->list, LW_RESULT (link->data), batch->type);
+      else
+        gw_searchdata_set_result (sdata, LW_RESULT (link->data));
     }
+    g_list_free (batch->results); batch->results = NULL;
 
-    //Cleanup
-    g_free (text); text = NULL;
+    g_string_truncate (batch->text, 0);
+    g_array_set_size (batch->runs, 0);
+    batch->length = 0;
+    batch->headline_end = -1;
 }
 
 
-//!
-//! @brief PRIVATE FUNCTION. Moves the content insertion mark to another mark's spot
-//!
-//! @param search A LwSearch pointer to gleam information from
-//! @param name The name of the mark to move the content insertion mark to
-//!
-static void 
-gw_shift_stay_mark (LwSearch *search, char *name)
+static void
+gw_searchwindow_insert_addlink (GwOutputBatch *batch, LwWord *word)
 {
-    //Sanity check
-    g_assert (lw_search_has_data (search));
+    //Sanity checks
+    g_return_if_fail (batch != NULL);
+    g_return_if_fail (word != NULL);
 
     //Declarations
-    GwSearchData *sdata;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    GtkTextMark *mark;
-    GtkTextIter iter;
-
+    GtkTextTag *tag;
+    gchar *data;
+    
     //Initializations
-    sdata = GW_SEARCHDATA (lw_search_get_data (search));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
-    mark = gtk_text_buffer_get_mark (buffer, "content_insertion_mark");
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
+    tag = gtk_text_buffer_create_tag (batch->buffer, NULL, 
+        "rise",   5000, 
+        "scale",  0.75, 
+        "weight", PANGO_WEIGHT_BOLD,
+        NULL);
+    data = lw_word_to_string (word);
+    g_object_set_data_full (G_OBJECT (tag), "word-data", data, g_free);
+    g_object_set_data (G_OBJECT (tag), "buffer", (gpointer) batch->buffer);
 
-    if ((mark = gtk_text_buffer_get_mark (buffer, name)) == NULL)
-      gtk_text_buffer_create_mark (buffer, name, &iter, TRUE);
-    else
-      gtk_text_buffer_move_mark (buffer, mark, &iter);
+    gw_outputbatch_append (batch, " ", NULL);
+    gw_outputbatch_append_with_tag (batch, "+", tag);
+    gw_outputbatch_append (batch, " ", NULL);
 }
 
 
-//!
-//! @brief PRIVATE FUNCTION.  Updates the position of a mark to accomidate new results.
-//!
-//! @param search A LwSearch to gleam information from.
-//! @param stay_name The name of the mark that stays in place before the new result.
-//! @param append_name The name of the mark that moves to the end after the new result is added.
-//!
-static void 
-gw_searchwindow_shift_append_mark (GwSearchWindow *window, LwSearch *search, char *stay_name, char *append_name)
+static void
+gw_searchwindow_insert_edict_addlink (GwOutputBatch *batch, LwResult *result)
 {
-    //Sanity check
-    g_assert (lw_search_has_data (search));
-
     //Declarations
-    GwSearchData *sdata;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    GtkTextIter iter;
-    GtkTextMark *stay_mark, *append_mark;
+    gchar *kanji, *furigana, *definitions;
+    LwWord *word;
 
     //Initializations
-    sdata = GW_SEARCHDATA (lw_search_get_data (search));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
-    stay_mark = gtk_text_buffer_get_mark (buffer, stay_name);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, stay_mark);
+    kanji = result->kanji_start;
+    furigana = result->furigana_start;
+    if (furigana == NULL || strlen (furigana) == 0)
+      furigana = kanji;
+    definitions = g_strjoinv ("/", result->def_start);
 
-    if ((append_mark = gtk_text_buffer_get_mark (buffer, append_name)) == NULL)
-      gtk_text_buffer_create_mark (buffer, append_name, &iter, FALSE);
-    else
-      gtk_text_buffer_move_mark (buffer, append_mark, &iter);
+    if (definitions != NULL)
+    {
+      word = lw_word_new ();
+      if (word != NULL)
+      {
+        lw_word_set_kanji (word, kanji);
+        lw_word_set_furigana (word, furigana);
+        lw_word_set_definitions (word, definitions);
+
+        gw_searchwindow_insert_addlink (batch, word);
+
+        lw_word_free (word);
+      }
+      g_free (definitions);
+    }
 }
 
 
 //!
-//! @brief PRIVATE FUNCTION.  When adding a result to the buffer, it just adds the the kanji/hiragana section
+//! @brief Gets the result that was appended last to the output of a search
 //!
-//! This function is made to help readability of edict results since there is a lot of repeating.
+static LwResult*
+gw_searchwindow_get_last_result (GwSearchData *sdata)
+{
+    //Declarations
+    GPtrArray *results;
+
+    if (sdata->list == NULL) return gw_searchdata_get_result (sdata);
+
+    results = g_object_get_data (G_OBJECT (gtk_tree_view_get_model (sdata->list)), "results");
+    if (results == NULL || results->len == 0) return NULL;
+
+    return g_ptr_array_index (results, results->len - 1);
+}
+
+
 //!
-//! @param search A LwSearch pointer to use for sdata.
+//! @brief Appends the results a search has ready to the output
+//! @param window The GwSearchWindow to output to
+//! @param search The LwSearch to take the results of
+//! @param max The most results to append at once
+//! @return The number of results appended
 //!
-static void 
-gw_searchwindow_append_def_same_to_buffer (GwSearchWindow *window, LwSearch* search, LwResult *result)
+gint
+gw_searchwindow_append_results (GwSearchWindow *window, LwSearch* search, gint max)
 {
-    //Sanity check
-    g_assert (lw_search_has_data (search));
+    //Sanity checks
+    g_return_val_if_fail (window != NULL, 0);
+    g_return_val_if_fail (search != NULL, 0);
+    g_return_val_if_fail (lw_search_has_data (search), 0);
 
     //Declarations
-    GwSearchWindowClass *klass;
     GwSearchData *sdata;
-    GtkTextView *view;
     GtkTextBuffer *buffer;
-    GtkTextMark *mark;
+    GwOutputBatch batch;
+    LwResult *result;
+    LwResult *previous;
+    GType type;
+    gint appended;
 
     //Initializations
-    klass = GW_SEARCHWINDOW_CLASS (G_OBJECT_GET_CLASS (window));
     sdata = GW_SEARCHDATA (lw_search_get_data (search));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
+    if (sdata->view == NULL) return 0;
+    buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (sdata->view));
+    type = G_OBJECT_TYPE (search->dictionary);
+    appended = 0;
+
+    gw_outputbatch_init (&batch, window, search, buffer);
+    batch.type = type;
 
-    gw_searchwindow_shift_append_mark (window, search, "previous_result", "new_result");
-    if ((mark = gtk_text_buffer_get_mark (buffer, "previous_result")) != NULL)
+    if (g_type_is_a (type, LW_TYPE_EDICTIONARY))
+      batch.quark = g_quark_from_static_string ("edict");
+    else if (g_type_is_a (type, LW_TYPE_KANJIDICTIONARY))
+      batch.quark = g_quark_from_static_string ("kanjidict");
+    else if (g_type_is_a (type, LW_TYPE_EXAMPLEDICTIONARY))
+      batch.quark = g_quark_from_static_string ("examplesdict");
+    else
+      batch.quark = g_quark_from_static_string ("unknowndict");
+
+    previous = gw_searchwindow_get_last_result (sdata);
+
+    while (appended < max && lw_search_has_results (search) && (result = lw_search_get_result (search)) != NULL)
     {
-      GtkTextIter iter;
-      gint line, start_offset, end_offset;
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
-      line = gtk_text_iter_get_line (&iter);
-      start_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, " /", -1, "entry-header", NULL);
-      gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      //Kanji
-      if (result->kanji_start != NULL)
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->kanji_start, -1, "entry-header", NULL);
-      //Furigana
-      if (result->furigana_start != NULL)
+      //Past the first results, they are only added to the result list, which lays out just the rows on screen
+      if (sdata->list == NULL || sdata->appended < GW_SEARCHWINDOW_TEXT_RESULTS_MAX)
       {
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, "【", -1, "entry-header", NULL);
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->furigana_start, -1, "entry-header", NULL);
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, "】", -1, "entry-header", NULL);
-      }
-      //Other info
-      if (result->classification_start != NULL)
-      {
-        gtk_text_buffer_insert (buffer, &iter, " ", -1);
-        GtkTextIter copy = iter;
-        gtk_text_iter_backward_char (&copy);
-        gtk_text_buffer_remove_tag_by_name (buffer, "entry-header", &copy, &iter);
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->classification_start, -1, "entry-lexicon", NULL);
-      }
-      if (result->important == TRUE)
-      {
-        gtk_text_buffer_insert                   (buffer, &iter, " ", -1);
-        gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Pop"), -1, "entry-popular", NULL);
+        if (g_type_is_a (type, LW_TYPE_EDICTIONARY) && lw_result_is_similar (previous, result) && gtk_text_buffer_get_mark (buffer, "previous_result") != NULL)
+        {
+          //An entry with the same definitions as the one before only adds its headword to that one
+          gw_outputbatch_flush (&batch);
+          batch.mark_name = "previous_result";
+          gw_searchwindow_append_edict_alternate (&batch, result);
+          batch.results = g_list_prepend (batch.results, result);
+          gw_outputbatch_flush (&batch);
+          batch.mark_name = "content_insertion_mark";
+          previous = result;
+          sdata->appended++;
+          appended++;
+          continue;
+        }
+        else if (g_type_is_a (type, LW_TYPE_EDICTIONARY))
+          gw_searchwindow_append_edict_result (&batch, result);
+        else if (g_type_is_a (type, LW_TYPE_KANJIDICTIONARY))
+          gw_searchwindow_append_kanjidict_result (&batch, result);
+        else if (g_type_is_a (type, LW_TYPE_EXAMPLEDICTIONARY))
+          gw_searchwindow_append_examplesdict_result (&batch, result);
+        else if (g_type_is_a (type, LW_TYPE_UNKNOWNDICTIONARY))
+          gw_searchwindow_append_unknowndict_result (&batch, result);
+        else
+          g_warning ("%s\n", gettext("This is an unknown dictionary type!"));
       }
-      end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, search);
 
-      gw_searchwindow_insert_edict_addlink (window, result, buffer, &iter);
+      batch.results = g_list_prepend (batch.results, result);
+      previous = result;
+      sdata->appended++;
+      appended++;
     }
 
-    g_signal_emit (window, 
-      klass->signalid[GW_SEARCHWINDOW_CLASS_SIGNALID_WORD_ADDED], 
-      g_quark_from_static_string ("edict"), 
-      result
-    );
-}
+    gw_outputbatch_flush (&batch);
 
+    if (sdata->list != NULL && sdata->appended > GW_SEARCHWINDOW_TEXT_RESULTS_MAX)
+      gw_searchwindow_show_resultlist (window, sdata->list, TRUE);
 
-gboolean lw_search_next_is_same (LwSearch *search, LwResult *current)
-{
-  //Declarations
-  GwSearchData *sdata;
-  LwResult *previous;
-
-  //Initializations
-  sdata = GW_SEARCHDATA (lw_search_get_data (search));
-  previous = gw_searchdata_get_result (sdata);
+    //Cleanup
+    gw_outputbatch_clear (&batch);
 
-  return lw_result_is_similar (previous, current);
+    return appended;
 }
 
 
 //!
-//! @brief Appends an edict style result to the buffer, adding nice formatting.
-//!
-//! This is a part of a set of functions used for the global output function pointers and
-//! isn't used directly
-//!
-//! @param search A LwSearch to gleam information from.
+//! @brief Appends a result to the output
+//! @param engine The LwEngine to use for output
+//! @param search The data from the LwSearch
 //!
-static void 
-gw_searchwindow_append_edict_result (GwSearchWindow *window, LwSearch *search)
+void 
+gw_searchwindow_append_result (GwSearchWindow *window, LwSearch* search)
 {
-    //Sanity check
-    if (window == NULL || search == NULL) return;
-    g_assert (lw_search_has_data (search));
-
-    //Declarations
-    GwSearchWindowClass *klass;
-    LwResult *result;
-    GwSearchData *sdata;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    GtkTextMark *mark;
-    GtkTextIter iter;
-    int line, start_offset, end_offset;
-
-    //Initializations
-    klass = GW_SEARCHWINDOW_CLASS (G_OBJECT_GET_CLASS (window));
-    result = lw_search_get_result (search);
-    if (result == NULL) return;
-    sdata = GW_SEARCHDATA (lw_search_get_data (search));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
-
-    if (lw_search_next_is_same (search, result))
-    {
-      gw_searchwindow_append_def_same_to_buffer (window, search, result);
-      gw_searchdata_set_result (sdata, result);
-      return;
-    }
-
-    gw_searchdata_set_result (sdata, result);
-
-    //Start output
-    mark = gtk_text_buffer_get_mark (buffer, "content_insertion_mark");
+    gw_searchwindow_append_results (window, search, 1);
+}
 
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
-    line = gtk_text_iter_get_line (&iter);
 
+//!
+//! @brief Appends the kanji, reading, classification and add link of an edict
+//!        style result to the batch
+//!
+static void
+gw_searchwindow_append_edict_headword (GwOutputBatch *batch, LwResult *result)
+{
     //Kanji
     if (result->kanji_start != NULL)
     {
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->kanji_start, -1, "entry-header", NULL);
+      gw_outputbatch_append_field (batch, result, result->kanji_start, "entry-header");
     }
 
     //Furigana
     if (result->furigana_start != NULL)
     {
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, "【", -1, "entry-header", NULL);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->furigana_start, -1, "entry-header", NULL);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, "】", -1, "entry-header", NULL);
+      gw_outputbatch_append (batch, "【", "entry-header");
+      gw_outputbatch_append_field (batch, result, result->furigana_start, "entry-header");
+      gw_outputbatch_append (batch, "】", "entry-header");
     }
     //Other info
     if (result->classification_start != NULL)
     {
-      gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->classification_start, -1, "entry-lexicon", NULL);
+      gw_outputbatch_append (batch, " ", NULL);
+      gw_outputbatch_append (batch, result->classification_start, "entry-lexicon");
     }
     if (result->important == TRUE)
     {
-      gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Pop"), -1, "entry-popular", NULL);
+      gw_outputbatch_append (batch, " ", NULL);
+      gw_outputbatch_append (batch, gettext("Pop"), "entry-popular");
     }
 
-    gw_searchwindow_insert_edict_addlink (window, result, buffer, &iter);
+    gw_searchwindow_insert_edict_addlink (batch, result);
+}
+
 
-    gw_shift_stay_mark (search, "previous_result");
-    start_offset = 0;
-    end_offset = gtk_text_iter_get_line_offset (&iter);
+//!
+//! @brief Appends the headword of an edict style result to the headline of the
+//!        result before it, which has the same definitions
+//!
+//! @param batch The GwOutputBatch to append to, inserting at the "previous_result" mark
+//! @param result The LwResult to append
+//!
+static void
+gw_searchwindow_append_edict_alternate (GwOutputBatch *batch, LwResult *result)
+{
+    gw_outputbatch_append (batch, " /", "entry-header");
+    gw_outputbatch_append (batch, " ", NULL);
+    gw_searchwindow_append_edict_headword (batch, result);
+}
 
-    gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-    gw_add_match_highlights (line, start_offset, end_offset, search);
+
+//!
+//! @brief Appends an edict style result to the batch, adding nice formatting.
+//!
+//! This is a part of a set of functions used for the global output function pointers and
+//! isn't used directly
+//!
+//! @param batch The GwOutputBatch to append to
+//! @param result The LwResult to append
+//!
+static void 
+gw_searchwindow_append_edict_result (GwOutputBatch *batch, LwResult *result)
+{
+    //Declarations
+    LwResult *similar;
+    GList *link;
+    gint i;
+
+    gw_searchwindow_append_edict_headword (batch, result);
+    batch->headline_end = batch->length;
+
+    gw_outputbatch_append (batch, "\n", NULL);
 
     //Definitions
-    int i = 0;
-    while (result->def_start[i] != NULL)
+    for (i = 0; result->def_start[i] != NULL; i++)
     {
-      gtk_text_buffer_insert (buffer, &iter, "      ", -1);
-
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->number[i], -1, "comment", NULL);
-      gtk_text_buffer_insert                   (buffer, &iter, " ", -1);
-      gtk_text_buffer_insert                   (buffer, &iter, result->def_start[i], -1);
-      end_offset = gtk_text_iter_get_line_offset (&iter);
-      line = gtk_text_iter_get_line (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, search);
-      gtk_text_buffer_insert                   (buffer, &iter, "\n", -1);
-      i++;
+      gw_outputbatch_append (batch, "      ", NULL);
+      gw_outputbatch_append (batch, result->number[i], "comment");
+      gw_outputbatch_append (batch, " ", NULL);
+      gw_outputbatch_append_field (batch, result, result->def_start[i], NULL);
+      gw_outputbatch_append (batch, "\n", NULL);
     }
-    gtk_text_buffer_insert (buffer, &iter, " \n", -1);
 
-    g_signal_emit (window, 
-      klass->signalid[GW_SEARCHWINDOW_CLASS_SIGNALID_WORD_ADDED], 
-      g_quark_from_static_string ("edict"), 
-      result
-    );
+    //Sense blocks of entries the search collapsed into this one
+    for (link = result->similar; link != NULL; link = link->next)
+    {
+      similar = LW_RESULT (link->data);
+      if (similar->classification_start != NULL || similar->important == TRUE)
+      {
+        gw_outputbatch_append (batch, "    ", NULL);
+        if (similar->classification_start != NULL)
+        {
+          gw_outputbatch_append (batch, similar->classification_start, "entry-lexicon");
+          gw_outputbatch_append (batch, " ", NULL);
+        }
+        if (similar->important == TRUE)
+          gw_outputbatch_append (batch, gettext("Pop"), "entry-popular");
+        gw_outputbatch_append (batch, "\n", NULL);
+      }
+      for (i = 0; similar->def_start[i] != NULL; i++)
+      {
+        gw_outputbatch_append (batch, "      ", NULL);
+        gw_outputbatch_append (batch, similar->number[i], "comment");
+        gw_outputbatch_append (batch, " ", NULL);
+        gw_outputbatch_append_field (batch, similar, similar->def_start[i], NULL);
+        gw_outputbatch_append (batch, "\n", NULL);
+      }
+    }
+    gw_outputbatch_append (batch, " \n", NULL);
 }
 
 
 static void
-gw_searchwindow_insert_kanjidict_addlink (GwSearchWindow *window, LwResult *result, GtkTextBuffer *buffer, GtkTextIter *iter)
+gw_searchwindow_insert_kanjidict_addlink (GwOutputBatch *batch, LwResult *result)
 {
     //Declarations
     gchar *kanji, *furigana, *definitions;
@@ -554,7 +582,7 @@ gw_searchwindow_insert_kanjidict_addlink (GwSearchWindow *window, LwResult *resu
         lw_word_set_furigana (word, furigana);
         lw_word_set_definitions (word, definitions);
 
-        gw_searchwindow_insert_addlink (window, buffer, iter, word);
+        gw_searchwindow_insert_addlink (batch, word);
 
         lw_word_free (word);
       }
@@ -565,149 +593,96 @@ gw_searchwindow_insert_kanjidict_addlink (GwSearchWindow *window, LwResult *resu
 
 
 //!
-//! @brief Appends a kanjidict style result to the buffer, adding nice formatting.
+//! @brief Appends a kanjidict style result to the batch, adding nice formatting.
 //!
 //! This is a part of a set of functions used for the global output function pointers and
 //! isn't used directly
 //!
-//! @param search A LwSearch to gleam information from.
+//! @param batch The GwOutputBatch to append to
+//! @param result The LwResult to append
 //!
 static void 
-gw_searchwindow_append_kanjidict_result (GwSearchWindow *window, LwSearch *search)
+gw_searchwindow_append_kanjidict_result (GwOutputBatch *batch, LwResult *result)
 {
-    //Sanity check
-    g_assert (lw_search_has_data (search));
-
     //Declarations
-    GwSearchWindowClass *klass;
     GwApplication *application;
-    GwSearchData *sdata;
-    LwResult *result;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    GtkTextIter iter;
-    GtkTextMark *mark;
-    gint line, start_offset, end_offset;
+    gboolean line_started;
 
     //Initializations
-    klass = GW_SEARCHWINDOW_CLASS (G_OBJECT_GET_CLASS (window));
-    application = gw_window_get_application (GW_WINDOW (window));
-    result = lw_search_get_result (search);
-    if (result == NULL) return;
-    sdata = GW_SEARCHDATA (lw_search_get_data (search));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
-
-    gw_searchdata_set_result (sdata, result);
-
-    mark = gtk_text_buffer_get_mark (buffer, "content_insertion_mark");
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
+    application = gw_window_get_application (GW_WINDOW (batch->window));
+    line_started = FALSE;
 
     //Kanji
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-    gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->kanji, -1, "entry-grand-header", NULL);
-    gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, " ", -1, "entry-grand-header", NULL);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-    gw_add_match_highlights (line, start_offset, end_offset, search);
+    gw_outputbatch_append_field (batch, result, result->kanji, "entry-grand-header");
+    gw_outputbatch_append (batch, " ", "entry-grand-header");
 
-    gw_searchwindow_insert_kanjidict_addlink (window, result, buffer, &iter);
+    gw_searchwindow_insert_kanjidict_addlink (batch, result);
 
-    gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+    gw_outputbatch_append (batch, "\n", NULL);
 
     //Radicals
     if (result->radicals != NULL)
     {
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Radicals:"), -1, "entry-bullet", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_insert (buffer, &iter, result->radicals, -1);
-      gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, search);
-
-      gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+      gw_outputbatch_append (batch, gettext("Radicals:"), "entry-bullet");
+      gw_outputbatch_append_field (batch, result, result->radicals, NULL);
+      gw_outputbatch_append (batch, " ", NULL);
+      gw_outputbatch_append (batch, "\n", NULL);
     }
 
     //Readings
     if (result->readings[0] != NULL)
     {
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Readings:"), -1, "entry-bullet", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_insert (buffer, &iter, result->readings[0], -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, search);
-      gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+      gw_outputbatch_append (batch, gettext("Readings:"), "entry-bullet");
+      gw_outputbatch_append_field (batch, result, result->readings[0], NULL);
+      gw_outputbatch_append (batch, "\n", NULL);
     }
     if (result->readings[1] != NULL)
     {
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Name:"), -1, "entry-bullet", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_insert (buffer, &iter, result->readings[1], -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, search);
-      gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+      gw_outputbatch_append (batch, gettext("Name:"), "entry-bullet");
+      gw_outputbatch_append_field (batch, result, result->readings[1], NULL);
+      gw_outputbatch_append (batch, "\n", NULL);
     }
     if (result->readings[2] != NULL)
     {
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Radical Name:"), -1, "entry-bullet", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_insert (buffer, &iter, result->readings[2], -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, search);
-      gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+      gw_outputbatch_append (batch, gettext("Radical Name:"), "entry-bullet");
+      gw_outputbatch_append_field (batch, result, result->readings[2], NULL);
+      gw_outputbatch_append (batch, "\n", NULL);
     }
 
-
     //etc
-    gboolean line_started = FALSE;
     if (result->strokes)
     {
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Stroke:"), -1, "entry-bullet", NULL);
-      gtk_text_buffer_insert (buffer, &iter, result->strokes, -1);
+      gw_outputbatch_append (batch, gettext("Stroke:"), "entry-bullet");
+      gw_outputbatch_append (batch, result->strokes, NULL);
       line_started = TRUE;
     }
     if (result->frequency)
     {
-      if (line_started) gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Freq:"), -1, "entry-bullet", NULL);
-      gtk_text_buffer_insert (buffer, &iter, result->frequency, -1);
-      gtk_text_buffer_insert (buffer, &iter, " ", -1);
+      if (line_started) gw_outputbatch_append (batch, " ", NULL);
+      gw_outputbatch_append (batch, gettext("Freq:"), "entry-bullet");
+      gw_outputbatch_append (batch, result->frequency, NULL);
+      gw_outputbatch_append (batch, " ", NULL);
     }
     if (result->grade)
     {
-      if (line_started) gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Grade:"), -1, "entry-bullet", NULL);
-      gtk_text_buffer_insert (buffer, &iter, result->grade, -1);
+      if (line_started) gw_outputbatch_append (batch, " ", NULL);
+      gw_outputbatch_append (batch, gettext("Grade:"), "entry-bullet");
+      gw_outputbatch_append (batch, result->grade, NULL);
     }
     if (result->jlpt)
     {
-      if (line_started) gtk_text_buffer_insert (buffer, &iter, " ", -1);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("JLPT:"), -1, "entry-bullet", NULL);
-      gtk_text_buffer_insert (buffer, &iter, result->jlpt, -1);
+      if (line_started) gw_outputbatch_append (batch, " ", NULL);
+      gw_outputbatch_append (batch, gettext("JLPT:"), "entry-bullet");
+      gw_outputbatch_append (batch, result->jlpt, NULL);
     }
 
-    gtk_text_buffer_insert (buffer, &iter, "\n", -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+    gw_outputbatch_append (batch, "\n", NULL);
 
     //Meanings
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-    gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("Meanings:"), -1, "entry-bullet", NULL);
-    gtk_text_buffer_insert (buffer, &iter, result->meanings, -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-    gw_add_match_highlights (line, start_offset, end_offset, search);
-
-    gtk_text_buffer_insert (buffer, &iter, "\n \n", -1);
-
-    g_signal_emit (window, 
-      klass->signalid[GW_SEARCHWINDOW_CLASS_SIGNALID_WORD_ADDED], 
-      g_quark_from_static_string ("kanjidict"), 
-      result
-    );
+    gw_outputbatch_append (batch, gettext("Meanings:"), "entry-bullet");
+    gw_outputbatch_append_field (batch, result, result->meanings, NULL);
+
+    gw_outputbatch_append (batch, "\n \n", NULL);
 
     if (result->radicals != NULL)
     {
@@ -722,148 +697,413 @@ gw_searchwindow_append_kanjidict_result (GwSearchWindow *window, LwSearch *searc
 
 
 //!
-//! @brief Appends a examplesdict style result to the buffer, adding nice formatting.
+//! @brief Appends a examplesdict style result to the batch, adding nice formatting.
 //!
 //! This is a part of a set of functions used for the global output function pointers and
 //! isn't used directly
 //!
-//! @param search A LwSearch to gleam information from.
+//! @param batch The GwOutputBatch to append to
+//! @param result The LwResult to append
 //!
 static void 
-gw_searchwindow_append_examplesdict_result (GwSearchWindow *window, LwSearch *search)
+gw_searchwindow_append_examplesdict_result (GwOutputBatch *batch, LwResult *result)
 {
-    //Sanity check
-    g_assert (lw_search_has_data (search));
-
-    //Declarations
-    GwSearchWindowClass *klass;
-    GwSearchData *sdata;
-    LwResult *result;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    int line, start_offset, end_offset;
-    GtkTextMark *mark;
-    GtkTextIter iter;
-
-    //Initializations
-    klass = GW_SEARCHWINDOW_CLASS (G_OBJECT_GET_CLASS (window));
-    result = lw_search_get_result (search);
-    if (result == NULL) return;
-    sdata = GW_SEARCHDATA (lw_search_get_data (search));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
-    mark = gtk_text_buffer_get_mark (buffer, "content_insertion_mark");
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
-
-    gw_searchdata_set_result (sdata, result);
-
     if (result->def_start[0] != NULL)
     {
       // TRANSLATORS: The "E" stands for "English"
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("E:\t"), -1, "entry-header", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->def_start[0], -1, "entry-header", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, search);
+      gw_outputbatch_append (batch, gettext("E:\t"), "entry-header");
+      gw_outputbatch_append_field (batch, result, result->def_start[0], "entry-header");
     }
 
     if (result->kanji_start != NULL)
     {
       // TRANSLATORS: The "J" stands for "Japanese"
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("\nJ:\t"), -1, "entry-header", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->kanji_start, -1, "entry-example-definition", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, search);
+      gw_outputbatch_append (batch, gettext("\nJ:\t"), "entry-header");
+      gw_outputbatch_append_field (batch, result, result->kanji_start, "entry-example-definition");
     }
 
     if (result->furigana_start != NULL)
     {
       // TRANSLATORS: The "D" stands for "Detail"
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, gettext("\nD:\t"), -1, "entry-header", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_insert_with_tags_by_name (buffer, &iter, result->furigana_start, -1, "entry-example-definition", NULL);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-      gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-      gw_add_match_highlights (line, start_offset, end_offset, search);
+      gw_outputbatch_append (batch, gettext("\nD:\t"), "entry-header");
+      gw_outputbatch_append_field (batch, result, result->furigana_start, "entry-example-definition");
     }
 
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
-    gtk_text_buffer_insert (buffer, &iter, "\n \n", -1);
-
-    g_signal_emit (window, 
-      klass->signalid[GW_SEARCHWINDOW_CLASS_SIGNALID_WORD_ADDED], 
-      g_quark_from_static_string ("examplesdict"), 
-      result
-    );
-
+    gw_outputbatch_append (batch, "\n \n", NULL);
 }
 
 
 //!
-//! @brief Appends a examplesdict style result to the buffer, adding nice formatting.
+//! @brief Appends a examplesdict style result to the batch, adding nice formatting.
 //!
 //! This is a part of a set of functions used for the global output function pointers and
 //! isn't used directly.  This is the fallback safe function for unknown dictionaries.
 //!
-//! @param search A LwSearch to gleam information from.
+//! @param batch The GwOutputBatch to append to
+//! @param result The LwResult to append
 //!
 static void 
-gw_searchwindow_append_unknowndict_result (GwSearchWindow *window, LwSearch *search)
+gw_searchwindow_append_unknowndict_result (GwOutputBatch *batch, LwResult *result)
 {
-    //Sanity check
-    g_assert (lw_search_has_data (search));
+    gw_outputbatch_append_field (batch, result, result->text, NULL);
+    gw_outputbatch_append (batch, " ", NULL);
+    gw_outputbatch_append (batch, "\n \n", NULL);
+}
 
-    //Definitions
-    GwSearchWindowClass *klass;
-    LwResult *result;
-    GwSearchData *sdata;
-    GtkTextView *view;
-    GtkTextBuffer *buffer;
-    GtkTextIter iter;
-    GtkTextMark *mark;
-    int line, start_offset, end_offset;
 
+//!
+//! @brief Appends a field of a result as markup, making where the search
+//!        found the query in it bold
+//!
+static void
+gw_searchwindow_append_markup_field (GString *markup, LwResult *result, const gchar *FIELD)
+{
+    //Declarations
+    gchar *escaped;
+    gint index;
+    gint start;
+    gint end;
+    gint written;
+
+    if (FIELD == NULL) return;
 
     //Initializations
-    klass = GW_SEARCHWINDOW_CLASS (G_OBJECT_GET_CLASS (window));
-    result = lw_search_get_result (search);
+    index = 0;
+    written = 0;
+
+    while (lw_result_next_span (result, FIELD, &index, &start, &end))
+    {
+      if (end <= written) continue;
+      if (start < written) start = written;
+
+      escaped = g_markup_escape_text (FIELD + written, start - written);
+      g_string_append (markup, escaped);
+      g_free (escaped); escaped = NULL;
+
+      escaped = g_markup_escape_text (FIELD + start, end - start);
+      g_string_append_printf (markup, "<b>%s</b>", escaped);
+      g_free (escaped); escaped = NULL;
+
+      written = end;
+    }
+
+    escaped = g_markup_escape_text (FIELD + written, -1);
+    g_string_append (markup, escaped);
+    g_free (escaped); escaped = NULL;
+}
+
+
+//!
+//! @brief Builds the markup of a row of the result list, laid out like the
+//!        results in the text view
+//!
+static gchar*
+gw_searchwindow_build_result_markup (LwResult *result, GType type)
+{
+    //Declarations
+    GString *markup;
+    LwResult *similar;
+    GList *link;
+    gint i;
+
+    //Initializations
+    markup = g_string_sized_new (256);
+
+    if (g_type_is_a (type, LW_TYPE_EDICTIONARY))
+    {
+      g_string_append (markup, "<big>");
+      gw_searchwindow_append_markup_field (markup, result, result->kanji_start);
+      if (result->furigana_start != NULL)
+      {
+        g_string_append (markup, "【");
+        gw_searchwindow_append_markup_field (markup, result, result->furigana_start);
+        g_string_append (markup, "】");
+      }
+      g_string_append (markup, "</big>");
+      if (result->classification_start != NULL)
+      {
+        g_string_append (markup, " <i>");
+        gw_searchwindow_append_markup_field (markup, result, result->classification_start);
+        g_string_append (markup, "</i>");
+      }
+      if (result->important == TRUE)
+        g_string_append_printf (markup, " <small>%s</small>", gettext("Pop"));
+      for (i = 0; result->def_start[i] != NULL; i++)
+      {
+        g_string_append_printf (markup, "\n      <small>%s</small> ", (result->number[i] != NULL) ? result->number[i] : "");
+        gw_searchwindow_append_markup_field (markup, result, result->def_start[i]);
+      }
+      for (link = result->similar; link != NULL; link = link->next)
+      {
+        similar = LW_RESULT (link->data);
+        for (i = 0; similar->def_start[i] != NULL; i++)
+        {
+          g_string_append_printf (markup, "\n      <small>%s</small> ", (similar->number[i] != NULL) ? similar->number[i] : "");
+          gw_searchwindow_append_markup_field (markup, similar, similar->def_start[i]);
+        }
+      }
+    }
+    else if (g_type_is_a (type, LW_TYPE_KANJIDICTIONARY))
+    {
+      g_string_append (markup, "<big>");
+      gw_searchwindow_append_markup_field (markup, result, result->kanji);
+      g_string_append (markup, "</big>");
+      if (result->readings[0] != NULL)
+      {
+        g_string_append_printf (markup, "\n<b>%s</b>", gettext("Readings:"));
+        gw_searchwindow_append_markup_field (markup, result, result->readings[0]);
+      }
+      if (result->readings[1] != NULL)
+      {
+        g_string_append_printf (markup, "\n<b>%s</b>", gettext("Name:"));
+        gw_searchwindow_append_markup_field (markup, result, result->readings[1]);
+      }
+      if (result->meanings != NULL)
+      {
+        g_string_append_printf (markup, "\n<b>%s</b>", gettext("Meanings:"));
+        gw_searchwindow_append_markup_field (markup, result, result->meanings);
+      }
+    }
+    else if (g_type_is_a (type, LW_TYPE_EXAMPLEDICTIONARY))
+    {
+      if (result->def_start[0] != NULL)
+      {
+        g_string_append_printf (markup, "<b>%s</b>", gettext("E:\t"));
+        gw_searchwindow_append_markup_field (markup, result, result->def_start[0]);
+      }
+      if (result->kanji_start != NULL)
+      {
+        g_string_append_printf (markup, "<b>%s</b>", gettext("\nJ:\t"));
+        gw_searchwindow_append_markup_field (markup, result, result->kanji_start);
+      }
+      if (result->furigana_start != NULL)
+      {
+        g_string_append_printf (markup, "<b>%s</b>", gettext("\nD:\t"));
+        gw_searchwindow_append_markup_field (markup, result, result->furigana_start);
+      }
+    }
+    else
+    {
+      gw_searchwindow_append_markup_field (markup, result, result->text);
+    }
+
+    return g_string_free (markup, FALSE);
+}
+
+
+//!
+//! @brief Puts the lines of a markup on one line, separated by two spaces
+//!
+static void
+gw_searchwindow_join_markup_lines (GString *markup)
+{
+    //Declarations
+    gint i;
+    gint end;
+
+    for (i = 0; i < markup->len; i++)
+    {
+      if (markup->str[i] != '\n') continue;
+
+      end = i;
+      while (i > 0 && g_ascii_isspace (markup->str[i - 1])) i--;
+      while (end < markup->len && g_ascii_isspace (markup->str[end])) end++;
+
+      g_string_erase (markup, i, end - i);
+      g_string_insert (markup, i, "  ");
+      i++;
+    }
+}
+
+
+//!
+//! @brief Sets the markup of a row of the result list.  The markup is only
+//!        built for the rows the tree view lays out and isn't kept.  Rows are
+//!        one line each, so the list can use fixed-height-mode.
+//!
+static void
+gw_searchwindow_resultlist_cell_data_func (GtkTreeViewColumn *column,
+                                           GtkCellRenderer   *renderer,
+                                           GtkTreeModel      *model,
+                                           GtkTreeIter       *iter,
+                                           gpointer           data)
+{
+    //Declarations
+    LwResult *result;
+    GType type;
+    GString *markup;
+    gchar *text;
+
+    //Initializations
+    result = NULL;
+    type = G_TYPE_NONE;
+
+    gtk_tree_model_get (model, iter, GW_RESULTLIST_COLUMN_RESULT, &result, GW_RESULTLIST_COLUMN_TYPE, &type, -1);
     if (result == NULL) return;
-    sdata = GW_SEARCHDATA (lw_search_get_data (search));
-    view = GTK_TEXT_VIEW (sdata->view);
-    buffer = gtk_text_view_get_buffer (view);
-    mark = gtk_text_buffer_get_mark (buffer, "content_insertion_mark");
 
-    gw_searchdata_set_result (sdata, result);
+    text = gw_searchwindow_build_result_markup (result, type);
+    markup = g_string_new (text);
+    g_free (text); text = NULL;
+    gw_searchwindow_join_markup_lines (markup);
+    g_object_set (G_OBJECT (renderer), "markup", markup->str, NULL);
+
+    //Cleanup
+    g_string_free (markup, TRUE); markup = NULL;
+}
 
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); start_offset = gtk_text_iter_get_line_offset (&iter);
-    gtk_text_buffer_insert (buffer, &iter, result->text, -1);
-    gtk_text_buffer_insert (buffer, &iter, " ", -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); end_offset = gtk_text_iter_get_line_offset (&iter);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
-    gw_add_match_highlights (line, start_offset, end_offset, search);
 
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark);
-    gtk_text_buffer_insert (buffer, &iter, "\n \n", -1);
-    gtk_text_buffer_get_iter_at_mark (buffer, &iter, mark); line = gtk_text_iter_get_line (&iter);
+//!
+//! @brief Creates the list a tab switches to once a search has more results
+//!        than the text view should hold
+//! @return A new GtkTreeView.  Its model keeps the results appended to it.
+//!
+GtkTreeView*
+gw_searchwindow_resultlist_new ()
+{
+    //Declarations
+    GtkListStore *store;
+    GtkTreeView *view;
+    GtkTreeViewColumn *column;
+    GtkCellRenderer *renderer;
+    GPtrArray *results;
 
-    g_signal_emit (window, 
-      klass->signalid[GW_SEARCHWINDOW_CLASS_SIGNALID_WORD_ADDED], 
-      g_quark_from_static_string ("unknowndict"), 
-      result
+    //Initializations
+    store = gtk_list_store_new (TOTAL_GW_RESULTLIST_COLUMNS, G_TYPE_POINTER, G_TYPE_GTYPE);
+    results = g_ptr_array_new_with_free_func ((GDestroyNotify) lw_result_free);
+    g_object_set_data_full (G_OBJECT (store), "results", results, (GDestroyNotify) g_ptr_array_unref);
+
+    view = GTK_TREE_VIEW (gtk_tree_view_new_with_model (GTK_TREE_MODEL (store)));
+    gtk_tree_view_set_headers_visible (view, FALSE);
+    gtk_tree_view_set_enable_search (view, FALSE);
+
+    renderer = gtk_cell_renderer_text_new ();
+    g_object_set (G_OBJECT (renderer), 
+      "ellipsize", PANGO_ELLIPSIZE_END, 
+      "ypad", 6,
+      NULL
     );
+    column = gtk_tree_view_column_new ();
+    gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_FIXED);
+    gtk_tree_view_column_set_expand (column, TRUE);
+    gtk_tree_view_column_pack_start (column, renderer, TRUE);
+    gtk_tree_view_column_set_cell_data_func (column, renderer, gw_searchwindow_resultlist_cell_data_func, NULL, NULL);
+    gtk_tree_view_append_column (view, column);
+
+    //Every row has the height of the first, so rows past the visible ones are never measured
+    gtk_tree_view_set_fixed_height_mode (view, TRUE);
+
+    //Cleanup
+    g_object_unref (store); store = NULL;
+
+    return view;
+}
+
+
+//!
+//! @brief Adds a result to the end of the result list, which takes it
+//!
+void
+gw_searchwindow_resultlist_append (GtkTreeView *view, LwResult *result, GType type)
+{
+    //Sanity checks
+    g_return_if_fail (view != NULL);
+    g_return_if_fail (result != NULL);
+
+    //Declarations
+    GtkListStore *store;
+    GPtrArray *results;
+    GtkTreeIter iter;
+
+    //Initializations
+    store = GTK_LIST_STORE (gtk_tree_view_get_model (view));
+    results = g_object_get_data (G_OBJECT (store), "results");
+
+    g_ptr_array_add (results, result);
+    gtk_list_store_insert_with_values (store, &iter, -1, 
+      GW_RESULTLIST_COLUMN_RESULT, result, 
+      GW_RESULTLIST_COLUMN_TYPE, type, 
+      -1
+    );
+}
+
+
+//!
+//! @brief Removes and frees every result of the result list
+//!
+void
+gw_searchwindow_resultlist_clear (GtkTreeView *view)
+{
+    //Sanity checks
+    g_return_if_fail (view != NULL);
+
+    //Declarations
+    GtkListStore *store;
+    GPtrArray *results;
+
+    //Initializations
+    store = GTK_LIST_STORE (gtk_tree_view_get_model (view));
+    results = g_object_get_data (G_OBJECT (store), "results");
+
+    gtk_list_store_clear (store);
+    g_ptr_array_set_size (results, 0);
+}
+
+
+//!
+//! @brief Builds the text of every result of the result list, laid out like
+//!        the results in the text view, for saving and printing
+//! @returns A newly allocated string that should be freed with g_free
+//!
+gchar*
+gw_searchwindow_resultlist_get_text (GtkTreeView *view)
+{
+    //Sanity checks
+    g_return_val_if_fail (view != NULL, NULL);
+
+    //Declarations
+    GtkTreeModel *model;
+    GtkTreeIter iter;
+    GString *text;
+    LwResult *result;
+    GType type;
+    gchar *markup;
+    gchar *line;
+    gboolean valid;
+
+    //Initializations
+    model = gtk_tree_view_get_model (view);
+    text = g_string_new (NULL);
+
+    for (valid = gtk_tree_model_get_iter_first (model, &iter); valid; valid = gtk_tree_model_iter_next (model, &iter))
+    {
+      result = NULL;
+      type = G_TYPE_NONE;
+      gtk_tree_model_get (model, &iter, GW_RESULTLIST_COLUMN_RESULT, &result, GW_RESULTLIST_COLUMN_TYPE, &type, -1);
+      if (result == NULL) continue;
+
+      markup = gw_searchwindow_build_result_markup (result, type);
+      line = NULL;
+      if (pango_parse_markup (markup, -1, 0, NULL, &line, NULL, NULL))
+      {
+        g_string_append (text, line);
+        g_string_append (text, "\n \n");
+      }
+
+      //Cleanup
+      if (line != NULL) g_free (line); line = NULL;
+      g_free (markup); markup = NULL;
+    }
+
+    return g_string_free (text, FALSE);
 }
 
 
 void 
-gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow *window, LwSearch *search)
+gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow *window, LwResult *result)
 {
-    if (search == NULL) return;
+    if (result == NULL) return;
     //Declarations
     GwSearchWindowPrivate *priv;
-    LwResult *result;
     GtkTextView *view;
     gchar *markup;
     gchar *new;
@@ -878,8 +1118,6 @@ gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow *window, LwSearc
     char *markup2;
 
     //Initializations
-    result = lw_search_get_result (search);
-    if (result == NULL) return;
     priv = window->priv;
     view = gw_searchwindow_get_current_textview (window);
     if (view == NULL) return;
@@ -1035,10 +1273,6 @@ gw_searchwindow_append_kanjidict_tooltip_result (GwSearchWindow *window, LwSearc
     //Cleanup
     g_free (markup);
     g_free (markup2);
-    lw_result_free (result);
-    lw_search_cancel (search);
-    lw_search_free (priv->mouse_item);
-    priv->mouse_item = NULL;
 }
 
 
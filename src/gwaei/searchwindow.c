@@ -247,6 +247,7 @@ gw_searchwindow_constructed (GObject *object)
     priv->statusbar_progressbar = GTK_PROGRESS_BAR (gw_window_get_object (GW_WINDOW (window), "statusbar_progressbar"));
 
     priv->history = gw_history_new (20);
+    lw_history_set_log (LW_HISTORY (priv->history), gw_application_get_historylog (application));
 
     gw_searchwindow_initialize_toolbar (window);
     gw_searchwindow_initialize_search_toolbar (window);
@@ -353,17 +354,14 @@ gw_searchwindow_append_result_timeout (GwSearchWindow *window)
     if (gtk_widget_get_visible (GTK_WIDGET (window)) == FALSE) return TRUE;
 
     //Declarations
-    GwSearchWindowPrivate *priv;
     LwSearch *search;
+    GwSearchData *sdata;
     gint index;
-    gint chunk;
-    gint max_chunk;
     LwSearchStatus status;
     gboolean has_results;
     gint total_results;
 
     //Initializations
-    priv = window->priv;
     index = gw_searchwindow_get_current_tab_index (window);
     search = gw_searchwindow_get_searchitem_by_index (window, index);
 
@@ -372,8 +370,6 @@ gw_searchwindow_append_result_timeout (GwSearchWindow *window)
       status = lw_search_get_status (search);
       total_results = lw_search_get_total_results (search);
       has_results = lw_search_has_results (search);
-      chunk = 0;
-      max_chunk = 10;
       
       if (status == LW_SEARCHSTATUS_FINISHING && total_results == 0)
       {
@@ -381,23 +377,17 @@ gw_searchwindow_append_result_timeout (GwSearchWindow *window)
       }
       else if (has_results)
       {
-        while (has_results && chunk++ < max_chunk)
-        {
-          gw_searchwindow_append_result (window, search);
-          has_results = lw_search_has_results (search);
-        }
+        lw_trace_begin (LW_TRACE_CATEGORY_GUI, "append_results", NULL);
+        gw_searchwindow_append_results (window, search, GW_SEARCHWINDOW_APPEND_BATCH_SIZE);
+        lw_trace_end (LW_TRACE_CATEGORY_GUI, "append_results");
       }
-    }
-
-    search = priv->mouse_item;
 
-    if (search != NULL)
-    {
-      has_results = lw_search_has_results (search);
-      
-      if (search != NULL && has_results);
+      //A search from the history goes back to where it was scrolled to once every result is shown
+      sdata = (lw_search_has_data (search)) ? GW_SEARCHDATA (lw_search_get_data (search)) : NULL;
+      if (sdata != NULL && sdata->scroll >= 0.0 && lw_search_get_status (search) == LW_SEARCHSTATUS_IDLE)
       {
-        gw_searchwindow_append_kanjidict_tooltip_result (window, search);
+        gw_searchwindow_set_scroll_by_index (window, index, sdata->scroll);
+        sdata->scroll = -1.0;
       }
     }
 
@@ -880,6 +870,14 @@ gw_searchwindow_initialize_buffer_by_searchitem (GwSearchWindow *window, LwSearc
 
     gtk_text_buffer_set_text (buffer, "", -1);
 
+    //Go back to the text view until the search has too many results for it
+    data->appended = 0;
+    if (data->list != NULL)
+    {
+      gw_searchwindow_resultlist_clear (data->list);
+      gw_searchwindow_show_resultlist (window, data->list, FALSE);
+    }
+
     //Clear the target text buffer
     GtkTextIter iter;
     gtk_text_buffer_get_end_iter (buffer, &iter);
@@ -1121,15 +1119,20 @@ gw_searchwindow_cycle_dictionaries (GwSearchWindow* window, gboolean cycle_forwa
 //! @brief  Returns the unfreeable text from a gtk widget by target
 //!
 //! The fancy thing about this function is it will only return the
-//! highlighted text if some is highlighted.
+//! highlighted text if some is highlighted.  If the tab shows its result
+//! list, the text of every result in the list is returned.
 //!
 char* 
 gw_searchwindow_get_text (GwSearchWindow *window, GtkWidget *widget)
 {
     GtkTextView *view;
+    GtkTreeView *list;
     GtkTextBuffer *buffer;
     GtkTextIter s, e;
 
+    list = gw_searchwindow_get_current_shown_resultlist (window);
+    if (list != NULL) return gw_searchwindow_resultlist_get_text (list);
+
     view = gw_searchwindow_get_current_textview (window);
     buffer = gtk_text_view_get_buffer (view);
 
@@ -1261,8 +1264,6 @@ gw_searchwindow_cancel_all_searches (GwSearchWindow *window)
       }
       g_list_free (children); children = NULL;
     }
-
-    lw_search_cancel (priv->mouse_item);
 }
 
 
@@ -1332,7 +1333,7 @@ _get_searchwindow_child_widget (GwSearchWindow *window, int page_num, int child_
     if (scrolledwindow == NULL)
       return NULL;
 
-    viewport = GTK_VIEWPORT (gtk_bin_get_child (GTK_BIN (scrolledwindow)));
+    viewport = GTK_VIEWPORT (g_object_get_data (G_OBJECT (scrolledwindow), "viewport"));
     if (viewport == NULL)
       return NULL;
 
@@ -1355,6 +1356,187 @@ gw_searchwindow_get_textview (GwSearchWindow *window, int page_num)
 }
 
 
+//!
+//! @brief Gets the list a tab shows the results in once a search has too many for the text view
+//!
+GtkTreeView*
+gw_searchwindow_get_resultlist (GwSearchWindow *window, int page_num)
+{
+    //Sanity checks
+    g_return_val_if_fail (window != NULL, NULL);
+
+    //Declarations
+    GwSearchWindowPrivate *priv;
+    GtkWidget *scrolledwindow;
+
+    //Initializations
+    priv = window->priv;
+    scrolledwindow = gtk_notebook_get_nth_page (priv->notebook, page_num);
+    if (scrolledwindow == NULL) return NULL;
+
+    return GTK_TREE_VIEW (g_object_get_data (G_OBJECT (scrolledwindow), "resultlist"));
+}
+
+
+GtkTreeView*
+gw_searchwindow_get_current_resultlist (GwSearchWindow *window)
+{
+    //Sanity checks
+    g_return_val_if_fail (window != NULL, NULL);
+
+    //Declarations
+    GwSearchWindowPrivate *priv;
+    gint page_num;
+
+    //Initializations
+    priv = window->priv;
+    page_num = gtk_notebook_get_current_page (priv->notebook);
+
+    return gw_searchwindow_get_resultlist (window, page_num);
+}
+
+
+//!
+//! @brief Swaps what the scrolled window of the tab of a result list shows
+//!        between the text view and the list
+//! @param window A GwSearchWindow
+//! @param list The result list of a tab
+//! @param show TRUE to show the list, FALSE to show the text view again
+//!
+void
+gw_searchwindow_show_resultlist (GwSearchWindow *window, GtkTreeView *list, gboolean show)
+{
+    //Sanity checks
+    g_return_if_fail (window != NULL);
+    g_return_if_fail (list != NULL);
+
+    //Declarations
+    GtkWidget *scrolledwindow;
+    GtkWidget *viewport;
+    GtkWidget *child;
+    GtkWidget *target;
+
+    //Initializations
+    scrolledwindow = GTK_WIDGET (g_object_get_data (G_OBJECT (list), "scrolledwindow"));
+    if (scrolledwindow == NULL) return;
+    viewport = GTK_WIDGET (g_object_get_data (G_OBJECT (scrolledwindow), "viewport"));
+    child = gtk_bin_get_child (GTK_BIN (scrolledwindow));
+    target = (show) ? GTK_WIDGET (list) : viewport;
+
+    if (child == target || viewport == NULL) return;
+
+    if (child != NULL) gtk_container_remove (GTK_CONTAINER (scrolledwindow), child);
+    gtk_container_add (GTK_CONTAINER (scrolledwindow), target);
+}
+
+
+//!
+//! @brief Tells if the scrolled window of the tab of a result list shows the
+//!        list instead of the text view
+//!
+gboolean
+gw_searchwindow_resultlist_is_shown (GtkTreeView *list)
+{
+    //Sanity checks
+    g_return_val_if_fail (list != NULL, FALSE);
+
+    //Declarations
+    GtkWidget *scrolledwindow;
+
+    //Initializations
+    scrolledwindow = GTK_WIDGET (g_object_get_data (G_OBJECT (list), "scrolledwindow"));
+    if (scrolledwindow == NULL) return FALSE;
+
+    return (gtk_bin_get_child (GTK_BIN (scrolledwindow)) == GTK_WIDGET (list));
+}
+
+
+//!
+//! @brief Gets the result list of the current tab if it is shown instead of
+//!        the text view, since only the list has every result then
+//! @return The GtkTreeView of the list or NULL if the text view is shown
+//!
+GtkTreeView*
+gw_searchwindow_get_current_shown_resultlist (GwSearchWindow *window)
+{
+    //Declarations
+    GtkTreeView *list;
+
+    //Initializations
+    list = gw_searchwindow_get_current_resultlist (window);
+
+    if (list == NULL || !gw_searchwindow_resultlist_is_shown (list)) return NULL;
+
+    return list;
+}
+
+
+//!
+//! @brief Gets where the results of a tab are scrolled to
+//! @param window A GwSearchWindow
+//! @param index The index of the tab
+//! @return The position from 0.0 at the top to 1.0 at the bottom
+//!
+gdouble
+gw_searchwindow_get_scroll_by_index (GwSearchWindow *window, gint index)
+{
+    //Sanity checks
+    g_return_val_if_fail (window != NULL, 0.0);
+
+    //Declarations
+    GwSearchWindowPrivate *priv;
+    GtkWidget *scrolledwindow;
+    GtkAdjustment *adjustment;
+    gdouble lower;
+    gdouble range;
+
+    //Initializations
+    priv = window->priv;
+    scrolledwindow = gtk_notebook_get_nth_page (priv->notebook, index);
+    if (scrolledwindow == NULL) return 0.0;
+    adjustment = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (scrolledwindow));
+    lower = gtk_adjustment_get_lower (adjustment);
+    range = gtk_adjustment_get_upper (adjustment) - lower - gtk_adjustment_get_page_size (adjustment);
+
+    if (range <= 0.0) return 0.0;
+
+    return (gtk_adjustment_get_value (adjustment) - lower) / range;
+}
+
+
+//!
+//! @brief Scrolls the results of a tab
+//! @param window A GwSearchWindow
+//! @param index The index of the tab
+//! @param scroll The position from 0.0 at the top to 1.0 at the bottom
+//!
+void
+gw_searchwindow_set_scroll_by_index (GwSearchWindow *window, gint index, gdouble scroll)
+{
+    //Sanity checks
+    g_return_if_fail (window != NULL);
+
+    //Declarations
+    GwSearchWindowPrivate *priv;
+    GtkWidget *scrolledwindow;
+    GtkAdjustment *adjustment;
+    gdouble lower;
+    gdouble range;
+
+    //Initializations
+    priv = window->priv;
+    scrolledwindow = gtk_notebook_get_nth_page (priv->notebook, index);
+    if (scrolledwindow == NULL) return;
+    adjustment = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (scrolledwindow));
+    lower = gtk_adjustment_get_lower (adjustment);
+    range = gtk_adjustment_get_upper (adjustment) - lower - gtk_adjustment_get_page_size (adjustment);
+
+    if (range <= 0.0) return;
+
+    gtk_adjustment_set_value (adjustment, lower + CLAMP (scroll, 0.0, 1.0) * range);
+}
+
+
 GtkTextView*
 gw_searchwindow_get_current_textview (GwSearchWindow *window)
 {
@@ -1491,6 +1673,7 @@ gw_searchwindow_tabcontent_new (GwSearchWindow *window)
     GtkWidget *infobar;
     GtkWidget *scrolledwindow;
     GtkTextView *view;
+    GtkTreeView *list;
     GtkTextBuffer *buffer;
     GtkTextIter iter;
     GtkTextTagTable *tagtable;
@@ -1504,6 +1687,7 @@ gw_searchwindow_tabcontent_new (GwSearchWindow *window)
     infobar = GTK_WIDGET (_construct_infobar());
     scrollbox = GTK_WIDGET (gtk_box_new (GTK_ORIENTATION_VERTICAL, 0));
     viewport = GTK_WIDGET (gtk_viewport_new (NULL, NULL));
+    list = gw_searchwindow_resultlist_new ();
 
     g_object_unref (G_OBJECT (tagtable));
     g_object_unref (G_OBJECT (buffer));
@@ -1542,6 +1726,12 @@ gw_searchwindow_tabcontent_new (GwSearchWindow *window)
     gtk_container_add (GTK_CONTAINER (scrolledwindow), GTK_WIDGET (viewport));
     gtk_widget_show_all (GTK_WIDGET (scrolledwindow));
 
+    //The scrolled window swaps between the viewport and the result list, so it keeps both
+    g_object_set_data_full (G_OBJECT (scrolledwindow), "viewport", g_object_ref (viewport), g_object_unref);
+    g_object_set_data_full (G_OBJECT (scrolledwindow), "resultlist", g_object_ref_sink (list), g_object_unref);
+    g_object_set_data (G_OBJECT (list), "scrolledwindow", scrolledwindow);
+    gtk_widget_show (GTK_WIDGET (list));
+
     return GTK_WIDGET (scrolledwindow);
 }
 
@@ -1657,9 +1847,11 @@ gw_searchwindow_remove_tab_by_index (GwSearchWindow *window, gint index)
     GwSearchWindowPrivate *priv;
     LwSearch *search;
     LwHistory *history;
+    gdouble scroll;
 
     //Initializations
     priv = window->priv;
+    scroll = gw_searchwindow_get_scroll_by_index (window, index);
     search = gw_searchwindow_steal_searchitem_by_index (window, index);
     history = LW_HISTORY (priv->history);
 
@@ -1670,7 +1862,7 @@ gw_searchwindow_remove_tab_by_index (GwSearchWindow *window, gint index)
       gw_searchwindow_initialize_buffer_by_searchitem (window, search);
       if (lw_history_has_relevance (history, search, priv->keep_searching_enabled))
       {
-        lw_history_add_search (history, search);
+        lw_history_add_search (history, search, scroll);
       }
       else
       {
@@ -1812,6 +2004,7 @@ gw_searchwindow_start_search (GwSearchWindow *window, LwSearch* new_search)
     GwApplication *application;
     GwSearchData *sdata;
     GtkTextView *view;
+    GtkTreeView *list;
     gint index;
 
     //Initializations
@@ -1820,9 +2013,11 @@ gw_searchwindow_start_search (GwSearchWindow *window, LwSearch* new_search)
     if (!gw_application_can_start_search (application)) return;
     view = gw_searchwindow_get_current_textview (window);
     if (view == NULL) goto errored;
-    sdata = GW_SEARCHDATA (gw_searchdata_new (view, window));
+    list = gw_searchwindow_get_current_resultlist (window);
+    sdata = GW_SEARCHDATA (gw_searchdata_new (view, list, window));
     if (sdata == NULL) goto errored;
     lw_search_set_data (new_search, sdata, LW_SEARCH_DATA_FREE_FUNC (gw_searchdata_free));
+    lw_search_set_max_results (new_search, GW_SEARCHWINDOW_MAX_RESULTS);
 
     {
       LwSearch *search;
@@ -2052,6 +2247,14 @@ gw_searchwindow_attach_signals (GwSearchWindow *window)
         window
     );
 
+    priv->signalid[GW_SEARCHWINDOW_SIGNALID_HISTORY_CACHE_SIZE] = lw_preferences_add_change_listener_by_schema (
+        preferences,
+        LW_SCHEMA_BASE,
+        LW_KEY_HISTORY_CACHE_SIZE,
+        gw_searchwindow_sync_history_cache_size_cb,
+        window
+    );
+
 #ifdef WITH_HUNSPELL
     priv->signalid[GW_SEARCHWINDOW_SIGNALID_SPELLCHECK] = lw_preferences_add_change_listener_by_schema (
         preferences,
@@ -2191,6 +2394,11 @@ gw_searchwindow_remove_signals (GwSearchWindow *window)
         LW_SCHEMA_BASE,
         priv->signalid[GW_SEARCHWINDOW_SIGNALID_KEEP_SEARCHING]
     );
+    lw_preferences_remove_change_listener_by_schema (
+        preferences,
+        LW_SCHEMA_BASE,
+        priv->signalid[GW_SEARCHWINDOW_SIGNALID_HISTORY_CACHE_SIZE]
+    );
 
 #ifdef WITH_HUNSPELL
     lw_preferences_remove_change_listener_by_schema (
@@ -2249,6 +2457,8 @@ gw_searchwindow_initialize_search_toolbar (GwSearchWindow *window)
     GtkWidget *label;
     GtkWidget *entry;
     GtkWidget *combobox;
+    GtkEntryCompletion *completion;
+    GtkListStore *completionstore;
     GtkSettings *settings;
     gboolean os_shows_win_menu;
 
@@ -2293,6 +2503,16 @@ gw_searchwindow_initialize_search_toolbar (GwSearchWindow *window)
     g_signal_connect (entry, "changed", G_CALLBACK (gw_searchwindow_update_button_states_based_on_entry_text_cb), window);
     g_signal_connect (entry, "icon-release", G_CALLBACK (gw_searchwindow_clear_entry_button_pressed_cb), window);
     g_signal_connect (entry, "key-press-event", G_CALLBACK (gw_searchwindow_focus_change_on_key_press_cb), window);
+    g_signal_connect (entry, "changed", G_CALLBACK (gw_searchwindow_complete_from_history_cb), window);
+
+    //Past queries are offered as completions of what is typed
+    completionstore = gtk_list_store_new (1, G_TYPE_STRING);
+    completion = gtk_entry_completion_new ();
+    gtk_entry_completion_set_model (completion, GTK_TREE_MODEL (completionstore));
+    gtk_entry_completion_set_text_column (completion, 0);
+    gtk_entry_set_completion (GTK_ENTRY (entry), completion);
+    g_object_unref (completion); completion = NULL;
+    g_object_unref (completionstore); completionstore = NULL;
 
     gtk_container_add (GTK_CONTAINER (item), entry);
     gtk_widget_set_margin_left (GTK_WIDGET (item), 2);
@@ -2627,17 +2847,28 @@ gw_searchwindow_go_back (GwSearchWindow *window, gint i)
     GwSearchWindowPrivate *priv;
     LwHistory *history;
     LwSearch *search;
+    GwSearchData *sdata;
+    gdouble scroll;
     gint index;
     
     //Initializations
     priv = window->priv;
     history = LW_HISTORY (priv->history);
     index = gw_searchwindow_get_current_tab_index (window);
+    scroll = gw_searchwindow_get_scroll_by_index (window, index);
     search = gw_searchwindow_steal_searchitem_by_index (window, index);
 
-    while (i-- && search != NULL) search = lw_history_go_back (history, search);
+    while (i-- && search != NULL) search = lw_history_go_back (history, search, &scroll);
 
-    if (search != NULL) gw_searchwindow_start_search (window, search);
+    if (search != NULL) 
+    {
+      gw_searchwindow_start_search (window, search);
+      if (lw_search_has_data (search))
+      {
+        sdata = GW_SEARCHDATA (lw_search_get_data (search));
+        sdata->scroll = scroll;
+      }
+    }
 }
 
 
@@ -2651,17 +2882,28 @@ gw_searchwindow_go_forward (GwSearchWindow *window, gint i)
     GwSearchWindowPrivate *priv;
     LwHistory *history;
     LwSearch *search;
+    GwSearchData *sdata;
+    gdouble scroll;
     gint index;
     
     //Initializations
     priv = window->priv;
     history = LW_HISTORY (priv->history);
     index = gw_searchwindow_get_current_tab_index (window);
+    scroll = gw_searchwindow_get_scroll_by_index (window, index);
     search = gw_searchwindow_steal_searchitem_by_index (window, index);
 
-    while (i-- && search != NULL) search = lw_history_go_forward (history, search);
+    while (i-- && search != NULL) search = lw_history_go_forward (history, search, &scroll);
 
-    if (search != NULL) gw_searchwindow_start_search (window, search);
+    if (search != NULL) 
+    {
+      gw_searchwindow_start_search (window, search);
+      if (lw_search_has_data (search))
+      {
+        sdata = GW_SEARCHDATA (lw_search_get_data (search));
+        sdata->scroll = scroll;
+      }
+    }
 }
 
 
@@ -28,6 +28,10 @@
 #include "jstroke.h"
 #include "memowrite.h"
 
+#ifdef FOR_PILOT_COMPAT
+#include <glib.h>
+#endif /*FOR_PILOT_COMPAT*/
+
 #define diAngCostBase       52	// See angles.pl for derivation.
 #define diAngCostScale      98	// See angles.pl for derivation.
 #define diHugeCost          (((((ULong)24)*diAngCostScale)+diAngCostBase)*100)
@@ -43,6 +47,9 @@
 
 #define diPathBufLen        16
 
+#define diMaxScoreThreads    8	/* Most threads to score candidates on. */
+#define diMinThreadItems    64	/* Fewer candidates per thread aren't worth a thread. */
+
 CharPtr   StrokeScorerEvalItem(StrokeScorer *pScorer, CharPtr cpEntry,
 							   ULong* ipScore /*OUT*/);
 
@@ -58,6 +65,14 @@ Long      StrokeScorerExtraEval(StrokeScorer *pscorer,
 
 ULong     SqrtULong(ULong val);
 
+void      StrokeScorerAddScore(StrokeScorer *pScorer, CharPtr cp, ULong iScore);
+
+CharPtr   StrokeScorerNextItem(CharPtr cp);
+
+#ifdef FOR_PILOT_COMPAT
+Boolean   StrokeScorerProcessThreaded(StrokeScorer *pScorer, Long iMaxCnt);
+#endif /*FOR_PILOT_COMPAT*/
+
 /* ----- SqrtULong ---------------------------------------------------------*/
 
 ULong SqrtULong(ULong val) {
@@ -143,14 +158,19 @@ Long     StrokeScorerProcess  (StrokeScorer *pScorer, Long iMaxCnt) {
 	CharPtr      cp, cpNext;
 	ULong        iScore;
 	Long         iCnt;
-	ScoreItemPtr pScore, pScoreBase, pSrc;
 
 	if (!pScorer) {
 		ErrBox("StrokeScorerProcess: pScorer == NULL.");
 		return 0;
 	}
 
-	pScoreBase = pScorer->m_pScores;
+#ifdef FOR_PILOT_COMPAT
+	/* Split long candidate lists across threads.  The ranking comes out
+	 * the same as scoring them here one after another.
+	 */
+	if (StrokeScorerProcessThreaded(pScorer, iMaxCnt))
+		return 1;				/* should be count remaining, as below */
+#endif /*FOR_PILOT_COMPAT*/
 
 	/* Evaluate all the items in cpStrokeDic against Context,
 	 * and update ScoreItems list as we go.
@@ -165,39 +185,198 @@ Long     StrokeScorerProcess  (StrokeScorer *pScorer, Long iMaxCnt) {
 
 		cpNext = StrokeScorerEvalItem(pScorer, cp, &iScore);
 
-		for (pScore = pScoreBase+pScorer->m_iScoreLen-1;
-			 pScore>=pScoreBase; pScore--) { 
-			if (iScore >= pScore->m_iScore)
-				break;
+		StrokeScorerAddScore(pScorer, cp, iScore);
+
+	} /* for each stroke description... */
+
+	if (cp)
+		return 1;				/* should be count remaining */
+	else
+		return 0;
+}
+
+/* ----- StrokeScorerAddScore -----------------------------------------------*/
+/* Register a score in the top list if it is good enough.  A score ties
+ * behind the equal scores already in the list, so the candidates that were
+ * added first win ties.
+ */
+
+void StrokeScorerAddScore(StrokeScorer *pScorer, CharPtr cp, ULong iScore) {
+	ScoreItemPtr pScore, pScoreBase, pSrc;
+
+	pScoreBase = pScorer->m_pScores;
+
+	for (pScore = pScoreBase+pScorer->m_iScoreLen-1;
+		 pScore>=pScoreBase; pScore--) { 
+		if (iScore >= pScore->m_iScore)
+			break;
+	}
+	pScore++;
+
+	/* If we have a top score, lets register it. */
+	if (pScore < (pScoreBase + diMaxListCount)) {
+
+		/* Increase the score list length if it isn't full yet. */
+		if (pScorer->m_iScoreLen < diMaxListCount)
+			pScorer->m_iScoreLen++;
+
+		/* Push down all lower scores in the list to make room. */
+		for (pSrc = pScoreBase+pScorer->m_iScoreLen-2; pSrc >= pScore; pSrc--) {
+			pSrc[1].m_iScore = pSrc->m_iScore;
+			pSrc[1].m_cp     = pSrc->m_cp;
 		}
-		pScore++;
 
-		/* If we have a top score, lets register it. */
-		if (pScore < (pScoreBase + diMaxListCount)) {
+		/* Actually store our info in the list. */
+		pScore->m_iScore = iScore;
+		pScore->m_cp = cp;
+	}
+}
 
-			/* Increase the score list length if it isn't full yet. */
-			if (pScorer->m_iScoreLen < diMaxListCount)
-				pScorer->m_iScoreLen++;
+/* ----- StrokeScorerNextItem -----------------------------------------------*/
+/* Find the start of the entry after cp without scoring it.  An entry is
+ * an SJIS char followed by 7-bit stroke and filter chars, so the next one
+ * starts at the next char with the high order bit set.
+ */
 
-			/* Push down all lower scores in the list to make room. */
-			for (pSrc = pScoreBase+pScorer->m_iScoreLen-2; pSrc >= pScore; pSrc--) {
-				pSrc[1].m_iScore = pSrc->m_iScore;
-				pSrc[1].m_cp     = pSrc->m_cp;
-			}
+CharPtr StrokeScorerNextItem(CharPtr cp) {
+	if (*cp) cp++;				/* Skip over first half SJIS char. */
+	if (*cp) cp++;				/* Skip over second half SJIS char. */
+
+	while (*cp && !(*cp & 0x80))
+		cp++;
+
+	return cp;
+}
+
+#ifdef FOR_PILOT_COMPAT
+
+/* ----- StrokeScorerPart ---------------------------------------------------*/
+/* A run of consecutive candidates scored on one thread, into a top list
+ * of its own.
+ */
+
+typedef struct StrokeScorerPartStruct {
+	StrokeScorer m_scorer;		/* Copy of the scorer with its own lists. */
+	ScoreItem    m_scores[diMaxListCount];
+	char         m_path[diPathBufLen+1];
+	CharPtr*     m_cppItems;
+	Long         m_iCnt;
+	GThread*     m_thread;
+} StrokeScorerPart;
+
+static gpointer StrokeScorerPartThread(gpointer data) {
+	StrokeScorerPart *pPart = (StrokeScorerPart *) data;
+	ULong             iScore;
+	Long              i;
+
+	for (i = 0; i < pPart->m_iCnt; i++) {
+		StrokeScorerEvalItem(&pPart->m_scorer, pPart->m_cppItems[i], &iScore);
+		StrokeScorerAddScore(&pPart->m_scorer, pPart->m_cppItems[i], iScore);
+	}
+
+	return NULL;
+}
+
+/* ----- StrokeScorerProcessThreaded ----------------------------------------*/
+/* Score the candidates in consecutive runs, one per thread, and merge the
+ * top list of each run into the scorer in candidate order.  Since a score
+ * only ties behind the ones added before it, the merged list is the same
+ * one scoring every candidate in order gives.  Returns false without doing
+ * anything when there are too few candidates to be worth the threads.
+ */
+
+Boolean StrokeScorerProcessThreaded(StrokeScorer *pScorer, Long iMaxCnt) {
+	StrokeScorerPart *pParts;
+	CharPtr*          cppItems;
+	CharPtr           cp;
+	Long              iCnt, iStart, i;
+	UInt              iParts, iPart;
+	UInt              iProcessors;
+
+	/* Count the candidates first, as they are of varying length. */
+	iCnt = 0;
+	for (cp = pScorer->m_cpStrokeDic; *cp; cp = StrokeScorerNextItem(cp)) {
+		if (iMaxCnt >= 0 && iCnt >= iMaxCnt)
+			break;
+		iCnt++;
+	}
+
+#if GLIB_CHECK_VERSION(2,36,0)
+	iProcessors = g_get_num_processors();
+#else
+	iProcessors = 2;
+#endif
+
+	iParts = iCnt / diMinThreadItems;
+	if (iParts > iProcessors)
+		iParts = iProcessors;
+	if (iParts > diMaxScoreThreads)
+		iParts = diMaxScoreThreads;
+	if (iParts < 2)
+		return false;
+
+	cppItems = (CharPtr *) MemPtrNew(iCnt*sizeof(CharPtr));
+	pParts = (StrokeScorerPart *) MemPtrNew(iParts*sizeof(StrokeScorerPart));
+	if (!cppItems || !pParts) {
+		if (cppItems) MemPtrFree(cppItems);
+		if (pParts) MemPtrFree(pParts);
+		return false;
+	}
+
+	cp = pScorer->m_cpStrokeDic;
+	for (i = 0; i < iCnt; i++) {
+		cppItems[i] = cp;
+		cp = StrokeScorerNextItem(cp);
+	}
+
+	/* Hand each part an equal run of the candidates, in order. */
+	iStart = 0;
+	for (iPart = 0; iPart < iParts; iPart++) {
+		StrokeScorerPart *pPart = pParts + iPart;
+
+		pPart->m_scorer = *pScorer;
+		pPart->m_scorer.m_pScores = pPart->m_scores;
+		pPart->m_scorer.m_iScoreLen = 0;
+		pPart->m_scorer.m_cpPath = pPart->m_path;
+		pPart->m_cppItems = cppItems + iStart;
+		pPart->m_iCnt = (iCnt * (iPart + 1)) / iParts - iStart;
+		pPart->m_thread = NULL;
+		iStart += pPart->m_iCnt;
+	}
+
+	/* The first part is scored on this thread.  A part that doesn't get a
+	 * thread is scored here too, which only costs the time.
+	 */
+	for (iPart = 1; iPart < iParts; iPart++) {
+		pParts[iPart].m_thread = g_thread_try_new("kpengine-scorer",
+												  StrokeScorerPartThread,
+												  pParts + iPart, NULL);
+	}
+	StrokeScorerPartThread(pParts);
+
+	for (iPart = 1; iPart < iParts; iPart++) {
+		if (pParts[iPart].m_thread)
+			g_thread_join(pParts[iPart].m_thread);
+		else
+			StrokeScorerPartThread(pParts + iPart);
+	}
 
-			/* Actually store our info in the list. */
-			pScore->m_iScore = iScore;
-			pScore->m_cp = cp;
+	/* Merge in candidate order so ties resolve as in the serial loop. */
+	for (iPart = 0; iPart < iParts; iPart++) {
+		for (i = 0; i < (Long) pParts[iPart].m_scorer.m_iScoreLen; i++) {
+			StrokeScorerAddScore(pScorer, pParts[iPart].m_scores[i].m_cp,
+								 pParts[iPart].m_scores[i].m_iScore);
 		}
+	}
 
-	} /* for each stroke description... */
+	MemPtrFree(pParts);
+	MemPtrFree(cppItems);
 
-	if (cp)
-		return 1;				/* should be count remaining */
-	else
-		return 0;
+	return true;
 }
 
+#endif /*FOR_PILOT_COMPAT*/
+
 /* ----- StrokeScorerTopPicks -----------------------------------------------*/
 /* Return best diMaxListCount candidates processed so far */
 
@@ -80,6 +80,7 @@ lw_dictionary_sync_progress_cb (gdouble fraction, gpointer data)
     if (priv->progress != fraction)
     {
       priv->progress = fraction;
+      lw_dictionary_installer_sync_total_progress (dictionary);
       g_signal_emit (G_OBJECT (dictionary), klass->signalid[LW_DICTIONARY_CLASS_SIGNALID_PROGRESS_CHANGED], 0);    
     }
 
@@ -34,6 +34,7 @@
 #include <stdio.h>
 
 #include <glib.h>
+#include <glib/gstdio.h>
 
 #include <libwaei/gettext.h>
 #include <libwaei/libwaei.h>
@@ -713,6 +714,779 @@ lw_dictionary_installer_install (LwDictionary  *dictionary,
 }
 
 
+#define LW_DICTIONARY_INSTALLER_PROGRESS_SCALE (1.0 / LW_IO_PROGRESS_STEP)
+
+struct _LwDictionaryInstallerStream {
+  LwDictionary *dictionary;
+  const gchar *source;          //!< The url or local path being installed
+  const gchar *encodingname;    //!< The encoding of the source or NULL for UTF-8
+  GCancellable *cancellable;
+  LwIoPipe *downloaded;         //!< Raw bytes from the download stage
+  LwIoPipe *decompressed;       //!< Same as downloaded if the source isn't compressed
+  LwIoPipe *encoded;            //!< Same as decompressed if the source is already UTF-8
+  GError *download_error;
+  GError *decompress_error;
+  GError *encode_error;
+  gint progress;                //!< Download progress scaled by LW_DICTIONARY_INSTALLER_PROGRESS_SCALE
+};
+typedef struct _LwDictionaryInstallerStream LwDictionaryInstallerStream;
+
+
+static gint
+lw_dictionary_installer_stream_progress_cb (gdouble fraction, gpointer data)
+{
+    //Declarations
+    LwDictionaryInstallerStream *stream;
+
+    //Initializations
+    stream = data;
+
+    //Progress is handed to the installing thread which emits the signal
+    g_atomic_int_set (&stream->progress, (gint) (fraction * LW_DICTIONARY_INSTALLER_PROGRESS_SCALE));
+
+    return 0;
+}
+
+
+static void
+lw_dictionary_installer_stream_cancelled_cb (GCancellable *cancellable, gpointer data)
+{
+    //Declarations
+    LwDictionaryInstallerStream *stream;
+
+    //Initializations
+    stream = data;
+
+    lw_io_pipe_abort (stream->downloaded);
+    lw_io_pipe_abort (stream->decompressed);
+    lw_io_pipe_abort (stream->encoded);
+}
+
+
+static gpointer
+lw_dictionary_installer_download_thread (gpointer data)
+{
+    //Declarations
+    LwDictionaryInstallerStream *stream;
+    const gchar *name;
+
+    //Initializations
+    stream = data;
+    name = lw_dictionary_get_name (stream->dictionary);
+
+    lw_trace_begin (LW_TRACE_CATEGORY_INSTALL, "download", name);
+    lw_io_read_to_pipe (stream->source, stream->downloaded, lw_dictionary_installer_stream_progress_cb, stream, stream->cancellable, &stream->download_error);
+    lw_trace_end (LW_TRACE_CATEGORY_INSTALL, "download");
+
+    return NULL;
+}
+
+
+static gpointer
+lw_dictionary_installer_decompress_thread (gpointer data)
+{
+    //Declarations
+    LwDictionaryInstallerStream *stream;
+    const gchar *name;
+
+    //Initializations
+    stream = data;
+    name = lw_dictionary_get_name (stream->dictionary);
+
+    lw_trace_begin (LW_TRACE_CATEGORY_INSTALL, "decompress", name);
+    lw_io_gunzip_pipe (stream->downloaded, stream->decompressed, stream->cancellable, &stream->decompress_error);
+    lw_trace_end (LW_TRACE_CATEGORY_INSTALL, "decompress");
+
+    return NULL;
+}
+
+
+static gpointer
+lw_dictionary_installer_encode_thread (gpointer data)
+{
+    //Declarations
+    LwDictionaryInstallerStream *stream;
+    const gchar *name;
+
+    //Initializations
+    stream = data;
+    name = lw_dictionary_get_name (stream->dictionary);
+
+    lw_trace_begin (LW_TRACE_CATEGORY_INSTALL, "convert_encoding", name);
+    lw_io_convert_pipe_encoding (stream->decompressed, stream->encoded, stream->encodingname, "UTF-8", stream->cancellable, &stream->encode_error);
+    lw_trace_end (LW_TRACE_CATEGORY_INSTALL, "convert_encoding");
+
+    return NULL;
+}
+
+
+struct _LwDictionaryInstallerPatch {
+  const gchar *path;            //!< The installed file being updated
+  gchar *newpath;               //!< Where the patched file is written before it replaces the installed one
+  FILE *installed;              //!< Read alongside the new source until the first changed line
+  FILE *target;                 //!< NULL until a line differs from the installed file
+  GString *line;
+  glong offset;                 //!< Length of the unchanged start of the installed file
+  gboolean changed;             //!< Set once the patched file was written and differs from the installed one
+};
+typedef struct _LwDictionaryInstallerPatch LwDictionaryInstallerPatch;
+
+
+static void
+lw_dictionary_installer_patch_free (LwDictionaryInstallerPatch *patch)
+{
+    if (patch == NULL) return;
+
+    if (patch->installed != NULL) fclose (patch->installed); patch->installed = NULL;
+    if (patch->target != NULL) fclose (patch->target); patch->target = NULL;
+    if (patch->newpath != NULL) g_remove (patch->newpath);
+    if (patch->newpath != NULL) g_free (patch->newpath); patch->newpath = NULL;
+    if (patch->line != NULL) g_string_free (patch->line, TRUE); patch->line = NULL;
+
+    g_free (patch);
+}
+
+
+static LwDictionaryInstallerPatch*
+lw_dictionary_installer_patch_new (const gchar *PATH, GError **error)
+{
+    //Declarations
+    LwDictionaryInstallerPatch *patch;
+    GQuark quark;
+
+    //Initializations
+    patch = g_new0 (LwDictionaryInstallerPatch, 1);
+    patch->path = PATH;
+    patch->newpath = g_strjoin (".", PATH, "new", NULL);
+    patch->line = g_string_sized_new (LW_IO_MAX_FGETS_LINE);
+    patch->installed = g_fopen (PATH, "rb");
+
+    if (patch->installed == NULL)
+    {
+      quark = g_quark_from_string (LW_IO_ERROR);
+      if (error != NULL) *error = g_error_new (quark, LW_IO_READ_ERROR, gettext("Could not read %s"), PATH);
+      lw_dictionary_installer_patch_free (patch); patch = NULL;
+      return NULL;
+    }
+
+    setvbuf (patch->installed, NULL, _IOFBF, LW_IO_BUFFER_SIZE);
+
+    return patch;
+}
+
+
+//!
+//! @brief Copies up to length bytes from one file to another, or all of it if length is negative
+//!
+static gboolean
+lw_dictionary_installer_patch_copy (FILE *source, FILE *target, glong length, gchar *buffer)
+{
+    //Declarations
+    size_t chunk;
+    size_t wanted;
+
+    while (length != 0)
+    {
+      wanted = LW_IO_BUFFER_SIZE;
+      if (length > 0 && (glong) wanted > length) wanted = length;
+      chunk = fread(buffer, sizeof(gchar), wanted, source);
+      if (chunk == 0) break;
+      if (fwrite (buffer, sizeof(gchar), chunk, target) != chunk) return FALSE;
+      if (length > 0) length -= chunk;
+    }
+
+    return (!ferror (source) && length <= 0);
+}
+
+
+//!
+//! @brief Starts the patched file with the unchanged start of the installed
+//!        file.  The installed file isn't read any further after this.
+//!
+static gboolean
+lw_dictionary_installer_patch_open (LwDictionaryInstallerPatch  *patch,
+                                    GError                     **error)
+{
+    //Declarations
+    gchar *buffer;
+    gboolean success;
+    GQuark quark;
+
+    //Initializations
+    buffer = NULL;
+    success = TRUE;
+
+    patch->target = g_fopen (patch->newpath, "wb");
+    if (patch->target == NULL) success = FALSE;
+
+    if (success)
+    {
+      setvbuf (patch->target, NULL, _IOFBF, LW_IO_BUFFER_SIZE);
+      buffer = g_malloc (LW_IO_BUFFER_SIZE);
+      if (fseek (patch->installed, 0L, SEEK_SET) != 0) success = FALSE;
+      if (success) success = lw_dictionary_installer_patch_copy (patch->installed, patch->target, patch->offset, buffer);
+    }
+
+    if (patch->installed != NULL) fclose (patch->installed); patch->installed = NULL;
+
+    if (!success)
+    {
+      quark = g_quark_from_string (LW_IO_ERROR);
+      if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), patch->newpath);
+    }
+
+    //Cleanup
+    if (buffer != NULL) g_free (buffer); buffer = NULL;
+
+    return success;
+}
+
+
+//!
+//! @brief Compares a line of the new source with the next line of the installed
+//!        file.  Once a line differs, the patched file is started and this line
+//!        and every one after it are written straight to it.
+//!
+static gboolean
+lw_dictionary_installer_patch_line (LwDictionaryInstallerPatch  *patch,
+                                    const gchar                 *TEXT,
+                                    gsize                        length,
+                                    GError                     **error)
+{
+    //Declarations
+    gchar buffer[LW_IO_MAX_FGETS_LINE];
+    GQuark quark;
+
+    if (patch->target == NULL)
+    {
+      g_string_truncate (patch->line, 0);
+      while (fgets (buffer, LW_IO_MAX_FGETS_LINE, patch->installed) != NULL)
+      {
+        g_string_append (patch->line, buffer);
+        if (patch->line->str[patch->line->len - 1] == '\n') break;
+      }
+
+      if (patch->line->len == length && memcmp (patch->line->str, TEXT, length) == 0)
+      {
+        patch->offset += length;
+        return TRUE;
+      }
+
+      if (!lw_dictionary_installer_patch_open (patch, error)) return FALSE;
+    }
+
+    if (fwrite (TEXT, sizeof(gchar), length, patch->target) != length)
+    {
+      quark = g_quark_from_string (LW_IO_ERROR);
+      if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), patch->newpath);
+      return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Closes the patched file once the new source was read.  If the new
+//!        source was the start of the installed file, the patched file is that
+//!        start.  Nothing is written when nothing changed.
+//!
+static gboolean
+lw_dictionary_installer_patch_finish (LwDictionaryInstallerPatch  *patch,
+                                      GError                     **error)
+{
+    //Declarations
+    gboolean success;
+    GQuark quark;
+
+    //Initializations
+    success = TRUE;
+
+    if (patch->target == NULL)
+    {
+      //The new source matched the start of the installed file, so lines only went away if it goes on
+      if (fgetc (patch->installed) == EOF) return TRUE;
+      if (!lw_dictionary_installer_patch_open (patch, error)) return FALSE;
+    }
+
+    if (fclose (patch->target) != 0) success = FALSE;
+    patch->target = NULL;
+
+    patch->changed = success;
+
+    if (!success)
+    {
+      quark = g_quark_from_string (LW_IO_ERROR);
+      if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), patch->newpath);
+    }
+
+    return success;
+}
+
+
+//!
+//! @brief Moves the patched file written by lw_dictionary_installer_patch_finish
+//!        over the installed one
+//!
+static gboolean
+lw_dictionary_installer_patch_commit (LwDictionaryInstallerPatch  *patch,
+                                      GError                     **error)
+{
+    //Declarations
+    GQuark quark;
+
+    if (!patch->changed) return TRUE;
+
+    if (patch->installed != NULL) fclose (patch->installed); patch->installed = NULL;
+
+#ifdef G_OS_WIN32
+    g_remove (patch->path);
+#endif
+    if (g_rename (patch->newpath, patch->path) != 0)
+    {
+      quark = g_quark_from_string (LW_IO_ERROR);
+      if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), patch->path);
+      return FALSE;
+    }
+
+    patch->changed = FALSE;
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Writes a line or a whole chunk to the target files selected by mask,
+//!        opening them the first time they are written to.  When patches is
+//!        set the lines are compared with the installed files instead.
+//!
+static gboolean
+lw_dictionary_installer_write_targets (FILE                        **files,
+                                       LwDictionaryInstallerPatch  **patches,
+                                       gchar                       **pathlist,
+                                       guint                         mask,
+                                       const gchar                  *TEXT,
+                                       gsize                         length,
+                                       GError                      **error)
+{
+    //Declarations
+    GQuark quark;
+    gint i;
+
+    for (i = 0; pathlist[i] != NULL && mask != 0; i++, mask >>= 1)
+    {
+      if ((mask & 1) == 0) continue;
+
+      if (patches != NULL)
+      {
+        if (!lw_dictionary_installer_patch_line (patches[i], TEXT, length, error)) return FALSE;
+        continue;
+      }
+
+      if (files[i] == NULL) files[i] = g_fopen (pathlist[i], "wb");
+
+      if (files[i] == NULL || fwrite (TEXT, sizeof(gchar), length, files[i]) != length)
+      {
+        quark = g_quark_from_string (LW_IO_ERROR);
+        if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), pathlist[i]);
+        return FALSE;
+      }
+    }
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Drains the last pipe of a stream into the target files.  When the
+//!        dictionary classifies lines or the installed files are being patched
+//!        the chunks are split on newlines, otherwise they are written through
+//!        as they are.
+//!
+static gboolean
+lw_dictionary_installer_write_stream (LwDictionaryInstallerStream  *stream,
+                                      gint                          index,
+                                      FILE                        **files,
+                                      LwDictionaryInstallerPatch  **patches,
+                                      gchar                       **pathlist,
+                                      GError                      **error)
+{
+    //Declarations
+    LwDictionaryClass *klass;
+    GByteArray *chunk;
+    GString *line;
+    const gchar *start, *end, *newline;
+    gboolean success;
+    guint mask;
+
+    //Initializations
+    klass = LW_DICTIONARY_CLASS (G_OBJECT_GET_CLASS (stream->dictionary));
+    line = g_string_sized_new (LW_IO_MAX_FGETS_LINE);
+    success = TRUE;
+
+    while (success && (chunk = lw_io_pipe_pop (stream->encoded)) != NULL)
+    {
+      if (klass->installer_classify_line == NULL && patches == NULL)
+      {
+        success = lw_dictionary_installer_write_targets (files, patches, pathlist, (1 << index), (gchar*) chunk->data, chunk->len, error);
+      }
+      else
+      {
+        start = (gchar*) chunk->data;
+        end = start + chunk->len;
+
+        while (success && start < end)
+        {
+          newline = memchr (start, '\n', end - start);
+          if (newline == NULL)
+          {
+            g_string_append_len (line, start, end - start);
+            break;
+          }
+
+          g_string_append_len (line, start, newline - start + 1);
+          mask = (klass->installer_classify_line != NULL) ? klass->installer_classify_line (stream->dictionary, index, line->str) : (1 << index);
+          success = lw_dictionary_installer_write_targets (files, patches, pathlist, mask, line->str, line->len, error);
+          g_string_truncate (line, 0);
+          start = newline + 1;
+        }
+      }
+
+      g_byte_array_unref (chunk); chunk = NULL;
+
+      lw_dictionary_sync_progress_cb ((gdouble) g_atomic_int_get (&stream->progress) / LW_DICTIONARY_INSTALLER_PROGRESS_SCALE, stream->dictionary);
+    }
+
+    //The last line might not end in a newline
+    if (success && line->len > 0 && !lw_io_pipe_is_aborted (stream->encoded))
+    {
+      mask = (klass->installer_classify_line != NULL) ? klass->installer_classify_line (stream->dictionary, index, line->str) : (1 << index);
+      success = lw_dictionary_installer_write_targets (files, patches, pathlist, mask, line->str, line->len, error);
+    }
+
+    if (!success || lw_io_pipe_is_aborted (stream->encoded))
+    {
+      lw_io_pipe_abort (stream->encoded);
+      success = FALSE;
+    }
+
+    //Cleanup
+    g_string_free (line, TRUE); line = NULL;
+
+    return success;
+}
+
+
+//!
+//! @brief Runs the download, decompress and encoding conversion of one file as
+//!        threads connected by pipes, writing the result into the target files
+//!        or patching the installed ones
+//!
+static gboolean
+lw_dictionary_installer_stream_file (LwDictionary                 *dictionary,
+                                     gint                          index,
+                                     FILE                        **files,
+                                     LwDictionaryInstallerPatch  **patches,
+                                     gchar                       **pathlist,
+                                     GCancellable                 *cancellable,
+                                     GError                      **error)
+{
+    //Declarations
+    LwDictionaryPrivate *priv;
+    LwDictionaryInstallerStream stream;
+    GThread *download_thread;
+    GThread *decompress_thread;
+    GThread *encode_thread;
+    gulong handlerid;
+    gboolean compressed;
+    gboolean success;
+
+    //Initializations
+    priv = dictionary->priv;
+    memset(&stream, 0, sizeof(LwDictionaryInstallerStream));
+    stream.dictionary = dictionary;
+    stream.source = lw_dictionary_installer_get_downloadlist (dictionary)[index];
+    stream.cancellable = cancellable;
+    compressed = (g_str_has_suffix (stream.source, "gz") || g_str_has_suffix (stream.source, "gzip"));
+    if (priv->install->encoding != LW_ENCODING_UTF8)
+      stream.encodingname = lw_util_get_encodingname (priv->install->encoding);
+
+    stream.downloaded = lw_io_pipe_new (LW_IO_PIPE_CAPACITY);
+    stream.decompressed = (compressed) ? lw_io_pipe_new (LW_IO_PIPE_CAPACITY) : stream.downloaded;
+    stream.encoded = (stream.encodingname != NULL) ? lw_io_pipe_new (LW_IO_PIPE_CAPACITY) : stream.decompressed;
+    download_thread = decompress_thread = encode_thread = NULL;
+    handlerid = 0;
+
+    if (cancellable != NULL)
+      handlerid = g_cancellable_connect (cancellable, G_CALLBACK (lw_dictionary_installer_stream_cancelled_cb), &stream, NULL);
+
+    download_thread = g_thread_try_new ("libwaei-install-download", lw_dictionary_installer_download_thread, &stream, error);
+    if (download_thread != NULL && compressed)
+      decompress_thread = g_thread_try_new ("libwaei-install-decompress", lw_dictionary_installer_decompress_thread, &stream, error);
+    if (download_thread != NULL && (decompress_thread != NULL || !compressed) && stream.encodingname != NULL)
+      encode_thread = g_thread_try_new ("libwaei-install-encode", lw_dictionary_installer_encode_thread, &stream, error);
+
+    if (error != NULL && *error != NULL)
+    {
+      //A thread couldn't be started, so stop the ones that were
+      lw_dictionary_installer_stream_cancelled_cb (cancellable, &stream);
+      success = FALSE;
+    }
+    else
+    {
+      lw_trace_begin (LW_TRACE_CATEGORY_INSTALL, "write", lw_dictionary_get_name (dictionary));
+      success = lw_dictionary_installer_write_stream (&stream, index, files, patches, pathlist, error);
+      lw_trace_end (LW_TRACE_CATEGORY_INSTALL, "write");
+    }
+
+    if (download_thread != NULL) g_thread_join (download_thread); download_thread = NULL;
+    if (decompress_thread != NULL) g_thread_join (decompress_thread); decompress_thread = NULL;
+    if (encode_thread != NULL) g_thread_join (encode_thread); encode_thread = NULL;
+
+    if (handlerid != 0) g_cancellable_disconnect (cancellable, handlerid); handlerid = 0;
+
+    //Report the error of the earliest stage that failed
+    if (error != NULL && *error == NULL)
+    {
+      if (stream.download_error != NULL) { *error = stream.download_error; stream.download_error = NULL; }
+      else if (stream.decompress_error != NULL) { *error = stream.decompress_error; stream.decompress_error = NULL; }
+      else if (stream.encode_error != NULL) { *error = stream.encode_error; stream.encode_error = NULL; }
+    }
+    if (stream.download_error != NULL) g_error_free (stream.download_error); stream.download_error = NULL;
+    if (stream.decompress_error != NULL) g_error_free (stream.decompress_error); stream.decompress_error = NULL;
+    if (stream.encode_error != NULL) g_error_free (stream.encode_error); stream.encode_error = NULL;
+
+    //Cleanup
+    if (stream.encoded != stream.decompressed) lw_io_pipe_free (stream.encoded); stream.encoded = NULL;
+    if (stream.decompressed != stream.downloaded) lw_io_pipe_free (stream.decompressed); stream.decompressed = NULL;
+    lw_io_pipe_free (stream.downloaded); stream.downloaded = NULL;
+
+    return (success && (error == NULL || *error == NULL));
+}
+
+
+//!
+//! @brief Installs a dictionary by streaming each download through the
+//!        decompress and encoding conversion stages on their own threads.
+//!        Only the installed files are written, unless the dictionary has a
+//!        postprocess step that can't work line by line.  Then the UTF-8 text
+//!        is written to the cache once and postprocessed from there.
+//! @param dictionary The LwDictionary object to install
+//! @param cancellable A GCancellable to stop the install with or NULL
+//! @param error A pointer to a GError object to pass errors to or NULL.
+//! @see lw_dictionary_install
+//!
+gboolean
+lw_dictionary_installer_stream (LwDictionary  *dictionary,
+                                GCancellable  *cancellable,
+                                GError       **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+    g_return_val_if_fail (dictionary != NULL, FALSE);
+
+    //Declarations
+    LwDictionaryClass *klass;
+    LwDictionaryPrivate *priv;
+    gchar **downloadlist;
+    gchar **installedlist;
+    gchar **partlist;
+    gchar **postprocesslist;
+    gchar **pathlist;
+    FILE **files;
+    gboolean postprocess;
+    gboolean success;
+    gint total;
+    gint i;
+
+    //Initializations
+    klass = LW_DICTIONARY_CLASS (G_OBJECT_GET_CLASS (dictionary));
+    priv = dictionary->priv;
+    downloadlist = lw_dictionary_installer_get_downloadlist (dictionary);
+    installedlist = lw_dictionary_installer_get_installedlist (dictionary);
+    postprocesslist = lw_dictionary_installer_get_postprocesslist (dictionary);
+    if (downloadlist == NULL || installedlist == NULL || postprocesslist == NULL) return FALSE;
+    postprocess = (klass->installer_classify_line == NULL && klass->installer_postprocess != NULL);
+    success = TRUE;
+
+    //Installed files are written next to their final names until everything succeeded
+    total = g_strv_length (installedlist);
+    partlist = g_new0 (gchar*, total + 1);
+    for (i = 0; i < total; i++) partlist[i] = g_strjoin (".", installedlist[i], "part", NULL);
+
+    pathlist = (postprocess) ? postprocesslist : partlist;
+    files = g_new0 (FILE*, g_strv_length (pathlist) + 1);
+
+    if (g_cancellable_is_cancelled (cancellable)) success = FALSE;
+
+    priv->install->status = LW_DICTIONARY_INSTALLER_STATUS_DOWNLOADING;
+    priv->install->index = 0;
+
+    for (i = 0; success && downloadlist[i] != NULL; i++)
+    {
+      success = lw_dictionary_installer_stream_file (dictionary, i, files, NULL, pathlist, cancellable, error);
+      priv->install->index++;
+    }
+
+    for (i = 0; pathlist[i] != NULL; i++)
+    {
+      if (files[i] != NULL && fclose (files[i]) != 0) success = FALSE;
+      files[i] = NULL;
+    }
+
+    //Dictionaries that merge whole files still need the old postprocess step
+    if (success && postprocess)
+    {
+      priv->install->status = LW_DICTIONARY_INSTALLER_STATUS_POSTPROCESSING;
+      priv->install->index = 0;
+      lw_trace_begin (LW_TRACE_CATEGORY_INSTALL, "postprocess", lw_dictionary_get_name (dictionary));
+      success = klass->installer_postprocess (dictionary, postprocesslist, partlist, lw_dictionary_sync_progress_cb, dictionary, cancellable, error);
+      lw_trace_end (LW_TRACE_CATEGORY_INSTALL, "postprocess");
+      priv->install->index++;
+    }
+    if (postprocess)
+    {
+      for (i = 0; postprocesslist[i] != NULL; i++) g_remove (postprocesslist[i]);
+    }
+
+    if (g_cancellable_is_cancelled (cancellable)) success = FALSE;
+
+    priv->install->status = LW_DICTIONARY_INSTALLER_STATUS_FINISHING;
+
+    for (i = 0; partlist[i] != NULL; i++)
+    {
+      if (success && g_file_test (partlist[i], G_FILE_TEST_IS_REGULAR))
+      {
+        g_remove (installedlist[i]);
+        if (g_rename (partlist[i], installedlist[i]) != 0) success = FALSE;
+      }
+      g_remove (partlist[i]);
+    }
+
+    if (success && (error == NULL || *error == NULL))
+      lw_dictionary_installer_set_status (dictionary, LW_DICTIONARY_INSTALLER_STATUS_INSTALLED);
+    else
+      lw_dictionary_installer_set_status (dictionary, LW_DICTIONARY_INSTALLER_STATUS_UNINSTALLED);
+
+    lw_dictionary_sync_progress_cb (1.0, dictionary);
+
+    //Cleanup
+    g_free (files); files = NULL;
+    g_strfreev (partlist); partlist = NULL;
+
+    return (success && (error == NULL || *error == NULL));
+}
+
+
+//!
+//! @brief Updates an installed dictionary from its sources, which can be local
+//!        paths.  The new text is streamed like an install and compared line by
+//!        line with the installed files.  Files that didn't change aren't
+//!        written.  A changed file is written once, next to the installed one,
+//!        and every file of the dictionary is written before they are renamed
+//!        over the installed ones.  Dictionaries that postprocess whole files
+//!        together are reinstalled instead.
+//! @param dictionary The installed LwDictionary object to update
+//! @param cancellable A GCancellable to stop the update with or NULL
+//! @param error A pointer to a GError object to pass errors to or NULL.
+//! @see lw_dictionary_update
+//!
+gboolean
+lw_dictionary_installer_update (LwDictionary  *dictionary,
+                                GCancellable  *cancellable,
+                                GError       **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return FALSE;
+    g_return_val_if_fail (dictionary != NULL, FALSE);
+
+    //Declarations
+    LwDictionaryClass *klass;
+    LwDictionaryPrivate *priv;
+    LwDictionaryInstallerPatch **patches;
+    LwDictionaryInstallerStatus status;
+    gchar **downloadlist;
+    gchar **installedlist;
+    gboolean success;
+    GQuark quark;
+    gint total;
+    gint i;
+
+    //Initializations
+    klass = LW_DICTIONARY_CLASS (G_OBJECT_GET_CLASS (dictionary));
+    priv = dictionary->priv;
+    downloadlist = lw_dictionary_installer_get_downloadlist (dictionary);
+    installedlist = lw_dictionary_installer_get_installedlist (dictionary);
+    if (downloadlist == NULL || installedlist == NULL)
+    {
+      quark = g_quark_from_string (LW_IO_ERROR);
+      if (error != NULL) *error = g_error_new (quark, LW_IO_READ_ERROR, gettext("%s has no source to update from"), lw_dictionary_get_name (dictionary));
+      return FALSE;
+    }
+    status = priv->install->status;
+
+    if (klass->installer_classify_line == NULL && klass->installer_postprocess != NULL)
+      return lw_dictionary_installer_stream (dictionary, cancellable, error);
+
+    total = g_strv_length (installedlist);
+    patches = g_new0 (LwDictionaryInstallerPatch*, total + 1);
+    success = TRUE;
+
+    for (i = 0; success && i < total; i++)
+    {
+      patches[i] = lw_dictionary_installer_patch_new (installedlist[i], error);
+      success = (patches[i] != NULL);
+    }
+
+    if (g_cancellable_is_cancelled (cancellable)) success = FALSE;
+
+    priv->install->status = LW_DICTIONARY_INSTALLER_STATUS_DOWNLOADING;
+    priv->install->index = 0;
+
+    for (i = 0; success && downloadlist[i] != NULL; i++)
+    {
+      success = lw_dictionary_installer_stream_file (dictionary, i, NULL, patches, installedlist, cancellable, error);
+      priv->install->index++;
+    }
+
+    if (g_cancellable_is_cancelled (cancellable)) success = FALSE;
+
+    priv->install->status = LW_DICTIONARY_INSTALLER_STATUS_FINISHING;
+
+    //Every file is written before any installed one is replaced, so split dictionaries stay consistent
+    lw_trace_begin (LW_TRACE_CATEGORY_INSTALL, "patch", lw_dictionary_get_name (dictionary));
+    for (i = 0; success && i < total; i++)
+    {
+      success = lw_dictionary_installer_patch_finish (patches[i], error);
+    }
+    for (i = 0; success && i < total; i++)
+    {
+      success = lw_dictionary_installer_patch_commit (patches[i], error);
+    }
+    lw_trace_end (LW_TRACE_CATEGORY_INSTALL, "patch");
+
+    //The cached length is read again from the patched file
+    priv->length = 0;
+
+    if (success && (error == NULL || *error == NULL))
+    {
+      lw_dictionary_installer_set_status (dictionary, LW_DICTIONARY_INSTALLER_STATUS_INSTALLED);
+      lw_dictionary_sync_progress_cb (1.0, dictionary);
+    }
+    else
+    {
+      //The installed files are left as they were before the update
+      lw_dictionary_installer_set_status (dictionary, status);
+    }
+
+    //Cleanup
+    for (i = 0; i < total; i++) lw_dictionary_installer_patch_free (patches[i]);
+    g_free (patches); patches = NULL;
+
+    return (success && (error == NULL || *error == NULL));
+}
+
+
 //!
 //! @brief removes temporary files created by installation in the dictionary cache folder
 //! @param dictionary The LwDictionary object to use to clean the files.
@@ -870,7 +1644,7 @@ lw_dictionary_installer_get_stage_progress (LwDictionary *dictionary)
         break;
     }
 
-    final = (gdouble) g_strv_length (list);
+    if (list != NULL) final = (gdouble) g_strv_length (list);
     current = (gdouble) index + fraction;
     if (final == 0.0)
       fraction = 0.0;
@@ -882,30 +1656,32 @@ lw_dictionary_installer_get_stage_progress (LwDictionary *dictionary)
 
 
 //!
-//! @brief Gets the total possible progress for the LwDictionary.  It should be
-//!        divided by the current progress to get the appropriate fraction
+//! @brief Works out how far along the whole install of a LwDictionary is.  The
+//!        download stage streams through decompression and encoding conversion
+//!        so it carries their weight, and postprocessing only counts for
+//!        dictionaries that still postprocess after streaming.
 //! @param dictionary The LwDictInfo object to get the total progress of
-//! @param fraction The fraction progress of the current process.
 //!
-gdouble 
-lw_dictionary_installer_get_total_progress (LwDictionary *dictionary)
+static gdouble 
+lw_dictionary_installer_compute_total_progress (LwDictionary *dictionary)
 {
     //Declarations
-		LwDictionaryPrivate *priv;
+    LwDictionaryClass *klass;
     LwDictionaryInstallerStatus status;
     gdouble current;
     gdouble final;
-    gdouble fraction;
     gdouble temp;
     gint i;
     gchar **list;
+    const gdouble DOWNLOAD_WEIGHT = 3.0;
 
     //Definitions
-		priv = dictionary->priv;
+    klass = LW_DICTIONARY_CLASS (G_OBJECT_GET_CLASS (dictionary));
     status = lw_dictionary_installer_get_status (dictionary);
     current = final = 0.0;
-    fraction = priv->progress;
-    const gdouble DOWNLOAD_WEIGHT = 3.0;
+
+    if (status == LW_DICTIONARY_INSTALLER_STATUS_UNINSTALLED) return 0.0;
+    if (status == LW_DICTIONARY_INSTALLER_STATUS_INSTALLED) return 1.0;
 
     for (i = 0; i < TOTAL_LW_DICTIONARY_INSTALLER_STATUSES; i++)
     {
@@ -913,43 +1689,73 @@ lw_dictionary_installer_get_total_progress (LwDictionary *dictionary)
       {
         case LW_DICTIONARY_INSTALLER_STATUS_DOWNLOADING:
           list = lw_dictionary_installer_get_downloadlist (dictionary);
-          break;
-        case LW_DICTIONARY_INSTALLER_STATUS_DECOMPRESSING:
-          list = lw_dictionary_installer_get_encodelist (dictionary);
-          break;
-        case LW_DICTIONARY_INSTALLER_STATUS_ENCODING:
-          list = lw_dictionary_installer_get_postprocesslist (dictionary);
+          temp = (gdouble) g_strv_length (list) * DOWNLOAD_WEIGHT;
           break;
         case LW_DICTIONARY_INSTALLER_STATUS_POSTPROCESSING:
           list = lw_dictionary_installer_get_installlist (dictionary);
-          break;
-        case LW_DICTIONARY_INSTALLER_STATUS_FINISHING:
-          list = lw_dictionary_installer_get_installedlist (dictionary);
+          if (klass->installer_classify_line == NULL && klass->installer_postprocess != NULL)
+            temp = (gdouble) g_strv_length (list);
+          else
+            temp = 0.0;
           break;
         default:
+          temp = 0.0;
           break;
       }
-      if (i == LW_DICTIONARY_INSTALLER_STATUS_DOWNLOADING)
-        temp = (gdouble) g_strv_length (list) * DOWNLOAD_WEIGHT;
-      else
-        temp= (gdouble) g_strv_length (list);
 
       final += temp;
       if (i < status) current += temp;
+      if (i == status) current += temp * lw_dictionary_installer_get_stage_progress (dictionary);
     }
 
-    temp = lw_dictionary_installer_get_stage_progress (dictionary);
-    if (i == LW_DICTIONARY_INSTALLER_STATUS_DOWNLOADING)
-      current += temp * DOWNLOAD_WEIGHT;
-    else
-      current += temp;
-
     if (final == 0.0)
-      fraction = 0.0;
+      return 0.0;
     else
-      fraction = current / final;
+      return current / final;
+}
 
-    return fraction;
+
+//!
+//! @brief Recomputes the cached total progress of a LwDictionary.  This is called
+//!        on the installing thread whenever the progress changes.
+//! @param dictionary The LwDictionary being installed
+//!
+void
+lw_dictionary_installer_sync_total_progress (LwDictionary *dictionary)
+{
+    //Sanity checks
+    g_return_if_fail (dictionary != NULL);
+
+    //Declarations
+    gdouble fraction;
+
+    //Initializations
+    fraction = lw_dictionary_installer_compute_total_progress (dictionary);
+
+    g_atomic_int_set (&dictionary->priv->install->total_progress, (gint) (fraction * LW_DICTIONARY_INSTALLER_TOTAL_PROGRESS_SCALE));
+}
+
+
+//!
+//! @brief Gets the progress of the whole install of a LwDictionary.  The value
+//!        is cached by the installing thread, so it is safe to poll from other
+//!        threads such as an interface timeout.
+//! @param dictionary The LwDictInfo object to get the total progress of
+//! @returns A fraction between 0.0 and 1.0
+//!
+gdouble 
+lw_dictionary_installer_get_total_progress (LwDictionary *dictionary)
+{
+    //Sanity checks
+    g_return_val_if_fail (dictionary != NULL, 0.0);
+
+    //Declarations
+		LwDictionaryPrivate *priv;
+
+    //Initializations
+		priv = dictionary->priv;
+
+    return (gdouble) g_atomic_int_get (&priv->install->total_progress) / LW_DICTIONARY_INSTALLER_TOTAL_PROGRESS_SCALE;
 }
 
 
@@ -986,6 +1792,7 @@ lw_dictionary_installer_set_status (LwDictionary *dictionary, LwDictionaryInstal
     install = priv->install;
 
     install->status = status;
+    lw_dictionary_installer_sync_total_progress (dictionary);
 }
 
 
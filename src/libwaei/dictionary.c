@@ -32,8 +32,10 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <sys/stat.h>
 
 #include <glib.h>
+#include <glib/gstdio.h>
 
 #include <libwaei/gettext.h>
 #include <libwaei/libwaei.h>
@@ -318,6 +320,7 @@ lw_dictionary_uninstall (LwDictionary *dictionary, LwIoProgressCallback cb, GErr
     if (uri != NULL)
     {
       lw_io_remove (uri, NULL, error);
+      lw_dictionary_write_manifest (NULL);
       if (cb != NULL) cb (1.0, dictionary);
 
       g_free (uri); uri = NULL;
@@ -437,12 +440,20 @@ lw_dictionary_parse_query (LwDictionary *dictionary, LwQuery *query, const gchar
 
     g_return_val_if_fail (klass->parse_query != NULL, FALSE);
 
+    gboolean parsed;
+
     if (query->text != NULL) g_free (query->text);
     query->text = g_strdup (TEXT);
 
+    lw_trace_begin (LW_TRACE_CATEGORY_SEARCH, "parse_query", TEXT);
+
     lw_query_init_tokens (query);
 
-    return klass->parse_query (dictionary, query, TEXT, error);
+    parsed = klass->parse_query (dictionary, query, TEXT, error);
+
+    lw_trace_end (LW_TRACE_CATEGORY_SEARCH, "parse_query");
+
+    return parsed;
 }
 
 
@@ -607,6 +618,7 @@ lw_dictionary_build_id (LwDictionary *dictionary)
 //! @see lw_installdictionary_convert_encoding
 //! @see lw_installdictionary_postprocess
 //! @see lw_installdictionary_install
+//! @see lw_dictionary_installer_stream
 //!
 gboolean 
 lw_dictionary_install (LwDictionary *dictionary, GCancellable *cancellable, GError **error)
@@ -617,17 +629,50 @@ lw_dictionary_install (LwDictionary *dictionary, GCancellable *cancellable, GErr
     g_assert (dictionary->priv->install != NULL);
     if (error != NULL && *error != NULL) return FALSE;
 
-    lw_dictionary_installer_download (dictionary, cancellable, error);
-    lw_dictionary_installer_decompress (dictionary, cancellable, error);
-    lw_dictionary_installer_convert_encoding (dictionary, cancellable, error);
-    lw_dictionary_installer_postprocess (dictionary, cancellable, error);
-    lw_dictionary_installer_install (dictionary, cancellable, error);
+    //Declarations
+    gboolean success;
+
+    success = lw_dictionary_installer_stream (dictionary, cancellable, error);
     lw_dictionary_installer_clean (dictionary, cancellable);
+    lw_dictionary_write_manifest (NULL);
 
-    return (*error == NULL);
+    lw_trace_flush ();
+
+    return success;
 }
 
 
+
+//!
+//! @brief Updates an installed LwDictionary from its sources, writing only the
+//!        parts of the installed files that changed.
+//! @param dictionary The LwDictionary object to update.  Its installer sources
+//!                   can be set to local files.
+//! @param cancellable A GCancellable to stop the update with or NULL
+//! @param error A pointer to a GError object to pass errors to or NULL.
+//! @see lw_dictionary_installer_update
+//!
+gboolean 
+lw_dictionary_update (LwDictionary *dictionary, GCancellable *cancellable, GError **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (dictionary != NULL, FALSE);
+    g_return_val_if_fail (dictionary->priv != NULL, FALSE);
+    g_assert (dictionary->priv->install != NULL);
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    gboolean success;
+
+    success = lw_dictionary_installer_update (dictionary, cancellable, error);
+    lw_dictionary_installer_clean (dictionary, cancellable);
+    lw_dictionary_write_manifest (NULL);
+
+    lw_trace_flush ();
+
+    return success;
+}
+
 gboolean
 lw_dictionary_is_selected (LwDictionary *dictionary)
 {
@@ -660,75 +705,418 @@ lw_dictionary_set_selected (LwDictionary *dictionary, gboolean selected)
 }
 
 
-gchar**
-lw_dictionary_get_installed_idlist (GType type_filter)
+static GMutex _manifest_mutex;
+
+
+static GType*
+lw_dictionary_get_installable_typelist ()
 {
     //Declarations
-    GType* childlist;
-    GType *childiter;
+    GType *typelist;
 
-    const gchar* filename;
-    gchar *directorypath;
-    GDir *directory;
+    typelist = g_new (GType, 5);
+    typelist[0] = lw_edictionary_get_type ();
+    typelist[1] = lw_kanjidictionary_get_type ();
+    typelist[2] = lw_exampledictionary_get_type ();
+    typelist[3] = lw_unknowndictionary_get_type ();
+    typelist[4] = 0;
 
-    gchar **idlist;
-    gchar **iditer;
+    return typelist;
+}
 
-    gint length;
 
-    childiter = childlist = g_new (GType, 5);
-    childlist[0] = lw_edictionary_get_type ();
-    childlist[1] = lw_kanjidictionary_get_type ();
-    childlist[2] = lw_exampledictionary_get_type ();
-    childlist[3] = lw_unknowndictionary_get_type ();
-    childlist[4] = 0;
+//!
+//! @brief Builds the manifest group name of a dictionary id.  Group names of
+//!        a GKeyFile can't hold '[' or ']', which filenames can.
+//! @returns A newly allocated string that should be freed with g_free
+//!
+static gchar*
+lw_dictionary_manifest_group_from_id (const gchar *ID)
+{
+    return g_uri_escape_string (ID, "/", TRUE);
+}
+
 
-    if (childiter == NULL) return NULL;
+static gint64
+lw_dictionary_get_mtime (const gchar *PATH)
+{
+    //Declarations
+    GStatBuf info;
 
-    length = 0;
+    if (g_stat (PATH, &info) != 0) return 0;
+
+    return (gint64) info.st_mtime;
+}
 
-    //Find out how long the array has to be
-    while (*childiter != 0)
+
+//!
+//! @brief Scans the dictionary folders once each and records the installed
+//!        dictionaries.  The modification time of every folder is kept too,
+//!        since it changes whenever a dictionary is added, removed or renamed.
+//! @returns A GKeyFile that should be freed with g_key_file_free
+//!
+static GKeyFile*
+lw_dictionary_scan_manifest ()
+{
+    //Declarations
+    GKeyFile *manifest;
+    GType *typelist;
+    GType *typeiter;
+    GDir *directory;
+    const gchar *FILENAME;
+    gchar *basepath;
+    gchar *directoryname;
+    gchar *directorypath;
+    gchar *path;
+    gchar *id;
+    gchar *group;
+    GStatBuf info;
+
+    //Initializations
+    manifest = g_key_file_new ();
+    typelist = lw_dictionary_get_installable_typelist ();
+    basepath = lw_util_build_filename (LW_PATH_DICTIONARY, NULL);
+
+    g_key_file_set_integer (manifest, LW_DICTIONARY_MANIFEST_GROUP, "Version", LW_DICTIONARY_MANIFEST_VERSION);
+
+    for (typeiter = typelist; *typeiter != 0; typeiter++)
     {
-      directorypath = lw_dictionary_get_directory (*childiter);
+      directoryname = lw_dictionary_get_directoryname (*typeiter);
+      if (directoryname == NULL) continue;
+      directorypath = g_build_filename (basepath, directoryname, NULL);
+
+      g_key_file_set_int64 (manifest, LW_DICTIONARY_MANIFEST_GROUP, directoryname, lw_dictionary_get_mtime (directorypath));
+
       directory = g_dir_open (directorypath, 0, NULL);
       if (directory != NULL)
       {
-        while ((filename = g_dir_read_name (directory)) != NULL)
+        while ((FILENAME = g_dir_read_name (directory)) != NULL)
         {
-          length++;
+          if (g_str_has_suffix (FILENAME, ".part") || g_str_has_suffix (FILENAME, ".new")) continue;
+
+          path = g_build_filename (directorypath, FILENAME, NULL);
+          if (g_stat (path, &info) == 0 && S_ISREG (info.st_mode))
+          {
+            id = lw_dictionary_build_id_from_type (*typeiter, FILENAME);
+            group = lw_dictionary_manifest_group_from_id (id);
+            g_key_file_set_string (manifest, group, "Type", g_type_name (*typeiter));
+            g_key_file_set_string (manifest, group, "Filename", FILENAME);
+            g_key_file_set_uint64 (manifest, group, "Size", (guint64) info.st_size);
+            g_key_file_set_int64 (manifest, group, "Mtime", (gint64) info.st_mtime);
+            g_key_file_set_integer (manifest, group, "Version", LW_DICTIONARY_INSTALLER_VERSION);
+            g_free (group); group = NULL;
+            g_free (id); id = NULL;
+          }
+          g_free (path); path = NULL;
         }
         g_dir_close (directory); directory = NULL;
       }
+
       g_free (directorypath); directorypath = NULL;
-      childiter++;
+      g_free (directoryname); directoryname = NULL;
     }
 
-    iditer = idlist = g_new0 (gchar*, length + 1);
-    childiter = childlist;
+    //Cleanup
+    g_free (basepath); basepath = NULL;
+    g_free (typelist); typelist = NULL;
 
-    //Find out how long the array has to be
-    while (*childiter != 0)
+    return manifest;
+}
+
+
+//!
+//! @brief Checks that a dictionary of the manifest was installed by this
+//!        version of the installer and has everything needed to load it.
+//!        Only the manifest is read, so this costs nothing per file.
+//!
+static gboolean
+lw_dictionary_manifest_entry_is_current (GKeyFile *manifest, const gchar *GROUP)
+{
+    //Declarations
+    GError *error;
+    gchar *typename;
+    gchar *filename;
+    gint version;
+    gboolean current;
+
+    //Initializations
+    error = NULL;
+    typename = g_key_file_get_string (manifest, GROUP, "Type", NULL);
+    filename = g_key_file_get_string (manifest, GROUP, "Filename", NULL);
+    version = g_key_file_get_integer (manifest, GROUP, "Version", &error);
+    current = (error == NULL && version == LW_DICTIONARY_INSTALLER_VERSION && filename != NULL);
+    if (current) current = (typename != NULL && g_type_from_name (typename) != G_TYPE_INVALID);
+    if (current) current = g_key_file_has_key (manifest, GROUP, "Size", NULL);
+
+    //Cleanup
+    if (error != NULL) g_error_free (error); error = NULL;
+    if (typename != NULL) g_free (typename); typename = NULL;
+    if (filename != NULL) g_free (filename); filename = NULL;
+
+    return current;
+}
+
+
+//!
+//! @brief Checks a manifest against the dictionary folders without looking
+//!        at the dictionaries themselves, so it costs the same however many
+//!        are installed.  Installing, updating and uninstalling through
+//!        LwDictionary write the manifest again.
+//!
+static gboolean
+lw_dictionary_manifest_is_current (GKeyFile *manifest)
+{
+    //Declarations
+    GType *typelist;
+    GType *typeiter;
+    GError *error;
+    gchar **grouplist;
+    gchar *basepath;
+    gchar *directoryname;
+    gchar *directorypath;
+    gint64 recorded;
+    gint64 mtime;
+    gboolean current;
+    gint i;
+
+    //Initializations
+    error = NULL;
+    current = (g_key_file_get_integer (manifest, LW_DICTIONARY_MANIFEST_GROUP, "Version", &error) == LW_DICTIONARY_MANIFEST_VERSION);
+    if (error != NULL) current = FALSE;
+    if (current == FALSE) goto errored;
+
+    typelist = lw_dictionary_get_installable_typelist ();
+    basepath = lw_util_build_filename (LW_PATH_DICTIONARY, NULL);
+
+    for (typeiter = typelist; current && *typeiter != 0; typeiter++)
     {
-      directorypath = lw_dictionary_get_directory (*childiter);
-      directory = g_dir_open (directorypath, 0, NULL);
-      if (directory != NULL)
+      directoryname = lw_dictionary_get_directoryname (*typeiter);
+      if (directoryname == NULL) continue;
+      directorypath = g_build_filename (basepath, directoryname, NULL);
+
+      mtime = lw_dictionary_get_mtime (directorypath);
+      recorded = g_key_file_get_int64 (manifest, LW_DICTIONARY_MANIFEST_GROUP, directoryname, &error);
+      if (error != NULL || recorded != mtime) current = FALSE;
+
+      g_free (directorypath); directorypath = NULL;
+      g_free (directoryname); directoryname = NULL;
+    }
+
+    grouplist = g_key_file_get_groups (manifest, NULL);
+    for (i = 0; current && grouplist[i] != NULL; i++)
+    {
+      if (strcmp (grouplist[i], LW_DICTIONARY_MANIFEST_GROUP) == 0) continue;
+      current = lw_dictionary_manifest_entry_is_current (manifest, grouplist[i]);
+    }
+    g_strfreev (grouplist); grouplist = NULL;
+
+    g_free (basepath); basepath = NULL;
+    g_free (typelist); typelist = NULL;
+
+errored:
+    if (error != NULL) g_error_free (error); error = NULL;
+
+    return current;
+}
+
+
+static gboolean
+lw_dictionary_save_manifest (GKeyFile *manifest, GError **error)
+{
+    //Declarations
+    gchar *path;
+    gchar *text;
+    gsize length;
+    gboolean success;
+
+    //Initializations
+    path = lw_util_build_filename (LW_PATH_DICTIONARY, LW_DICTIONARY_MANIFEST_FILENAME);
+    text = g_key_file_to_data (manifest, &length, NULL);
+
+    success = (text != NULL && g_file_set_contents (path, text, length, error));
+
+    //Cleanup
+    if (text != NULL) g_free (text); text = NULL;
+    if (path != NULL) g_free (path); path = NULL;
+
+    return success;
+}
+
+
+//!
+//! @brief Rescans the dictionary folders and saves the manifest read at startup.
+//!        This is called after dictionaries are installed, updated or uninstalled.
+//! @param error A pointer to a GError object to pass errors to or NULL.
+//! @see lw_dictionary_load_manifest
+//!
+gboolean
+lw_dictionary_write_manifest (GError **error)
+{
+    //Sanity checks
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    GKeyFile *manifest;
+    gboolean success;
+
+    g_mutex_lock (&_manifest_mutex);
+    manifest = lw_dictionary_scan_manifest ();
+    success = lw_dictionary_save_manifest (manifest, error);
+    g_mutex_unlock (&_manifest_mutex);
+
+    //Cleanup
+    g_key_file_free (manifest); manifest = NULL;
+
+    return success;
+}
+
+
+//!
+//! @brief Reads the manifest of installed dictionaries.  Groups other than
+//!        LW_DICTIONARY_MANIFEST_GROUP are dictionary ids, escaped as in a
+//!        URI, with their Type, Filename, Size, Mtime and Version.  A missing
+//!        or stale manifest is rebuilt from the dictionary folders.
+//! @returns A GKeyFile that should be freed with g_key_file_free
+//!
+GKeyFile*
+lw_dictionary_load_manifest ()
+{
+    //Declarations
+    GKeyFile *manifest;
+    gchar *path;
+    gboolean current;
+
+    //Initializations
+    manifest = g_key_file_new ();
+    path = lw_util_build_filename (LW_PATH_DICTIONARY, LW_DICTIONARY_MANIFEST_FILENAME);
+
+    g_mutex_lock (&_manifest_mutex);
+    current = (g_key_file_load_from_file (manifest, path, G_KEY_FILE_NONE, NULL) && lw_dictionary_manifest_is_current (manifest));
+    if (!current)
+    {
+      g_key_file_free (manifest); manifest = NULL;
+      manifest = lw_dictionary_scan_manifest ();
+      lw_dictionary_save_manifest (manifest, NULL);
+    }
+    g_mutex_unlock (&_manifest_mutex);
+
+    g_free (path); path = NULL;
+
+    return manifest;
+}
+
+
+//!
+//! @brief Creates the LwDictionary recorded under an id in the manifest.  Its
+//!        length is taken from the manifest instead of the file.
+//! @param manifest A GKeyFile from lw_dictionary_load_manifest
+//! @param ID The id of the dictionary as listed by lw_dictionary_get_manifest_idlist
+//! @returns A new LwDictionary or NULL if the id isn't a known dictionary type
+//!
+LwDictionary*
+lw_dictionary_new_installed (GKeyFile *manifest, const gchar *ID)
+{
+    //Sanity checks
+    g_return_val_if_fail (manifest != NULL, NULL);
+    g_return_val_if_fail (ID != NULL, NULL);
+
+    //Declarations
+    LwDictionary *dictionary;
+    gchar *group;
+    gchar *typename;
+    gchar *filename;
+    GType type;
+
+    //Initializations
+    dictionary = NULL;
+    group = lw_dictionary_manifest_group_from_id (ID);
+    typename = g_key_file_get_string (manifest, group, "Type", NULL);
+    filename = g_key_file_get_string (manifest, group, "Filename", NULL);
+    type = (typename != NULL) ? g_type_from_name (typename) : G_TYPE_INVALID;
+
+    if (filename != NULL && type != G_TYPE_INVALID && g_type_is_a (type, LW_TYPE_DICTIONARY))
+    {
+      dictionary = LW_DICTIONARY (g_object_new (type, "filename", filename, NULL));
+      dictionary->priv->length = (size_t) g_key_file_get_uint64 (manifest, group, "Size", NULL);
+    }
+
+    //Cleanup
+    if (group != NULL) g_free (group); group = NULL;
+    if (typename != NULL) g_free (typename); typename = NULL;
+    if (filename != NULL) g_free (filename); filename = NULL;
+
+    return dictionary;
+}
+
+
+//!
+//! @brief Lists the ids of the dictionaries in a manifest
+//! @param manifest A GKeyFile from lw_dictionary_load_manifest
+//! @param type_filter Only list dictionaries of this type, or G_TYPE_NONE for all
+//! @returns A NULL terminated array that should be freed with g_strfreev
+//!
+gchar**
+lw_dictionary_get_manifest_idlist (GKeyFile *manifest, GType type_filter)
+{
+    //Sanity checks
+    g_return_val_if_fail (manifest != NULL, NULL);
+
+    //Declarations
+    gchar **grouplist;
+    gchar **idlist;
+    gchar *typename;
+    gint length;
+    gint i;
+
+    //Initializations
+    grouplist = g_key_file_get_groups (manifest, NULL);
+    idlist = g_new0 (gchar*, g_strv_length (grouplist) + 1);
+    length = 0;
+
+    for (i = 0; grouplist[i] != NULL; i++)
+    {
+      if (strcmp (grouplist[i], LW_DICTIONARY_MANIFEST_GROUP) == 0) continue;
+
+      if (type_filter != G_TYPE_NONE)
       {
-        while ((filename = g_dir_read_name (directory)) != NULL && length > 0)
+        typename = g_key_file_get_string (manifest, grouplist[i], "Type", NULL);
+        if (typename == NULL || g_type_from_name (typename) != type_filter)
         {
-          *iditer = lw_dictionary_build_id_from_type (*childiter, filename);
-          printf("id: %s\n", *iditer);
-          
-          iditer++;
-          length--;
+          if (typename != NULL) g_free (typename); typename = NULL;
+          continue;
         }
-        g_dir_close (directory); directory = NULL;
+        g_free (typename); typename = NULL;
       }
-      g_free (directorypath); directorypath = NULL;
-      childiter++;
+
+      idlist[length++] = g_uri_unescape_string (grouplist[i], NULL);
+      if (idlist[length - 1] == NULL) length--;
     }
 
-    if (childlist != NULL) g_free (childlist); childlist = NULL;
+    //Cleanup
+    g_strfreev (grouplist); grouplist = NULL;
+
+    return idlist;
+}
+
+
+//!
+//! @brief Lists the ids of the installed dictionaries from the manifest
+//! @param type_filter Only list dictionaries of this type, or G_TYPE_NONE for all
+//! @returns A NULL terminated array that should be freed with g_strfreev
+//!
+gchar**
+lw_dictionary_get_installed_idlist (GType type_filter)
+{
+    //Declarations
+    GKeyFile *manifest;
+    gchar **idlist;
+
+    //Initializations
+    manifest = lw_dictionary_load_manifest ();
+    idlist = lw_dictionary_get_manifest_idlist (manifest, type_filter);
+
+    //Cleanup
+    g_key_file_free (manifest); manifest = NULL;
 
     return idlist;
 }
@@ -756,6 +1144,8 @@ lw_dictionary_build_regex (LwDictionary *dictionary, LwQuery *query, GError **er
     gint i;
 
     //Initializations
+    lw_trace_begin (LW_TRACE_CATEGORY_SEARCH, "build_regex", NULL);
+
     for (type = 0; type < TOTAL_LW_QUERY_TYPES; type++)
     {
       klass = LW_DICTIONARY_CLASS (G_OBJECT_GET_CLASS (dictionary));
@@ -777,6 +1167,8 @@ lw_dictionary_build_regex (LwDictionary *dictionary, LwQuery *query, GError **er
         }
       }
     }
+
+    lw_trace_end (LW_TRACE_CATEGORY_SEARCH, "build_regex");
 }
 
 
@@ -170,37 +170,28 @@ lw_dictionarylist_load_installed (LwDictionaryList *dictionarylist)
 
     //Declarations
     LwDictionaryListClass *klass;
+    GKeyFile *manifest;
     gchar** idlist;
     gchar **iditer;
-    gchar** pair;
-    gchar *typename;
-    GType type;
     LwDictionary *dictionary;
-    const gchar *FILENAME;
 
     lw_dictionarylist_clear (dictionarylist);
     klass = LW_DICTIONARYLIST_CLASS (G_OBJECT_GET_CLASS (dictionarylist));
 
-    idlist = lw_dictionary_get_installed_idlist (G_TYPE_NONE);
+    //The manifest lists the dictionaries with their sizes, so the files aren't looked at
+    manifest = lw_dictionary_load_manifest ();
+    idlist = lw_dictionary_get_manifest_idlist (manifest, G_TYPE_NONE);
     if (idlist != NULL)
     {
       for (iditer = idlist; *iditer != NULL; iditer++)
       {
-        pair = g_strsplit_set (*iditer, "/", 2);
-        if (pair != NULL && pair[0] != NULL && pair[1] != NULL) 
-        {
-          typename = lw_dictionary_directoryname_to_typename (pair[0]);
-          type = g_type_from_name (typename);
-          FILENAME = pair[1];
-          dictionary = LW_DICTIONARY (g_object_new (type, "filename", FILENAME, NULL));
-          if (dictionary != NULL && LW_IS_DICTIONARY (dictionary))
-            lw_dictionarylist_append (dictionarylist, dictionary);
-          if (typename != NULL) g_free (typename); typename = NULL;
-        }
-        g_strfreev (pair); pair = NULL;
+        dictionary = lw_dictionary_new_installed (manifest, *iditer);
+        if (dictionary != NULL && LW_IS_DICTIONARY (dictionary))
+          lw_dictionarylist_append (dictionarylist, dictionary);
       }
       g_strfreev (idlist); idlist = NULL;
     }
+    g_key_file_free (manifest); manifest = NULL;
 
     g_signal_emit (dictionarylist, klass->signalid[LW_DICTIONARYLIST_CLASS_SIGNALID_ADDED], 0);
     g_signal_emit (dictionarylist, klass->signalid[LW_DICTIONARYLIST_CLASS_SIGNALID_CHANGED], 0);
@@ -862,3 +853,158 @@ lw_dictionarylist_sort_with_data (LwDictionaryList *dictionarylist,
 
 }
 
+
+
+struct _LwDictionaryListInstall {
+  GMutex mutex;
+  GCancellable *cancellable;
+  GError *error;                //!< The first error of any install
+};
+typedef struct _LwDictionaryListInstall LwDictionaryListInstall;
+
+
+static void
+lw_dictionarylist_install_func (gpointer data, gpointer user_data)
+{
+    //Declarations
+    LwDictionary *dictionary;
+    LwDictionaryListInstall *install;
+    GError *error;
+    gboolean failed;
+
+    //Initializations
+    dictionary = LW_DICTIONARY (data);
+    install = user_data;
+    error = NULL;
+
+    //Once an install failed, the queued ones are skipped like before
+    g_mutex_lock (&install->mutex);
+    failed = (install->error != NULL);
+    g_mutex_unlock (&install->mutex);
+    if (failed || g_cancellable_is_cancelled (install->cancellable)) return;
+
+    lw_dictionary_install (dictionary, install->cancellable, &error);
+
+    if (error != NULL)
+    {
+      g_mutex_lock (&install->mutex);
+      if (install->error == NULL) install->error = error;
+      else g_error_free (error);
+      error = NULL;
+      g_mutex_unlock (&install->mutex);
+    }
+}
+
+
+//!
+//! @brief Installs every selected dictionary of the list, running up to
+//!        max_jobs installs at the same time.  Blocks until all of them finished.
+//!        Progress is reported through the progress-changed signal of each
+//!        dictionary, which is emitted on the worker threads, and through
+//!        lw_dictionarylist_installer_get_total_progress.
+//! @param dictionarylist A LwDictionaryList of installable dictionaries
+//! @param max_jobs The maximum number of dictionaries to install in parallel
+//! @param cancellable A GCancellable to stop the installs with or NULL
+//! @param error A pointer to a GError object to pass the first error to or NULL
+//! @returns TRUE if every selected dictionary was installed
+//!
+gboolean
+lw_dictionarylist_install (LwDictionaryList  *dictionarylist,
+                           gint               max_jobs,
+                           GCancellable      *cancellable,
+                           GError           **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (dictionarylist != NULL, FALSE);
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    LwDictionaryListPrivate *priv;
+    LwDictionaryListInstall install;
+    LwDictionary *dictionary;
+    GThreadPool *pool;
+    GList *link;
+
+    //Initializations
+    priv = dictionarylist->priv;
+    if (max_jobs < 1) max_jobs = 1;
+    memset(&install, 0, sizeof(LwDictionaryListInstall));
+    g_mutex_init (&install.mutex);
+    install.cancellable = cancellable;
+
+    pool = g_thread_pool_new (lw_dictionarylist_install_func, &install, max_jobs, FALSE, &install.error);
+
+    if (pool != NULL)
+    {
+      //Reset the progress of every queued dictionary before any of them starts
+      for (link = priv->list; link != NULL; link = link->next)
+      {
+        dictionary = LW_DICTIONARY (link->data);
+        if (lw_dictionary_is_selected (dictionary))
+          lw_dictionary_installer_set_status (dictionary, LW_DICTIONARY_INSTALLER_STATUS_UNINSTALLED);
+      }
+
+      for (link = priv->list; link != NULL; link = link->next)
+      {
+        dictionary = LW_DICTIONARY (link->data);
+        if (lw_dictionary_is_selected (dictionary))
+          g_thread_pool_push (pool, dictionary, NULL);
+      }
+
+      //Wait for the queued installs to finish
+      g_thread_pool_free (pool, FALSE, TRUE); pool = NULL;
+    }
+
+    if (install.error != NULL)
+    {
+      if (error != NULL) *error = install.error;
+      else g_error_free (install.error);
+      install.error = NULL;
+      g_mutex_clear (&install.mutex);
+      return FALSE;
+    }
+
+    g_mutex_clear (&install.mutex);
+
+    return !g_cancellable_is_cancelled (cancellable);
+}
+
+
+//!
+//! @brief Gets the combined progress of installing the selected dictionaries
+//!        of a list.  Each dictionary counts the same.  Safe to call from a
+//!        thread other than the one running lw_dictionarylist_install.
+//! @param dictionarylist A LwDictionaryList of installable dictionaries
+//! @returns A fraction between 0.0 and 1.0
+//!
+gdouble
+lw_dictionarylist_installer_get_total_progress (LwDictionaryList *dictionarylist)
+{
+    //Sanity checks
+    g_return_val_if_fail (dictionarylist != NULL, 0.0);
+
+    //Declarations
+    LwDictionaryListPrivate *priv;
+    LwDictionary *dictionary;
+    GList *link;
+    gdouble current;
+    gint total;
+
+    //Initializations
+    priv = dictionarylist->priv;
+    current = 0.0;
+    total = 0;
+
+    for (link = priv->list; link != NULL; link = link->next)
+    {
+      dictionary = LW_DICTIONARY (link->data);
+      if (dictionary == NULL || !lw_dictionary_is_selected (dictionary)) continue;
+
+      current += lw_dictionary_installer_get_total_progress (dictionary);
+      total++;
+    }
+
+    if (total == 0) return 0.0;
+
+    return current / (gdouble) total;
+}
@@ -45,6 +45,7 @@ static gboolean lw_edictionary_parse_query (LwDictionary*, LwQuery*, const gchar
 static gboolean lw_edictionary_parse_result (LwDictionary*, LwResult*, FILE*);
 static gboolean lw_edictionary_compare (LwDictionary*, LwQuery*, LwResult*, const LwRelevance);
 static gboolean lw_edictionary_installer_postprocess (LwDictionary*, gchar**, gchar**, LwIoProgressCallback, gpointer, GCancellable*, GError**);
+static guint lw_edictionary_installer_classify_line (LwDictionary*, gint, const gchar*);
 static void lw_edictionary_create_primary_tokens (LwDictionary*, LwQuery*);
 
 
@@ -130,6 +131,7 @@ lw_edictionary_class_init (LwEDictionaryClass *klass)
     dictionary_class->parse_result = lw_edictionary_parse_result;
     dictionary_class->compare = lw_edictionary_compare;
     dictionary_class->installer_postprocess = lw_edictionary_installer_postprocess;
+    dictionary_class->installer_classify_line = lw_edictionary_installer_classify_line;
 
     dictionary_class->patterns = g_new0 (gchar**, TOTAL_LW_QUERY_TYPES + 1);
     for (i = 0; i < TOTAL_LW_QUERY_TYPES; i++)
@@ -443,6 +445,37 @@ lw_edictionary_installer_postprocess (LwDictionary *dictionary,
 }
 
 
+//!
+//! @brief The streaming counterpart of lw_edictionary_installer_postprocess.
+//!        Routes each line of a downloaded file to the installed files.
+//! @param dictionary The LwDictionary being installed
+//! @param index The index of the downloaded file the line came from
+//! @param LINE A NULL terminated line of UTF-8 text
+//! @returns A mask of the indexes of the installed files to write the line to
+//!
+static guint
+lw_edictionary_installer_classify_line (LwDictionary *dictionary,
+                                        gint          index,
+                                        const gchar  *LINE)
+{
+    //Sanity checks
+    g_return_val_if_fail (dictionary != NULL, 0);
+
+    //Declarations
+    LwDictionaryPrivate *priv;
+    LwDictionaryInstall *install;
+
+    //Initializations
+    priv = dictionary->priv;
+    install = priv->install;
+
+    if (install->postprocess == FALSE) return (1 << index);
+
+    //The Names file comes first and the Places file second
+    return lw_io_classify_names_places_line (LINE);
+}
+
+
 //!
 //! @brief Will change a query into a & delimited set of tokens (logical and)
 //!
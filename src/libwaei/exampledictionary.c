@@ -214,6 +214,7 @@ lw_exampledictionary_parse_result (LwDictionary *dictionary, LwResult *result, F
     *ptr = '\0';
     ptr++;
     result->def_start[0] = ptr;
+    result->def_start[1] = NULL;
 
     //Erase the id number
     while (*ptr != '\0' && *ptr != '#') ptr = g_utf8_next_char (ptr);
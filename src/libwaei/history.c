@@ -39,9 +39,187 @@ G_DEFINE_TYPE (LwHistory, lw_history, G_TYPE_OBJECT)
 typedef enum
 {
   PROP_0,
-  PROP_MAX_SIZE
+  PROP_MAX_SIZE,
+  PROP_RESULT_CACHE_SIZE
 } LwHistoryProps;
 
+
+//!
+//! @brief Records what is needed to search again for a LwSearch
+//! @param search The LwSearch to record.  It isn't kept by the record.
+//! @return An allocated LwHistoryRecord that should be freed with lw_historyrecord_free
+//!
+LwHistoryRecord*
+lw_historyrecord_new (LwSearch *search)
+{
+    //Sanity checks
+    g_return_val_if_fail (search != NULL, NULL);
+
+    //Declarations
+    LwHistoryRecord *record;
+
+    //Initializations
+    record = g_new0 (LwHistoryRecord, 1);
+    record->query = g_strdup (lw_query_get_text (search->query));
+    record->flags = lw_search_get_flags (search);
+
+    if (search->dictionary != NULL)
+    {
+      record->dictionary = g_object_ref (search->dictionary);
+      record->dictionary_id = lw_dictionary_build_id (search->dictionary);
+    }
+
+    return record;
+}
+
+
+void
+lw_historyrecord_free (LwHistoryRecord *record)
+{
+    //Sanity checks
+    if (record == NULL) return;
+
+    if (record->query != NULL) g_free (record->query); record->query = NULL;
+    if (record->dictionary_id != NULL) g_free (record->dictionary_id); record->dictionary_id = NULL;
+    if (record->dictionary != NULL) g_object_unref (record->dictionary); record->dictionary = NULL;
+    if (record->search != NULL) lw_search_free (record->search); record->search = NULL;
+
+    g_free (record);
+}
+
+
+//!
+//! @brief Turns a record back into a LwSearch.  The cached search is handed
+//!        over if the record still has one, otherwise a new one is created
+//!        that still has to be started.
+//! @param record The LwHistoryRecord to take the search of
+//! @param error A GError to place errors into or NULL
+//! @return A LwSearch that should be freed with lw_search_free or NULL on error
+//!
+LwSearch*
+lw_historyrecord_take_search (LwHistoryRecord *record, GError **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (record != NULL, NULL);
+    if (error != NULL && *error != NULL) return NULL;
+
+    //Declarations
+    LwSearch *search;
+
+    //Initializations
+    search = record->search;
+    record->search = NULL;
+    record->size = 0;
+
+    if (search == NULL && record->dictionary != NULL && record->query != NULL)
+      search = lw_search_new (record->dictionary, record->query, record->flags, error);
+
+    return search;
+}
+
+
+//!
+//! @brief Estimates the memory a search holds with its results
+//!
+static gsize
+lw_history_get_search_size (LwSearch *search)
+{
+    //Declarations
+    const gchar *TEXT;
+    gsize size;
+
+    //Initializations
+    TEXT = lw_query_get_text (search->query);
+    size = sizeof(LwSearch) + search->result_memory;
+    if (TEXT != NULL) size += strlen(TEXT) + 1;
+
+    return size;
+}
+
+
+static void
+lw_history_uncache_record (LwHistory *history, LwHistoryRecord *record)
+{
+    if (record->search == NULL) return;
+
+    history->priv->cached -= record->size;
+    lw_search_free (record->search); record->search = NULL;
+    record->size = 0;
+}
+
+
+//!
+//! @brief Drops the results of the oldest records until the cached ones fit
+//!        in the result cache size
+//!
+static void
+lw_history_trim_result_cache (LwHistory *history)
+{
+    //Declarations
+    LwHistoryPrivate *priv;
+    GList *link;
+
+    //Initializations
+    priv = history->priv;
+
+    for (link = g_list_last (priv->back); link != NULL && priv->cached > priv->cache_size; link = link->prev)
+      lw_history_uncache_record (history, link->data);
+
+    for (link = g_list_last (priv->forward); link != NULL && priv->cached > priv->cache_size; link = link->prev)
+      lw_history_uncache_record (history, link->data);
+}
+
+
+//!
+//! @brief Records a search for the history, keeping it with its results if
+//!        the result cache has room.  Otherwise it is freed.
+//!
+static LwHistoryRecord*
+lw_history_record_search (LwHistory *history, LwSearch *search, gdouble scroll)
+{
+    //Declarations
+    LwHistoryPrivate *priv;
+    LwHistoryRecord *record;
+    gsize size;
+
+    //Initializations
+    priv = history->priv;
+    record = lw_historyrecord_new (search);
+    record->scroll = scroll;
+    size = lw_history_get_search_size (search);
+
+    if (size <= priv->cache_size)
+    {
+      record->search = search;
+      record->size = size;
+      priv->cached += size;
+    }
+    else
+    {
+      lw_search_free (search);
+    }
+
+    return record;
+}
+
+
+//!
+//! @brief Removes a record from the history and turns it back into a search
+//!
+static LwSearch*
+lw_history_restore_record (LwHistory *history, LwHistoryRecord *record, gdouble *scroll)
+{
+    //Declarations
+    LwSearch *search;
+
+    if (scroll != NULL) *scroll = record->scroll;
+    history->priv->cached -= record->size;
+    search = lw_historyrecord_take_search (record, NULL);
+    lw_historyrecord_free (record);
+
+    return search;
+}
+
 //!
 //! @brief Creates a new LwHistory object
 //! @param MAX The maximum items you want in the history before old ones are deleted
@@ -105,6 +283,10 @@ lw_history_set_property (GObject      *object,
       case PROP_MAX_SIZE:
         priv->max = g_value_get_int (value);
         break;
+      case PROP_RESULT_CACHE_SIZE:
+        priv->cache_size = g_value_get_uint (value);
+        lw_history_trim_result_cache (history);
+        break;
       default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
         break;
@@ -131,6 +313,9 @@ lw_history_get_property (GObject      *object,
       case PROP_MAX_SIZE:
         g_value_set_int (value, priv->max);
         break;
+      case PROP_RESULT_CACHE_SIZE:
+        g_value_set_uint (value, priv->cache_size);
+        break;
       default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
         break;
@@ -205,6 +390,16 @@ lw_history_class_init (LwHistoryClass *klass)
                               G_PARAM_CONSTRUCT | G_PARAM_READWRITE
     );
     g_object_class_install_property (object_class, PROP_MAX_SIZE, pspec);
+
+    pspec = g_param_spec_uint ("result-cache-size",
+                               "Bytes of search results kept by the history.",
+                               "Set how many bytes of search results the history keeps so going back doesn't search again",
+                               0,
+                               G_MAXUINT,
+                               0,
+                               G_PARAM_CONSTRUCT | G_PARAM_READWRITE
+    );
+    g_object_class_install_property (object_class, PROP_RESULT_CACHE_SIZE, pspec);
 }
 
 
@@ -217,7 +412,7 @@ lw_history_clear_forward_list (LwHistory *history)
     //Declarations
     LwHistoryPrivate *priv;
     LwHistoryClass *klass;
-    LwSearch *search;
+    LwHistoryRecord *record;
     GList *iter;
 
     //Initializations
@@ -227,15 +422,19 @@ lw_history_clear_forward_list (LwHistory *history)
     //Free the data of the history
     for (iter = priv->forward; iter != NULL; iter = iter->next)
     {
-      search = (LwSearch*) iter->data;
-      if (search != NULL)
-        lw_search_free (search);
+      record = (LwHistoryRecord*) iter->data;
+      if (record != NULL)
+      {
+        priv->cached -= record->size;
+        lw_historyrecord_free (record);
+      }
       iter->data = NULL;
     }
 
     //Free the history itself
     g_list_free (priv->forward);
     priv->forward = NULL;
+    priv->forward_length = 0;
 
     g_signal_emit (history,
       klass->signalid[LW_HISTORY_CLASS_SIGNALID_CHANGED],
@@ -253,7 +452,7 @@ lw_history_clear_back_list (LwHistory *history)
     //Declarations
     LwHistoryPrivate *priv;
     LwHistoryClass *klass;
-    LwSearch *search;
+    LwHistoryRecord *record;
     GList *iter;
 
     //Initializations
@@ -263,15 +462,19 @@ lw_history_clear_back_list (LwHistory *history)
     //Free the data of the history
     for (iter = priv->back; iter != NULL; iter = iter->next)
     {
-      search = (LwSearch*) iter->data;
-      if (search != NULL)
-        lw_search_free (search);
+      record = (LwHistoryRecord*) iter->data;
+      if (record != NULL)
+      {
+        priv->cached -= record->size;
+        lw_historyrecord_free (record);
+      }
       iter->data = NULL;
     }
 
     //Free the history itself
     g_list_free (priv->back);
     priv->back = NULL;
+    priv->back_length = 0;
 
     g_signal_emit (history,
       klass->signalid[LW_HISTORY_CLASS_SIGNALID_CHANGED],
@@ -282,7 +485,7 @@ lw_history_clear_back_list (LwHistory *history)
 
 //!
 //! @brief Gets the back history of the target history history
-//! @return Returns a GList containing the LwSearch back history
+//! @return Returns a GList containing the LwHistoryRecord back history
 //!
 GList* 
 lw_history_get_back_list (LwHistory *history)
@@ -293,7 +496,7 @@ lw_history_get_back_list (LwHistory *history)
 
 //!
 //! @brief Gets the forward history of the target history history
-//! @return Returns a GList containing the LwSearch forward history
+//! @return Returns a GList containing the LwHistoryRecord forward history
 //!
 GList* 
 lw_history_get_forward_list (LwHistory *history)
@@ -331,30 +534,45 @@ lw_history_get_combined_list (LwHistory *history)
 
 
 //!
-//! @brief Moves an search to the back history
+//! @brief Moves an search to the back history.  The history takes the search,
+//!        but only keeps a LwHistoryRecord of it unless the results fit in the
+//!        result cache.  The search is also written to the log of the history.
+//! @param history The LwHistory to add to
+//! @param search The LwSearch to add
+//! @param scroll Where the results of the search were scrolled to, from 0.0 to 1.0
 //!
 void 
-lw_history_add_search (LwHistory *history, LwSearch *search)
+lw_history_add_search (LwHistory *history, LwSearch *search, gdouble scroll)
 { 
     //Declarations
     LwHistoryPrivate *priv;
     LwHistoryClass *klass;
+    LwHistoryRecord *record;
     GList *link;
 
     //Initalizations
     priv = history->priv;
     klass = LW_HISTORY_CLASS (G_OBJECT_GET_CLASS (history));
     
-    priv->back = g_list_prepend (priv->back, search);
+    record = lw_history_record_search (history, search, scroll);
+    priv->back = g_list_prepend (priv->back, record);
+    priv->back_length++;
+
+    if (priv->log != NULL) lw_historylog_append (priv->log, record, NULL);
 
     //Make sure the history hasn't gotten too long
-    if (g_list_length (priv->back) >= priv->max)
+    if (priv->max >= 0 && priv->back_length >= priv->max)
     {
       link = g_list_last (priv->back); 
-      lw_search_free (LW_SEARCH (link->data));
+      record = (LwHistoryRecord*) link->data;
+      priv->cached -= record->size;
+      lw_historyrecord_free (record);
       priv->back = g_list_delete_link (priv->back, link);
+      priv->back_length--;
     }
 
+    lw_history_trim_result_cache (history);
+
     //Clear the forward history
     lw_history_clear_forward_list (history);
 
@@ -365,6 +583,48 @@ lw_history_add_search (LwHistory *history, LwSearch *search)
 }
 
 
+//!
+//! @brief Writes a search to the log of the history without adding it to the
+//!        history.  Searches added with lw_history_add_search are logged already.
+//! @param history The LwHistory whose log to write to
+//! @param search The LwSearch to log
+//!
+void
+lw_history_log_search (LwHistory *history, LwSearch *search)
+{
+    //Sanity checks
+    g_return_if_fail (history != NULL);
+    g_return_if_fail (search != NULL);
+    if (history->priv->log == NULL) return;
+
+    //Declarations
+    LwHistoryRecord *record;
+
+    //Initializations
+    record = lw_historyrecord_new (search);
+
+    lw_historylog_append (history->priv->log, record, NULL);
+
+    //Cleanup
+    lw_historyrecord_free (record); record = NULL;
+}
+
+
+//!
+//! @brief Sets the log that searches added to the history are written to
+//! @param history The LwHistory to set the log of
+//! @param log An LwHistoryLog that outlives the history or NULL to stop logging
+//!
+void
+lw_history_set_log (LwHistory *history, LwHistoryLog *log)
+{
+    //Sanity checks
+    g_return_if_fail (history != NULL);
+
+    history->priv->log = log;
+}
+
+
 //!
 //! @brief Returns true if it is possible to go forward on a history history
 //!
@@ -387,9 +647,12 @@ lw_history_has_back (LwHistory *history)
 
 //!
 //! @brief Go back 1 in history
+//! @param history The LwHistory to go back in
+//! @param pushed The current search, which is moved to the forward history
+//! @param scroll Where pushed was scrolled to.  It is set to where the returned search was.
 //!
 LwSearch* 
-lw_history_go_back (LwHistory *history, LwSearch *pushed)
+lw_history_go_back (LwHistory *history, LwSearch *pushed, gdouble *scroll)
 { 
     //Sanity check
     if (!lw_history_has_back (history)) return pushed;
@@ -397,6 +660,7 @@ lw_history_go_back (LwHistory *history, LwSearch *pushed)
     //Declarations
     LwHistoryPrivate *priv;
     LwHistoryClass *klass;
+    LwHistoryRecord *record;
     GList *link;
     LwSearch *popped;
 
@@ -405,12 +669,17 @@ lw_history_go_back (LwHistory *history, LwSearch *pushed)
 
     if (pushed != NULL)
     {
-      priv->forward = g_list_append (priv->forward, pushed);
+      priv->forward = g_list_append (priv->forward, lw_history_record_search (history, pushed, (scroll != NULL) ? *scroll : 0.0));
+      priv->forward_length++;
     }
 
     link = g_list_last (priv->back); 
-    popped = LW_SEARCH (link->data);
+    record = (LwHistoryRecord*) link->data;
     priv->back = g_list_delete_link (priv->back, link);
+    priv->back_length--;
+    popped = lw_history_restore_record (history, record, scroll);
+
+    lw_history_trim_result_cache (history);
 
     g_signal_emit (history,
       klass->signalid[LW_HISTORY_CLASS_SIGNALID_BACK],
@@ -428,9 +697,12 @@ lw_history_go_back (LwHistory *history, LwSearch *pushed)
 
 //!
 //! @brief Go forward 1 in history
+//! @param history The LwHistory to go forward in
+//! @param pushed The current search, which is moved to the back history
+//! @param scroll Where pushed was scrolled to.  It is set to where the returned search was.
 //!
 LwSearch* 
-lw_history_go_forward (LwHistory *history, LwSearch *pushed)
+lw_history_go_forward (LwHistory *history, LwSearch *pushed, gdouble *scroll)
 { 
     //Sanity check
     if (!lw_history_has_forward (history)) return pushed;
@@ -438,6 +710,7 @@ lw_history_go_forward (LwHistory *history, LwSearch *pushed)
     //Declarations
     LwHistoryPrivate *priv;
     LwHistoryClass *klass;
+    LwHistoryRecord *record;
     GList *link;
     LwSearch *popped;
 
@@ -446,12 +719,17 @@ lw_history_go_forward (LwHistory *history, LwSearch *pushed)
 
     if (pushed != NULL)
     {
-      priv->back = g_list_append (priv->back, pushed);
+      priv->back = g_list_append (priv->back, lw_history_record_search (history, pushed, (scroll != NULL) ? *scroll : 0.0));
+      priv->back_length++;
     }
 
     link = g_list_last (priv->forward); 
-    popped = LW_SEARCH (link->data);
+    record = (LwHistoryRecord*) link->data;
     priv->forward = g_list_delete_link (priv->forward, link);
+    priv->forward_length--;
+    popped = lw_history_restore_record (history, record, scroll);
+
+    lw_history_trim_result_cache (history);
 
     g_signal_emit (history,
       klass->signalid[LW_HISTORY_CLASS_SIGNALID_FORWARD],
@@ -0,0 +1,422 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+//!
+//! @file historylog.c
+//!
+//! @brief Searches kept on disk across sessions for recalling past queries
+//!
+//! Every search added to the history is appended to the log as a line of
+//! "time<TAB>count<TAB>dictionary id<TAB>query".  The log is read once when it
+//! is opened and kept in memory as one entry per query, sorted so the queries
+//! starting with some text can be found without scanning them all.  Once the
+//! file has grown to a few times the number of entries, it is rewritten with
+//! one line per entry.
+//!
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/gettext.h>
+#include <libwaei/libwaei.h>
+
+#define LW_HISTORYLOG_COMPACT_MIN_LINES 256 //!< The log isn't compacted while shorter than this
+#define LW_HISTORYLOG_COMPACT_RATIO 2       //!< The log is compacted when it has this many lines per entry
+
+struct _LwHistoryLogEntry {
+  gchar *query;
+  gchar *dictionary_id;
+  gint64 time;                  //!< When the query was last searched for, in seconds since the epoch
+  gint count;                   //!< How many times the query was searched for
+};
+typedef struct _LwHistoryLogEntry LwHistoryLogEntry;
+
+struct _LwHistoryLog {
+  gchar *path;
+  FILE *file;                   //!< The log opened for appending
+  GSequence *index;             //!< The LwHistoryLogEntry of every query sorted by query
+  GHashTable *entries;          //!< The GSequenceIter of every query
+  gint lines;                   //!< Lines in the file, brought back to the number of entries by compaction
+  GMutex mutex;
+};
+
+
+static void
+lw_historylogentry_free (LwHistoryLogEntry *entry)
+{
+    if (entry == NULL) return;
+
+    if (entry->query != NULL) g_free (entry->query); entry->query = NULL;
+    if (entry->dictionary_id != NULL) g_free (entry->dictionary_id); entry->dictionary_id = NULL;
+
+    g_free (entry);
+}
+
+
+static gint
+lw_historylogentry_compare_query (gconstpointer a, gconstpointer b, gpointer data)
+{
+    return strcmp (((LwHistoryLogEntry*) a)->query, ((LwHistoryLogEntry*) b)->query);
+}
+
+
+//!
+//! @brief Most recent first, then most searched for
+//!
+static gint
+lw_historylogentry_compare_recent (gconstpointer a, gconstpointer b)
+{
+    //Declarations
+    const LwHistoryLogEntry *entry1;
+    const LwHistoryLogEntry *entry2;
+
+    //Initializations
+    entry1 = *((LwHistoryLogEntry**) a);
+    entry2 = *((LwHistoryLogEntry**) b);
+
+    if (entry1->time != entry2->time) return (entry1->time > entry2->time) ? -1 : 1;
+    if (entry1->count != entry2->count) return (entry1->count > entry2->count) ? -1 : 1;
+    return 0;
+}
+
+
+//!
+//! @brief Adds a search of a query to the entries, creating the entry the first
+//!        time the query is seen
+//!
+static void
+lw_historylog_merge (LwHistoryLog *log, const gchar *QUERY, const gchar *DICTIONARY_ID, gint64 time, gint count)
+{
+    //Declarations
+    LwHistoryLogEntry *entry;
+    GSequenceIter *iter;
+
+    //Initializations
+    iter = g_hash_table_lookup (log->entries, QUERY);
+
+    if (iter != NULL)
+    {
+      entry = g_sequence_get (iter);
+      entry->count += count;
+      if (time >= entry->time)
+      {
+        entry->time = time;
+        g_free (entry->dictionary_id);
+        entry->dictionary_id = g_strdup (DICTIONARY_ID);
+      }
+    }
+    else
+    {
+      entry = g_new0 (LwHistoryLogEntry, 1);
+      entry->query = g_strdup (QUERY);
+      entry->dictionary_id = g_strdup (DICTIONARY_ID);
+      entry->time = time;
+      entry->count = count;
+      iter = g_sequence_insert_sorted (log->index, entry, lw_historylogentry_compare_query, NULL);
+      g_hash_table_insert (log->entries, entry->query, iter);
+    }
+}
+
+
+//!
+//! @brief Reads the lines of the log into the entries
+//!
+static void
+lw_historylog_read (LwHistoryLog *log)
+{
+    //Declarations
+    gchar *contents;
+    gchar *line;
+    gchar *end;
+    gchar **fields;
+
+    //Initializations
+    contents = NULL;
+
+    if (!g_file_get_contents (log->path, &contents, NULL, NULL)) return;
+
+    for (line = contents; line != NULL && *line != '\0'; line = end)
+    {
+      end = strchr (line, '\n');
+      if (end != NULL) *(end++) = '\0';
+
+      fields = g_strsplit (line, "\t", 4);
+      if (g_strv_length (fields) == 4 && *fields[3] != '\0')
+      {
+        lw_historylog_merge (log, fields[3], fields[2], g_ascii_strtoll (fields[0], NULL, 10), MAX (1, atoi (fields[1])));
+      }
+      g_strfreev (fields); fields = NULL;
+
+      log->lines++;
+    }
+
+    //Cleanup
+    g_free (contents); contents = NULL;
+}
+
+
+//!
+//! @brief Writes one line of the log.  Tabs and line breaks can't be part of a
+//!        field, so they are written as spaces.
+//!
+static void
+lw_historylog_append_line (GString *text, const gchar *QUERY, const gchar *DICTIONARY_ID, gint64 time, gint count)
+{
+    //Declarations
+    const gchar *ptr;
+
+    g_string_append_printf (text, "%" G_GINT64_FORMAT "\t%d\t", time, count);
+    for (ptr = (DICTIONARY_ID != NULL) ? DICTIONARY_ID : ""; *ptr != '\0'; ptr++)
+      g_string_append_c (text, (*ptr == '\t' || *ptr == '\n' || *ptr == '\r') ? ' ' : *ptr);
+    g_string_append_c (text, '\t');
+    for (ptr = QUERY; *ptr != '\0'; ptr++)
+      g_string_append_c (text, (*ptr == '\t' || *ptr == '\n' || *ptr == '\r') ? ' ' : *ptr);
+    g_string_append_c (text, '\n');
+}
+
+
+//!
+//! @brief Rewrites the log with one line per entry.  Must be called with the
+//!        mutex held.
+//!
+static gboolean
+lw_historylog_compact_locked (LwHistoryLog *log, GError **error)
+{
+    //Declarations
+    LwHistoryLogEntry *entry;
+    GSequenceIter *iter;
+    GString *text;
+    gboolean success;
+
+    //Initializations
+    text = g_string_sized_new (LW_IO_BUFFER_SIZE);
+
+    for (iter = g_sequence_get_begin_iter (log->index); !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter))
+    {
+      entry = g_sequence_get (iter);
+      lw_historylog_append_line (text, entry->query, entry->dictionary_id, entry->time, entry->count);
+    }
+
+    if (log->file != NULL) fclose (log->file); log->file = NULL;
+
+    success = g_file_set_contents (log->path, text->str, text->len, error);
+    if (success) log->lines = g_hash_table_size (log->entries);
+
+    log->file = g_fopen (log->path, "ab");
+
+    //Cleanup
+    g_string_free (text, TRUE); text = NULL;
+
+    return success;
+}
+
+
+static gboolean
+lw_historylog_needs_compaction (LwHistoryLog *log)
+{
+    return (log->lines > LW_HISTORYLOG_COMPACT_MIN_LINES &&
+            log->lines > LW_HISTORYLOG_COMPACT_RATIO * g_hash_table_size (log->entries));
+}
+
+
+//!
+//! @brief Opens a search history log, creating it if it doesn't exist yet
+//! @param PATH The file to keep the log in
+//! @return An allocated LwHistoryLog that should be freed with lw_historylog_free
+//!
+LwHistoryLog*
+lw_historylog_new (const gchar *PATH)
+{
+    //Sanity checks
+    g_return_val_if_fail (PATH != NULL, NULL);
+
+    //Declarations
+    LwHistoryLog *log;
+
+    //Initializations
+    log = g_new0 (LwHistoryLog, 1);
+    log->path = g_strdup (PATH);
+    log->index = g_sequence_new ((GDestroyNotify) lw_historylogentry_free);
+    log->entries = g_hash_table_new (g_str_hash, g_str_equal);
+    g_mutex_init (&log->mutex);
+
+    lw_historylog_read (log);
+
+    g_mutex_lock (&log->mutex);
+    if (lw_historylog_needs_compaction (log)) lw_historylog_compact_locked (log, NULL);
+    if (log->file == NULL) log->file = g_fopen (log->path, "ab");
+    g_mutex_unlock (&log->mutex);
+
+    return log;
+}
+
+
+void
+lw_historylog_free (LwHistoryLog *log)
+{
+    //Sanity checks
+    if (log == NULL) return;
+
+    if (log->file != NULL) fclose (log->file); log->file = NULL;
+    if (log->entries != NULL) g_hash_table_destroy (log->entries); log->entries = NULL;
+    if (log->index != NULL) g_sequence_free (log->index); log->index = NULL;
+    if (log->path != NULL) g_free (log->path); log->path = NULL;
+    g_mutex_clear (&log->mutex);
+
+    g_free (log);
+}
+
+
+//!
+//! @brief Appends a searched query to the log
+//! @param log The LwHistoryLog to add to
+//! @param record The LwHistoryRecord of the search
+//! @param error A GError to place errors into or NULL
+//!
+gboolean
+lw_historylog_append (LwHistoryLog *log, LwHistoryRecord *record, GError **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (log != NULL, FALSE);
+    g_return_val_if_fail (record != NULL, FALSE);
+    if (error != NULL && *error != NULL) return FALSE;
+    if (record->query == NULL || *record->query == '\0') return TRUE;
+
+    //Declarations
+    GString *line;
+    gint64 time;
+    gboolean success;
+    GQuark quark;
+
+    //Initializations
+    line = g_string_new (NULL);
+    time = g_get_real_time () / G_USEC_PER_SEC;
+    success = TRUE;
+
+    lw_historylog_append_line (line, record->query, record->dictionary_id, time, 1);
+
+    g_mutex_lock (&log->mutex);
+
+    lw_historylog_merge (log, record->query, record->dictionary_id, time, 1);
+
+    if (log->file == NULL || fputs (line->str, log->file) == EOF || fflush (log->file) != 0)
+    {
+      quark = g_quark_from_string (LW_IO_ERROR);
+      if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), log->path);
+      success = FALSE;
+    }
+    else
+    {
+      log->lines++;
+    }
+
+    if (success && lw_historylog_needs_compaction (log)) success = lw_historylog_compact_locked (log, error);
+
+    g_mutex_unlock (&log->mutex);
+
+    //Cleanup
+    g_string_free (line, TRUE); line = NULL;
+
+    return success;
+}
+
+
+//!
+//! @brief Rewrites the log with one line per query
+//!
+gboolean
+lw_historylog_compact (LwHistoryLog *log, GError **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (log != NULL, FALSE);
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    gboolean success;
+
+    g_mutex_lock (&log->mutex);
+    success = lw_historylog_compact_locked (log, error);
+    g_mutex_unlock (&log->mutex);
+
+    return success;
+}
+
+
+//!
+//! @brief Finds past queries that start with some text
+//! @param log The LwHistoryLog to look in
+//! @param PREFIX The text the queries start with
+//! @param max The most queries to return
+//! @return A NULL terminated array of queries, most recent first, that should
+//!         be freed with g_strfreev
+//!
+gchar**
+lw_historylog_complete (LwHistoryLog *log, const gchar *PREFIX, gint max)
+{
+    //Sanity checks
+    g_return_val_if_fail (log != NULL, NULL);
+    g_return_val_if_fail (PREFIX != NULL, NULL);
+
+    //Declarations
+    LwHistoryLogEntry probe;
+    LwHistoryLogEntry *entry;
+    GSequenceIter *iter;
+    GPtrArray *matches;
+    gchar **querylist;
+    gint length;
+    gint i;
+
+    //Initializations
+    probe.query = (gchar*) PREFIX;
+    matches = g_ptr_array_new ();
+
+    g_mutex_lock (&log->mutex);
+
+    //The search lands after an entry equal to the prefix, which doesn't need completing anyway
+    iter = g_sequence_search (log->index, &probe, lw_historylogentry_compare_query, NULL);
+    for (; !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter))
+    {
+      entry = g_sequence_get (iter);
+      if (!g_str_has_prefix (entry->query, PREFIX)) break;
+      g_ptr_array_add (matches, entry);
+    }
+
+    g_ptr_array_sort (matches, lw_historylogentry_compare_recent);
+
+    length = (max >= 0) ? MIN ((gint) matches->len, max) : (gint) matches->len;
+    querylist = g_new0 (gchar*, length + 1);
+    for (i = 0; i < length; i++)
+    {
+      entry = g_ptr_array_index (matches, i);
+      querylist[i] = g_strdup (entry->query);
+    }
+
+    g_mutex_unlock (&log->mutex);
+
+    //Cleanup
+    g_ptr_array_free (matches, TRUE); matches = NULL;
+
+    return querylist;
+}
@@ -30,6 +30,8 @@ gboolean lw_dictionary_installer_convert_encoding (LwDictionary*, GCancellable*,
 gboolean lw_dictionary_installer_postprocess (LwDictionary*, GCancellable*, GError**);
 gboolean lw_dictionary_installer_install (LwDictionary*, GCancellable*, GError**);
 void lw_dictionary_installer_clean (LwDictionary*, GCancellable*);
+gboolean lw_dictionary_installer_stream (LwDictionary*, GCancellable*, GError**);
+gboolean lw_dictionary_installer_update (LwDictionary*, GCancellable*, GError**);
 
 gdouble lw_dictionary_installer_get_progress (LwDictionary*);
 gdouble lw_dictionary_installer_get_stage_progress (LwDictionary*);
@@ -37,8 +37,13 @@ struct _LwDictionaryInstall {
   gulong listenerid;            //!< An id to hold the g_signal_connect value when the source copy uri pref is set
   LwEncoding encoding;          //!< Path to the raw unziped dictionary file
   gboolean postprocess;
+  gint total_progress;          //!< Cached by the installing thread, scaled by LW_DICTIONARY_INSTALLER_TOTAL_PROGRESS_SCALE
 };
 
+#define LW_DICTIONARY_INSTALLER_TOTAL_PROGRESS_SCALE 10000.0
+
+void lw_dictionary_installer_sync_total_progress (LwDictionary*);
+
 #define LW_DICTIONARY_GET_PRIVATE(object)(G_TYPE_INSTANCE_GET_PRIVATE ((object), LW_TYPE_DICTIONARY, LwDictionaryPrivate));
 
 G_END_DECLS
@@ -7,6 +7,11 @@
 
 G_BEGIN_DECLS
 
+#define LW_DICTIONARY_MANIFEST_FILENAME "manifest"
+#define LW_DICTIONARY_MANIFEST_GROUP "Manifest"
+#define LW_DICTIONARY_MANIFEST_VERSION 2
+#define LW_DICTIONARY_INSTALLER_VERSION 1 //!< Raise when the format of installed files changes
+
 typedef enum {
   LW_DICTIONARY_CLASS_SIGNALID_PROGRESS_CHANGED,
   TOTAL_LW_DICTIONARY_CLASS_SIGNALIDS
@@ -43,12 +48,14 @@ struct _LwDictionaryClass {
   gint (*parse_result) (LwDictionary *dictionary, LwResult *result, FILE *fd);
   gboolean (*compare) (LwDictionary *dictionary, LwQuery *query, LwResult *result, const LwRelevance relevance);
   gboolean (*installer_postprocess) (LwDictionary *dictionary, gchar** sourcelist, gchar** targetlist, LwIoProgressCallback cb, gpointer data, GCancellable *cancellable, GError **error);
+  guint (*installer_classify_line) (LwDictionary *dictionary, gint index, const gchar *LINE);
   gchar ***patterns;  
 };
 
 //Methods
 GType lw_dictionary_get_type (void) G_GNUC_CONST;
 gboolean lw_dictionary_install (LwDictionary*, GCancellable*, GError**);
+gboolean lw_dictionary_update (LwDictionary*, GCancellable*, GError**);
 gboolean lw_dictionary_uninstall (LwDictionary*, LwIoProgressCallback, GError**);
 gchar* lw_dictionary_get_directory (GType);
 gchar* lw_dictionary_get_path (LwDictionary*);
@@ -72,6 +79,10 @@ gchar* lw_dictionary_directoryname_to_typename (const gchar*);
 gchar* lw_dictionary_get_directoryname (GType);
 
 gchar** lw_dictionary_get_installed_idlist (GType);
+gchar** lw_dictionary_get_manifest_idlist (GKeyFile*, GType);
+GKeyFile* lw_dictionary_load_manifest (void);
+gboolean lw_dictionary_write_manifest (GError**);
+LwDictionary* lw_dictionary_new_installed (GKeyFile*, const gchar*);
 
 void lw_dictionary_build_regex (LwDictionary*, LwQuery*, GError**);
 
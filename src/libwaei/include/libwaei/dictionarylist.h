@@ -70,6 +70,8 @@ void lw_dictionarylist_load_installable (LwDictionaryList*, LwPreferences*);
 void lw_dictionarylist_clear (LwDictionaryList*);
 
 gboolean lw_dictionarylist_installer_is_valid (LwDictionaryList*);
+gboolean lw_dictionarylist_install (LwDictionaryList*, gint, GCancellable*, GError**);
+gdouble lw_dictionarylist_installer_get_total_progress (LwDictionaryList*);
 
 GList* lw_dictionarylist_get_list (LwDictionaryList*);
 void lw_dictionarylist_sort_with_data (LwDictionaryList*, GCompareDataFunc, gpointer);
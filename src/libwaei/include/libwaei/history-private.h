@@ -4,10 +4,15 @@
 G_BEGIN_DECLS
 
 struct _LwHistoryPrivate {
-    GList *back;           //!< A GList of past search items
-    GList *forward;        //!< A GList where past search items get stacked when the user goes back.
+    GList *back;           //!< A GList of LwHistoryRecord of past searches
+    GList *forward;        //!< A GList where past search records get stacked when the user goes back.
+    gint back_length;
+    gint forward_length;
     gint max;
     gint time_delta;
+    gsize cache_size;      //!< Bytes of searches with their results the records may keep
+    gsize cached;          //!< Bytes of searches the records keep now
+    LwHistoryLog *log;     //!< Where added searches are also written or NULL.  Not owned by the history.
 };
 
 #define LW_HISTORY_GET_PRIVATE(object)(G_TYPE_INSTANCE_GET_PRIVATE ((object), LW_TYPE_HISTORY, LwHistoryPrivate));
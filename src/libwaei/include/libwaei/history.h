@@ -14,6 +14,24 @@ typedef enum {
 } LwHistoryClassSignalId;
 
 
+//!
+//! @brief What the history keeps of a search.  The search itself is only kept
+//!        while it fits in the result cache of the LwHistory.
+//!
+struct _LwHistoryRecord {
+  gchar *query;                 //!< The text that was searched for
+  gchar *dictionary_id;         //!< The lw_dictionary_build_id of the searched dictionary, written to the LwHistoryLog
+  LwDictionary *dictionary;     //!< A reference to the searched dictionary
+  LwSearchFlags flags;
+  gdouble scroll;               //!< Position the results were scrolled to, from 0.0 to 1.0
+  LwSearch *search;             //!< The search with its results or NULL if it has to be searched again
+  gsize size;                   //!< Bytes held by search
+};
+typedef struct _LwHistoryRecord LwHistoryRecord;
+
+typedef struct _LwHistoryLog LwHistoryLog; //!< See historylog.h
+
+
 //Boilerplate
 typedef struct _LwHistory LwHistory;
 typedef struct _LwHistoryClass LwHistoryClass;
@@ -45,6 +63,10 @@ struct _LwHistoryClass {
 
 
 //Methods
+LwHistoryRecord* lw_historyrecord_new (LwSearch*);
+void lw_historyrecord_free (LwHistoryRecord*);
+LwSearch* lw_historyrecord_take_search (LwHistoryRecord*, GError**);
+
 GType lw_history_get_type (void) G_GNUC_CONST;
 LwHistory* lw_history_new (const gint);
 
@@ -54,12 +76,14 @@ GList* lw_history_get_combined_list (LwHistory*);
 void lw_history_clear_forward_list (LwHistory*);
 void lw_history_clear_back_list (LwHistory*);
 
-void lw_history_add_search (LwHistory*, LwSearch*);
+void lw_history_add_search (LwHistory*, LwSearch*, gdouble);
+void lw_history_set_log (LwHistory*, LwHistoryLog*);
+void lw_history_log_search (LwHistory*, LwSearch*);
 
 gboolean lw_history_has_back (LwHistory*);
 gboolean lw_history_has_forward (LwHistory*);
-LwSearch* lw_history_go_back (LwHistory*, LwSearch*);
-LwSearch* lw_history_go_forward (LwHistory*, LwSearch*);
+LwSearch* lw_history_go_back (LwHistory*, LwSearch*, gdouble*);
+LwSearch* lw_history_go_forward (LwHistory*, LwSearch*, gdouble*);
 
 gboolean lw_history_has_relevance (LwHistory*, LwSearch*, gboolean);
 
@@ -0,0 +1,17 @@
+#ifndef LW_HISTORYLOG_INCLUDED
+#define LW_HISTORYLOG_INCLUDED
+
+#include <libwaei/history.h>
+
+G_BEGIN_DECLS
+
+LwHistoryLog* lw_historylog_new (const gchar*);
+void lw_historylog_free (LwHistoryLog*);
+
+gboolean lw_historylog_append (LwHistoryLog*, LwHistoryRecord*, GError**);
+gboolean lw_historylog_compact (LwHistoryLog*, GError**);
+gchar** lw_historylog_complete (LwHistoryLog*, const gchar*, gint);
+
+G_END_DECLS
+
+#endif
@@ -9,6 +9,12 @@ G_BEGIN_DECLS
 #define LW_IO_MAX_FGETS_LINE 5000
 #define LW_IO_ERROR "libwaei generic error"
 
+#define LW_IO_BUFFER_SIZE (256 * 1024)
+#define LW_IO_PROGRESS_STEP 0.001
+
+#define LW_IO_PIPE_CHUNK_SIZE LW_IO_BUFFER_SIZE
+#define LW_IO_PIPE_CAPACITY (LW_IO_PIPE_CHUNK_SIZE * 4)
+
 typedef gint (*LwIoProgressCallback) (gdouble percent, gpointer data);
 
 struct _LwIoProgressCallbackWithData {
@@ -27,6 +33,13 @@ typedef enum  {
   LW_IO_ENCODING_CONVERSION_ERROR
 } LwIoErrorTypes;
 
+typedef enum {
+  LW_IO_NAMES_PLACES_NAME = (1 << 0),
+  LW_IO_NAMES_PLACES_PLACE = (1 << 1)
+} LwIoNamesPlacesFlags;
+
+typedef struct _LwIoPipe LwIoPipe;
+
 void lw_io_write_file (const gchar*, const gchar*, gchar*, LwIoProgressCallback, gpointer, GError**);
 size_t lw_io_get_filesize (const gchar*);
 
@@ -38,6 +51,19 @@ gboolean lw_io_remove (const gchar*, GCancellable*, GError**);
 gboolean lw_io_download (const gchar*, const gchar*, LwIoProgressCallback, gpointer, GCancellable*, GError**);
 gboolean lw_io_gunzip_file (const gchar*, const gchar*, LwIoProgressCallback, gpointer, GCancellable*, GError **);
 gboolean lw_io_unzip_file (gchar*, LwIoProgressCallback, gpointer, GCancellable*, GError**);
+guint lw_io_classify_names_places_line (const gchar*);
+
+LwIoPipe* lw_io_pipe_new (gsize);
+void lw_io_pipe_free (LwIoPipe*);
+gboolean lw_io_pipe_push (LwIoPipe*, GByteArray*);
+GByteArray* lw_io_pipe_pop (LwIoPipe*);
+void lw_io_pipe_close (LwIoPipe*);
+void lw_io_pipe_abort (LwIoPipe*);
+gboolean lw_io_pipe_is_aborted (LwIoPipe*);
+
+gboolean lw_io_read_to_pipe (const gchar*, LwIoPipe*, LwIoProgressCallback, gpointer, GCancellable*, GError**);
+gboolean lw_io_gunzip_pipe (LwIoPipe*, LwIoPipe*, GCancellable*, GError**);
+gboolean lw_io_convert_pipe_encoding (LwIoPipe*, LwIoPipe*, const gchar*, const gchar*, GCancellable*, GError**);
 
 void lw_io_set_savepath (const gchar *);
 const gchar* lw_io_get_savepath (void);
@@ -0,0 +1,18 @@
+#ifndef LW_KANJIDICTIONARY_PRIVATE_INCLUDED
+#define LW_KANJIDICTIONARY_PRIVATE_INCLUDED
+
+G_BEGIN_DECLS
+
+struct _LwKanjiDictionaryPrivate {
+  GHashTable *offsets;  //!< The file offset of the line of each kanji, keyed by its codepoint
+  FILE *file;           //!< The dictionary file the lookups read from
+  gint64 mtime;         //!< The mtime of the file when the offsets were read
+  GMutex mutex;
+};
+
+#define LW_KANJIDICTIONARY_GET_PRIVATE(object)(G_TYPE_INSTANCE_GET_PRIVATE ((object), LW_TYPE_KANJIDICTIONARY, LwKanjiDictionaryPrivate));
+
+G_END_DECLS
+
+#endif
+
@@ -18,6 +18,7 @@ typedef struct _LwKanjiDictionaryPrivate LwKanjiDictionaryPrivate;
 
 struct _LwKanjiDictionary {
   LwDictionary object;
+  LwKanjiDictionaryPrivate *priv;
 };
 
 struct _LwKanjiDictionaryClass {
@@ -28,6 +29,8 @@ struct _LwKanjiDictionaryClass {
 LwDictionary* lw_kanjidictionary_new (const gchar*);
 GType lw_kanjidictionary_get_type (void) G_GNUC_CONST;
 
+LwResult* lw_kanjidictionary_lookup (LwDictionary*, gunichar);
+
 
 G_END_DECLS
 
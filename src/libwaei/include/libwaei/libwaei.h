@@ -4,6 +4,7 @@
 #include <libwaei/definitions.h>
 #include <libwaei/regex.h>
 #include <libwaei/utilities.h>
+#include <libwaei/trace.h>
 #include <libwaei/io.h>
 #include <libwaei/preferences.h>
 #include <libwaei/vocabulary.h>
@@ -17,6 +18,7 @@
 #include <libwaei/query.h>
 #include <libwaei/search.h>
 #include <libwaei/history.h>
+#include <libwaei/historylog.h>
 
 #ifdef WITH_MECAB
 #include <libwaei/morphology.h>
@@ -6,8 +6,13 @@
 G_BEGIN_DECLS
 
 struct _LwMorphologyEngine {
-  GMutex mutex;
-  mecab_t *mecab;
+  GMutex mutex;              //!< Guards the lattice pool and the cache
+  mecab_model_t *model;      //!< The dictionary model shared by every lattice
+  mecab_t *mecab;            //!< Tagger shared between threads through the lattice api
+  GSList *lattices;          //!< Idle lattices ready for another analysis
+  gboolean charset_is_utf8;  //!< Skip charset conversion when the dictionary is already UTF-8
+  GHashTable *cache;         //!< Input string to link in cache_queue
+  GQueue cache_queue;        //!< Cached analyses, most recently used first
 };
 typedef struct _LwMorphologyEngine LwMorphologyEngine;
 #define LW_MORPHOLOGYENGINE(obj) (LwMorphologyEngine*)obj
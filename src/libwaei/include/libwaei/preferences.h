@@ -27,6 +27,7 @@ G_BEGIN_DECLS
 #define LW_KEY_SPELLCHECK            "query-spellcheck"
 #define LW_KEY_SPELLCHECK_DICTIONARY "spellcheck-dictionary"
 #define LW_KEY_SEARCH_AS_YOU_TYPE    "search-as-you-type"
+#define LW_KEY_HISTORY_CACHE_SIZE    "history-result-cache-size"
 
 //////////////////////////
 #define LW_SCHEMA_VOCABULARY         "org.gnome.gwaei.vocabulary"
@@ -10,9 +10,6 @@ G_BEGIN_DECLS
 #define LW_RE_LOCATE_FLAGS  (0)
 #define LW_RE_EXIST_FLAGS   (0)
 
-void lw_regex_initialize (void);
-void lw_regex_free (void);
-
 typedef enum {
   LW_RE_NUMBER,
   LW_RE_STROKES,
@@ -22,6 +19,10 @@ typedef enum {
   LW_RE_TOTAL
 } LwRegexDataIndex;
 
+void lw_regex_initialize (void);
+void lw_regex_free (void);
+GRegex* lw_regex_get (LwRegexDataIndex);
+
 extern GRegex *lw_re[LW_RE_TOTAL + 1];
 
 G_END_DECLS
@@ -2,17 +2,28 @@
 #define LW_RESULT_INCLUDED
 
 #include <libwaei/io.h>
+#include <libwaei/query.h>
 
 G_BEGIN_DECLS
 
 #define LW_RESULT(object) (LwResult*) object
 
+//!
+//! @brief Where the query matched in the text of a result
+//!
+struct _LwResultSpan {
+    gint start;                  //!< Byte offset of the start of the match in the result text
+    gint end;                    //!< Byte offset of the end of the match in the result text
+};
+typedef struct _LwResultSpan LwResultSpan;
+
 //!
 //! @brief Primitive for storing lists of dictionaries
 //!
 
 struct _LwResult {
-    gchar text[LW_IO_MAX_FGETS_LINE];     //!< Character array holding the result line for the pointers to reference
+    gchar *text;                 //!< Character array holding the result line for the pointers to reference
+    gsize length;                //!< Bytes allocated for text, LW_IO_MAX_FGETS_LINE until the result is compacted
 
     //General result things
     LwRelevance relevance;
@@ -35,6 +46,9 @@ struct _LwResult {
 
     gboolean important; //!< Weather a word/phrase has a high frequency of usage.
 
+    GList *similar;     //!< Other results sharing this headword, collapsed into this one during the search
+    GArray *spans;      //!< The LwResultSpan of every match of the query, sorted by start and found once the search keeps the result if it has LW_SEARCH_FLAG_SPANS
+
 };
 typedef struct _LwResult LwResult;
 
@@ -45,8 +59,17 @@ void lw_result_init (LwResult*);
 void lw_result_deinit (LwResult*);
 
 gboolean lw_result_is_similar (LwResult*, LwResult*);
+gboolean lw_result_is_identical (LwResult*, LwResult*);
+gchar* lw_result_build_headword_key (LwResult*);
+void lw_result_add_similar (LwResult*, LwResult*);
 void lw_result_clear (LwResult*);
 
+void lw_result_compact (LwResult*);
+gsize lw_result_get_size (LwResult*);
+
+void lw_result_find_spans (LwResult*, LwQuery*);
+gboolean lw_result_next_span (LwResult*, const gchar*, gint*, gint*, gint*);
+
 G_END_DECLS
 
 #endif
@@ -34,11 +34,27 @@ typedef enum
   LW_SEARCH_FLAG_KATAKANA_TO_HIRAGANA = (1 << 4),
   LW_SEARCH_FLAG_ROOT_WORD = (1 << 5),
   //Last 16 bits are specific to LwSearchFlags
-  LW_SEARCH_FLAG_EXACT = (1 << 6)
+  LW_SEARCH_FLAG_EXACT = (1 << 6),
+  LW_SEARCH_FLAG_SPANS = (1 << 7)      //!< Record where the query matched in each result for highlighting
 } LwSearchFlags;
 
 typedef void(*LwSearchDataFreeFunc)(gpointer);
 
+//!
+//! @brief Where the time of a search went.  Times are in microseconds.
+//!
+struct _LwSearchStats {
+    gint64 elapsed;                           //!< Time from the start to the end of the scan
+    gint64 io_wait;                           //!< Time the scan was blocked instead of running, mostly on reads, or -1 if unknown
+    gint64 parse_time;                        //!< Time in parse_result, which includes reading the lines
+    gint64 compare_time[TOTAL_LW_RELEVANCE];  //!< Time in compare for each relevance
+    gint64 lines_scanned;                     //!< Dictionary entries parsed
+    gint64 lines_matched;                     //!< Entries that matched at any relevance
+    gint64 bytes_read;                        //!< Bytes of the dictionary read
+    gsize peak_result_memory;                 //!< Most memory held by results waiting to be taken
+};
+typedef struct _LwSearchStats LwSearchStats;
+
 //!
 //! @brief Primitive for storing search item information
 //!
@@ -50,6 +66,7 @@ struct _LwSearch {
     FILE* fd;                               //!< File descriptor for file search position
     GThread *thread;                        //!< Thread the search is processed in
     GMutex mutex;                          //!< Mutext to help ensure threadsafe operation
+    GCond cond;                            //!< Signaled when a result can be taken or the search stops
 
     LwSearchStatus status;                  //!< Used to test if a search is in progress.
     LwSearchFlags flags;
@@ -63,6 +80,7 @@ struct _LwSearch {
     gboolean cancel;
 
     GList *results[TOTAL_LW_RELEVANCE];
+    GHashTable *headwords;                  //!< Queued results by headword key for collapsing similar entries
 
     LwResult* result;               //!< Result line to store parsed result
 
@@ -70,6 +88,9 @@ struct _LwSearch {
 
     gint64 timestamp;
 
+    LwSearchStats stats;                    //!< Timing and throughput of the last run
+    gsize result_memory;                    //!< Memory held by results waiting to be taken
+
     LwSearchDataFreeFunc free_data_func;
 };
 typedef struct _LwSearch LwSearch;
@@ -92,6 +113,7 @@ gboolean lw_search_has_data (LwSearch*);
 
 gboolean  lw_search_has_results (LwSearch*);
 LwResult* lw_search_get_result (LwSearch*);
+LwResult* lw_search_wait_result (LwSearch*);
 void lw_search_parse_result_string (LwSearch*);
 void lw_search_cancel (LwSearch*);
 
@@ -110,6 +132,8 @@ gint lw_search_get_total_results (LwSearch*);
 gint lw_search_get_total_relevant_results (LwSearch*);
 gint lw_search_get_total_irrelevant_results (LwSearch*);
 
+void lw_search_get_stats (LwSearch*, LwSearchStats*);
+
 void lw_search_set_flags (LwSearch*, LwSearchFlags);
 LwSearchFlags lw_search_get_flags (LwSearch*);
 LwSearchFlags lw_search_get_flags_from_preferences (LwPreferences*);
@@ -0,0 +1,21 @@
+#ifndef LW_TRACE_INCLUDED
+#define LW_TRACE_INCLUDED
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define LW_TRACE_ENVIRONMENT_VARIABLE "LIBWAEI_TRACE"
+
+#define LW_TRACE_CATEGORY_SEARCH "search"
+#define LW_TRACE_CATEGORY_INSTALL "install"
+#define LW_TRACE_CATEGORY_GUI "gui"
+
+gboolean lw_trace_is_enabled (void);
+void lw_trace_begin (const gchar*, const gchar*, const gchar*);
+void lw_trace_end (const gchar*, const gchar*);
+void lw_trace_flush (void);
+
+G_END_DECLS
+
+#endif
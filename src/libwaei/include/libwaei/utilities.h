@@ -31,14 +31,19 @@ typedef enum {
   LW_ENCODING_TOTAL
 } LwEncoding;
 
+typedef enum {
+  LW_KANA_SCRIPT_HIRAGANA,
+  LW_KANA_SCRIPT_KATAKANA,
+  LW_KANA_SCRIPT_TOTAL
+} LwKanaScript;
+
 
 gchar* lw_util_build_filename (const LwFolderPath, const char*);
 const char* lw_util_get_compressionname (const LwCompression);
 const char* lw_util_get_encodingname (const LwEncoding);
 
 
-const char* lw_util_next_hira_char_from_roma (const char*);
-char* lw_util_roma_to_hira (const char*, char*);
+gchar* lw_util_romaji_to_kana (const gchar*, LwKanaScript);
 gboolean lw_util_str_roma_to_hira (const char*, char*, int);
 
 gboolean lw_util_is_hiragana_str (const char*);
@@ -27,6 +27,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
 #include <locale.h>
 
 #include <glib.h>
@@ -51,6 +52,35 @@ struct _LwIoProcessFdData {
 };
 typedef struct _LwIoProcessFdData LwIoProcessFdData; //!< Used for passing data to LwIo functions
 
+struct _LwIoPipe {
+  GMutex mutex;
+  GCond cond;
+  GQueue *chunks;          //!< GByteArray chunks waiting to be read
+  gsize length;            //!< Total bytes currently queued
+  gsize capacity;          //!< Writers block once this many bytes are queued
+  gboolean closed;         //!< The writer finished successfully
+  gboolean aborted;        //!< A stage failed or the install was cancelled
+};
+
+
+
+//!
+//! @brief Calls a progress callback only when the fraction moved far enough
+//!        since the last call, so large files don't flood the interface
+//! @param cb A LwIoProgressCallback or NULL
+//! @param data A gpointer to data to pass to the LwIoProgressCallback
+//! @param fraction The current progress
+//! @param reported The last reported progress, initialized to a negative number
+//!
+static void
+lw_io_report_progress (LwIoProgressCallback cb, gpointer data, gdouble fraction, gdouble *reported)
+{
+    if (cb == NULL) return;
+    if (fraction < 1.0 && fraction - *reported < LW_IO_PROGRESS_STEP) return;
+
+    *reported = fraction;
+    cb (fraction, data);
+}
 
 
 //!
@@ -145,68 +175,122 @@ lw_io_copy_with_encoding (const gchar           *SOURCE_PATH,
                           GCancellable          *cancellable,
                           GError               **error)
 {
-    if (*error != NULL) return FALSE;
+    if (error != NULL && *error != NULL) return FALSE;
 
     //Declarations
-    FILE* readfd = NULL;
-    FILE* writefd = NULL;
-    const gint MAX = 1024 * 2;
-    gchar source_buffer[MAX];
-    gchar target_buffer[MAX];
+    GQuark quark;
+    FILE* readfd;
+    FILE* writefd;
+    gchar *source_buffer;
+    gchar *target_buffer;
     gchar *sptr, *tptr;
-    size_t read, source_bytes_left, target_bytes_left;
-    gdouble fraction;
+    size_t read, carried, source_bytes_left, target_bytes_left;
+    size_t skipped;
+    gdouble reported;
     size_t position, filesize;
+    gboolean success;
+    gboolean is_cancelled;
     GIConv conv;
 
+    //Initializations
+    quark = g_quark_from_string (LW_IO_ERROR);
     filesize = lw_io_get_filesize (SOURCE_PATH);
     position = 0;
-
-    //Initializations
+    carried = 0;
+    skipped = 0;
+    reported = -1.0;
+    success = TRUE;
     readfd = fopen (SOURCE_PATH, "rb");
     writefd = fopen (TARGET_PATH, "wb");
     conv = g_iconv_open (TARGET_ENCODING, SOURCE_ENCODING);
+    source_buffer = g_malloc (LW_IO_BUFFER_SIZE);
+    target_buffer = g_malloc (LW_IO_BUFFER_SIZE);
+
+    if (readfd == NULL || writefd == NULL || conv == (GIConv) -1)
+    {
+      if (error != NULL) *error = g_error_new (quark, LW_IO_ENCODING_CONVERSION_ERROR, gettext("Could not convert %s from %s to %s"), SOURCE_PATH, SOURCE_ENCODING, TARGET_ENCODING);
+      success = FALSE;
+    }
 
-    //Read a chunk
-    while (ferror(readfd) == 0 && feof(readfd) == 0)
+    //Read a chunk after the bytes carried over from the last one
+    while (success && (read = fread(source_buffer + carried, sizeof(gchar), LW_IO_BUFFER_SIZE - carried, readfd)) > 0)
     {
-      read = fread(source_buffer, sizeof(gchar), MAX, readfd);
-      source_bytes_left = read;
+      is_cancelled = (cancellable != NULL && g_cancellable_is_cancelled (cancellable));
+      if (is_cancelled) { success = FALSE; break; }
+
+      position += read;
+      source_bytes_left = carried + read;
       sptr = source_buffer;
+      carried = 0;
 
       //Try to convert and write the chunk
-      while (source_bytes_left > 0 && ferror(writefd) == 0 && feof(writefd) == 0)
+      while (success && source_bytes_left > 0)
       {
-        target_bytes_left = MAX;
+        target_bytes_left = LW_IO_BUFFER_SIZE;
         tptr = target_buffer;
 
-        g_iconv (conv, &sptr, &source_bytes_left, &tptr, &target_bytes_left);
-        if (MAX != target_bytes_left) //Bytes were converted!
-        {
-          fwrite(target_buffer, sizeof(gchar), MAX - target_bytes_left, writefd); 
-        }
-        else if (source_bytes_left == MAX && target_bytes_left == MAX)
+        if (g_iconv (conv, &sptr, &source_bytes_left, &tptr, &target_bytes_left) == (gsize) -1)
         {
-          fprintf(stderr, "The file you are converting may be corrupt! Trying to skip a character...\n");
-          fseek(readfd, 1L - source_bytes_left, SEEK_CUR);
+          //The chunk ends in the middle of a character
+          if (errno == EINVAL)
+          {
+            memmove(source_buffer, sptr, source_bytes_left);
+            carried = source_bytes_left;
+            source_bytes_left = 0;
+          }
+          //The source is corrupt so skip a byte and try again
+          else if (errno == EILSEQ)
+          {
+            sptr++;
+            source_bytes_left--;
+            skipped++;
+          }
+          else if (errno != E2BIG)
+          {
+            if (error != NULL) *error = g_error_new (quark, LW_IO_ENCODING_CONVERSION_ERROR, gettext("Could not convert %s from %s to %s"), SOURCE_PATH, SOURCE_ENCODING, TARGET_ENCODING);
+            success = FALSE;
+          }
         }
-        else if (source_bytes_left > 0) //Bytes failed to convert!
+
+        if (LW_IO_BUFFER_SIZE != target_bytes_left) //Bytes were converted!
         {
-          fseek(readfd, -source_bytes_left, SEEK_CUR);
-          source_bytes_left = 0;
+          if (fwrite(target_buffer, sizeof(gchar), LW_IO_BUFFER_SIZE - target_bytes_left, writefd) != LW_IO_BUFFER_SIZE - target_bytes_left)
+          {
+            if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), TARGET_PATH);
+            success = FALSE;
+          }
         }
       }
-      position = ftell(readfd);
-      fraction = (gdouble) position / (gdouble) filesize;
-      if (cb != NULL) cb (fraction, data);
+
+      if (filesize > 0) lw_io_report_progress (cb, data, (gdouble) position / (gdouble) filesize, &reported);
+    }
+
+    if (success && readfd != NULL && ferror(readfd) != 0)
+    {
+      if (error != NULL) *error = g_error_new (quark, LW_IO_READ_ERROR, gettext("Could not read %s"), SOURCE_PATH);
+      success = FALSE;
     }
 
+    if (skipped > 0 || carried > 0)
+    {
+      fprintf(stderr, "The file you are converting may be corrupt! %" G_GSIZE_FORMAT " bytes were skipped.\n", skipped + carried);
+    }
+
+    if (success) lw_io_report_progress (cb, data, 1.0, &reported);
+
     //Cleanup
-    g_iconv_close (conv);
-    fclose(readfd);
-    fclose(writefd);
+    if (conv != (GIConv) -1) g_iconv_close (conv);
+    if (readfd != NULL) fclose(readfd); readfd = NULL;
+    if (writefd != NULL && fclose(writefd) != 0 && success)
+    {
+      if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), TARGET_PATH);
+      success = FALSE;
+    }
+    writefd = NULL;
+    g_free (source_buffer); source_buffer = NULL;
+    g_free (target_buffer); target_buffer = NULL;
 
-    return TRUE;
+    return success;
 }
 
 
@@ -369,46 +453,124 @@ lw_io_copy (const gchar           *SOURCE_PATH,
             GCancellable          *cancellable,
             GError               **error)
 {
-    if (*error != NULL) return FALSE;
+    if (error != NULL && *error != NULL) return FALSE;
 
     //Declarations
+    GQuark quark;
     FILE *infd;
     FILE *outfd;
     size_t chunk;
     size_t end;
     size_t curpos;
-    const int MAX = 1024;
-    char buffer[MAX];
-    double fraction;
+    gchar *buffer;
+    gdouble reported;
+    gboolean success;
     gboolean is_cancelled;
 
     //Initalizations
+    quark = g_quark_from_string (LW_IO_ERROR);
     infd = fopen(SOURCE_PATH, "rb");
     outfd = fopen(TARGET_PATH, "wb");
-    chunk = 1;
+    buffer = g_malloc (LW_IO_BUFFER_SIZE);
     end = lw_io_get_filesize (SOURCE_PATH);
     curpos = 0;
-    fraction = 0.0;
+    reported = -1.0;
+    success = (infd != NULL && outfd != NULL);
+
+    if (!success && error != NULL)
+      *error = g_error_new (quark, LW_IO_COPY_ERROR, gettext("Could not copy %s to %s"), SOURCE_PATH, TARGET_PATH);
 
-    while (chunk)
+    while (success)
     {
       is_cancelled = (cancellable != NULL && g_cancellable_is_cancelled (cancellable));
-      if (is_cancelled) break; 
+      if (is_cancelled) { success = FALSE; break; }
 
-      fraction = ((double) curpos) / ((double) end);
-      if (cb != NULL) cb (fraction, data);
-      chunk = fread(buffer, sizeof(char), MAX, infd);
-      chunk = fwrite(buffer, sizeof(char), chunk, outfd);
+      if (end > 0) lw_io_report_progress (cb, data, ((gdouble) curpos) / ((gdouble) end), &reported);
+
+      chunk = fread(buffer, sizeof(gchar), LW_IO_BUFFER_SIZE, infd);
+      if (chunk == 0) break;
+
+      if (fwrite(buffer, sizeof(gchar), chunk, outfd) != chunk)
+      {
+        if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), TARGET_PATH);
+        success = FALSE;
+      }
       curpos += chunk;
     }
-    fraction = 1.0;
-    if (cb != NULL) cb (fraction, data);
+
+    if (success && ferror(infd) != 0)
+    {
+      if (error != NULL) *error = g_error_new (quark, LW_IO_READ_ERROR, gettext("Could not read %s"), SOURCE_PATH);
+      success = FALSE;
+    }
+
+    if (success) lw_io_report_progress (cb, data, 1.0, &reported);
 
     //Cleanup
-    fclose(infd);
-    fclose(outfd);
+    if (infd != NULL) fclose(infd); infd = NULL;
+    if (outfd != NULL && fclose(outfd) != 0 && success)
+    {
+      if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), TARGET_PATH);
+      success = FALSE;
+    }
+    outfd = NULL;
+    g_free (buffer); buffer = NULL;
 
-    return (error == NULL && *error == NULL);;
+    return success;
+}
+
+
+//!
+//! @brief Loads the radicals dictionary into a hash table keyed by kanji.  The
+//!        values are the radicals part of each line including the leading space
+//!        so they can be spliced into kanjidic lines as they are.
+//! @param RADICALS_DICTIONARY_PATH raddic dictionary path
+//! @param error pointer to a GError to write errors to
+//! @returns A GHashTable to be freed with g_hash_table_unref or NULL on error
+//!
+static GHashTable*
+lw_io_load_radicals_table (const gchar  *RADICALS_DICTIONARY_PATH,
+                           GError      **error)
+{
+    //Declarations
+    GHashTable *table;
+    FILE *radicals_file;
+    char radicals_input[LW_IO_MAX_FGETS_LINE];
+    char *key_end, *value, *value_end;
+    GQuark quark;
+
+    //Initializations
+    radicals_file = fopen(RADICALS_DICTIONARY_PATH, "r");
+    if (radicals_file == NULL)
+    {
+      quark = g_quark_from_string (LW_IO_ERROR);
+      if (error != NULL) *error = g_error_new (quark, LW_IO_READ_ERROR, gettext("Could not read %s"), RADICALS_DICTIONARY_PATH);
+      return NULL;
+    }
+    table = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    //Lines look like "亜 : 一 口" and the radicals are copied from the space before the first one
+    while (fgets(radicals_input, LW_IO_MAX_FGETS_LINE, radicals_file) != NULL)
+    {
+      if (radicals_input[0] == '#') continue;
+
+      key_end = strchr (radicals_input, ' ');
+      if (key_end == NULL || key_end == radicals_input || key_end[1] == '\0') continue;
+
+      value = key_end + 2;
+      value_end = value + strlen (value);
+      if (value_end > value && *(value_end - 1) == '\n') value_end--;
+
+      *key_end = '\0';
+      //The first line for a kanji wins like the old linear search
+      if (g_hash_table_lookup (table, radicals_input) == NULL)
+        g_hash_table_insert (table, g_strdup (radicals_input), g_strndup (value, value_end - value));
+    }
+
+    //Cleanup
+    fclose(radicals_file); radicals_file = NULL;
+
+    return table;
 }
 
 
@@ -434,107 +596,206 @@ lw_io_create_mix_dictionary (const gchar           *OUTPUT_PATH,
     if (error != NULL && *error != NULL) return FALSE;
 
     //Declarations
-    FILE *output_file, *kanji_file, *radicals_file;
-    char radicals_input[LW_IO_MAX_FGETS_LINE];
+    FILE *output_file, *kanji_file;
+    GHashTable *radicals;
     char kanji_input[LW_IO_MAX_FGETS_LINE];
-    char output[LW_IO_MAX_FGETS_LINE * 2];
-    char *radicals_ptr, *kanji_ptr, *output_ptr, *temp_ptr;
+    char *kanji_end;
+    const char *radicals_value;
+    GQuark quark;
 
     size_t curpos;
     size_t end;
-    double fraction;
+    gdouble reported;
+    gboolean success;
     gboolean is_cancelled;
 
     //Initializations
+    quark = g_quark_from_string (LW_IO_ERROR);
+    radicals = lw_io_load_radicals_table (RADICALS_DICTIONARY_PATH, error);
+    if (radicals == NULL) return FALSE;
     kanji_file =  fopen(KANJI_DICTIONARY_PATH, "r");
-    radicals_file = fopen(RADICALS_DICTIONARY_PATH, "r");
     output_file = fopen(OUTPUT_PATH, "w");
-    radicals_ptr = NULL;
-    kanji_ptr = NULL;
-    output_ptr = NULL;
+    success = (kanji_file != NULL && output_file != NULL);
+    if (!success && error != NULL)
+      *error = g_error_new (quark, LW_IO_COPY_ERROR, gettext("Could not copy %s to %s"), KANJI_DICTIONARY_PATH, OUTPUT_PATH);
 
     curpos = 0;
     end = lw_io_get_filesize (KANJI_DICTIONARY_PATH);
-    fraction = 0.0;
+    reported = -1.0;
 
-    //Loop through the kanji file
-    while (fgets(kanji_input, LW_IO_MAX_FGETS_LINE, kanji_file) != NULL)
+    //Stream through the kanji file once, looking up the radicals of each kanji
+    while (success && fgets(kanji_input, LW_IO_MAX_FGETS_LINE, kanji_file) != NULL)
     {
       is_cancelled = (cancellable != NULL && g_cancellable_is_cancelled (cancellable));
-      if (is_cancelled) break;
+      if (is_cancelled) { success = FALSE; break; }
 
-      fraction = ((double) curpos)/((double) end);
-      if (cb != NULL) cb (fraction, data);
+      if (end > 0) lw_io_report_progress (cb, data, ((gdouble) curpos)/((gdouble) end), &reported);
 
       curpos += strlen (kanji_input);
 
       if (kanji_input[0] == '#') continue;
 
-      kanji_ptr = kanji_input;
-      output_ptr = output;
-
-      //1. Copy the kanji character from the kanji line
-      while (*kanji_ptr != ' ')
+      //The kanji character is everything before the first space
+      kanji_end = strchr (kanji_input, ' ');
+      if (kanji_end == NULL)
       {
-        *output_ptr = *kanji_ptr;
-        output_ptr++;
-        kanji_ptr++;
+        fputs(kanji_input, output_file);
+        continue;
       }
 
-      //2. Find the relevent radical line and insert it if available
-      rewind (radicals_file);
-      while (fgets(radicals_input, LW_IO_MAX_FGETS_LINE, radicals_file) != NULL)
-      {
-        //Check for a match
-        temp_ptr = kanji_input;
-        radicals_ptr = radicals_input;
-        while (*radicals_ptr != ' ' && *radicals_ptr == *temp_ptr)
-        {
-          temp_ptr++;
-          radicals_ptr++;
-        }
+      *kanji_end = '\0';
+      radicals_value = g_hash_table_lookup (radicals, kanji_input);
+      *kanji_end = ' ';
 
-        //If a match is found...
-        if (*radicals_ptr == ' ')
-        {
-          //Skip over the colon
-          radicals_ptr++;
-          radicals_ptr++;
-   
-          //Copy the data
-          while (*(radicals_ptr + 1) != '\0')
-          {
-            *output_ptr = *radicals_ptr;
-            output_ptr++;
-            radicals_ptr++;
-          }
+      //Write the kanji, its radicals if any and then the rest of the kanji line
+      fwrite(kanji_input, sizeof(char), kanji_end - kanji_input, output_file);
+      if (radicals_value != NULL) fputs(radicals_value, output_file);
+      fputs(kanji_end, output_file);
+    }
 
-          break;
-        }
-      }
+    if (success && ferror(output_file) != 0)
+    {
+      if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), OUTPUT_PATH);
+      success = FALSE;
+    }
+
+    if (success) lw_io_report_progress (cb, data, 1.0, &reported);
+
+    //Cleanup
+    if (kanji_file != NULL) fclose(kanji_file); kanji_file = NULL;
+    if (output_file != NULL) fclose(output_file); output_file = NULL;
+    g_hash_table_unref (radicals); radicals = NULL;
 
-      //3. Copy the rest of the kanji line to output
-      while (*kanji_ptr != '\0')
+    return success;
+}
+
+
+/*
+  Current composition of the Enamdic dictionary
+  ----------------------------------------------
+  s - surname (138,500)
+  p - place-name (99,500)
+  u - person name, either given or surname, as-yet unclassified (139,000) 
+  g - given name, as-yet not classified by sex (64,600)
+  f - female given name (106,300)
+  m - male given name (14,500)
+  h - full (family plus given) name of a particular person (30,500)
+  pr - product name (55)
+  co - company name (34)
+  ---------------------------------------------
+*/
+typedef enum {
+  LW_IO_ENAMDIC_TAG_S  = (1 << 0),
+  LW_IO_ENAMDIC_TAG_P  = (1 << 1),
+  LW_IO_ENAMDIC_TAG_U  = (1 << 2),
+  LW_IO_ENAMDIC_TAG_G  = (1 << 3),
+  LW_IO_ENAMDIC_TAG_F  = (1 << 4),
+  LW_IO_ENAMDIC_TAG_M  = (1 << 5),
+  LW_IO_ENAMDIC_TAG_H  = (1 << 6),
+  LW_IO_ENAMDIC_TAG_PR = (1 << 7),
+  LW_IO_ENAMDIC_TAG_CO = (1 << 8),
+  LW_IO_ENAMDIC_TAG_ST = (1 << 9)
+} LwIoEnamdicTag;
+
+#define LW_IO_ENAMDIC_NAME_TAGS (LW_IO_ENAMDIC_TAG_S | LW_IO_ENAMDIC_TAG_U | LW_IO_ENAMDIC_TAG_G | LW_IO_ENAMDIC_TAG_F | LW_IO_ENAMDIC_TAG_M | LW_IO_ENAMDIC_TAG_H | LW_IO_ENAMDIC_TAG_PR | LW_IO_ENAMDIC_TAG_CO)
+#define LW_IO_ENAMDIC_PLACE_TAGS (LW_IO_ENAMDIC_TAG_P | LW_IO_ENAMDIC_TAG_ST)
+
+
+//!
+//! @brief Looks up a one or two letter Enamdic tag, ignoring case
+//! @returns The LwIoEnamdicTag or 0 if it isn't a tag
+//!
+static guint
+lw_io_get_enamdic_tag (const gchar *TAG, gint length)
+{
+    //Declarations
+    gchar first, second;
+
+    //Initializations
+    first = g_ascii_tolower (TAG[0]);
+    second = (length > 1) ? g_ascii_tolower (TAG[1]) : '\0';
+
+    if (length == 1)
+    {
+      switch (first)
       {
-        *output_ptr = *kanji_ptr;
-        output_ptr++;
-        kanji_ptr++;
+        case 's': return LW_IO_ENAMDIC_TAG_S;
+        case 'p': return LW_IO_ENAMDIC_TAG_P;
+        case 'u': return LW_IO_ENAMDIC_TAG_U;
+        case 'g': return LW_IO_ENAMDIC_TAG_G;
+        case 'f': return LW_IO_ENAMDIC_TAG_F;
+        case 'm': return LW_IO_ENAMDIC_TAG_M;
+        case 'h': return LW_IO_ENAMDIC_TAG_H;
+        default: return 0;
       }
+    }
 
-      //4. Close off the string and write it to the file
-      *output_ptr = '\0';
-      fputs(output, output_file);
-      output[0] = '\0';
+    if (first == 'p' && second == 'r') return LW_IO_ENAMDIC_TAG_PR;
+    if (first == 'c' && second == 'o') return LW_IO_ENAMDIC_TAG_CO;
+    if (first == 's' && second == 't') return LW_IO_ENAMDIC_TAG_ST;
+
+    return 0;
+}
+
+
+//!
+//! @brief Collects every tag of an Enamdic line in one pass.  A tag is one or two
+//!        letters opened by a parenthesis or comma and closed by a parenthesis or
+//!        comma, like the "s" and "p" in "(s,p)".
+//! @param LINE A NULL terminated line from the Enamdic dictionary
+//! @returns A mask of LwIoEnamdicTag
+//!
+static guint
+lw_io_parse_enamdic_tags (const gchar *LINE)
+{
+    //Declarations
+    const gchar *ptr;
+    const gchar *tag;
+    guint mask;
+    gint length;
+
+    //Initializations
+    mask = 0;
+
+    for (ptr = LINE; *ptr != '\0'; ptr++)
+    {
+      if (*ptr != '(' && *ptr != ',') continue;
+
+      tag = ptr + 1;
+      for (length = 0; length < 2 && g_ascii_isalpha (tag[length]); length++);
+
+      if (length > 0 && (tag[length] == ')' || tag[length] == ','))
+        mask |= lw_io_get_enamdic_tag (tag, length);
     }
-    fraction = 1.0;
-    if (cb != NULL) cb (fraction, data);
 
-    //Cleanup
-    fclose(kanji_file);
-    fclose(output_file);
-    fclose(radicals_file);
+    return mask;
+}
 
-    return TRUE;
+
+//!
+//! @brief Decides which of the split Names and Places dictionaries an Enamdic
+//!        line belongs in.  A line can belong in both.
+//! @param LINE A NULL terminated line from the Enamdic dictionary
+//! @returns A mask of LwIoNamesPlacesFlags
+//!
+guint
+lw_io_classify_names_places_line (const gchar *LINE)
+{
+    //Sanity checks
+    g_return_val_if_fail (LINE != NULL, 0);
+
+    //Declarations
+    guint tags;
+    guint mask;
+
+    //Initializations
+    tags = lw_io_parse_enamdic_tags (LINE);
+    mask = 0;
+
+    if (tags & LW_IO_ENAMDIC_NAME_TAGS) mask |= LW_IO_NAMES_PLACES_NAME;
+    if (tags & LW_IO_ENAMDIC_PLACE_TAGS) mask |= LW_IO_NAMES_PLACES_PLACE;
+
+    return mask;
 }
 
 
@@ -558,88 +819,72 @@ lw_io_split_places_from_names_dictionary (const gchar           *OUTPUT_NAMES_PA
 {
     if (error != NULL && *error != NULL) return FALSE;
 
-    /*
-      Current composition of the Enamdic dictionary
-      ----------------------------------------------
-      s - surname (138,500)
-      p - place-name (99,500)
-      u - person name, either given or surname, as-yet unclassified (139,000) 
-      g - given name, as-yet not classified by sex (64,600)
-      f - female given name (106,300)
-      m - male given name (14,500)
-      h - full (family plus given) name of a particular person (30,500)
-      pr - product name (55)
-      co - company name (34)
-      ---------------------------------------------
-    */
-
     //Declarations
+    GQuark quark;
     char buffer[LW_IO_MAX_FGETS_LINE];
     FILE *inputf;
+    FILE *placesf;
+    FILE *namesf;
     size_t curpos;
     size_t end;
-    double fraction;
+    gdouble reported;
+    gboolean success;
     gboolean is_cancelled;
-
-    FILE *placesf;
-    GRegex *re_place;
-    const gchar *place_pattern = "([\\(,])((p)|(st))([\\),])";
-    int  place_write_error;
-
-    FILE *namesf;
-    GRegex *re_name;
-    const gchar *name_pattern = "([\\(,])((s)|(u)|(g)|(f)|(m)|(h)|(pr)|(co))([\\),])";
-    int  name_write_error;
+    guint mask;
 
     //Initializations
+    quark = g_quark_from_string (LW_IO_ERROR);
     inputf = fopen(INPUT_NAMES_PLACES_PATH, "r");
-    curpos = 0;
-    end = lw_io_get_filesize (INPUT_NAMES_PLACES_PATH);
-    fraction = 0.0;
-
-    re_place = g_regex_new (place_pattern,  LW_RE_COMPILE_FLAGS, LW_RE_LOCATE_FLAGS, error);
     placesf = fopen(OUTPUT_PLACES_PATH, "w");
-    place_write_error = 0;
-
-    re_name = g_regex_new (name_pattern,  LW_RE_COMPILE_FLAGS, LW_RE_LOCATE_FLAGS, error);
     namesf = fopen(OUTPUT_NAMES_PATH, "w");
-    name_write_error  = 0;
+    curpos = 0;
+    end = lw_io_get_filesize (INPUT_NAMES_PLACES_PATH);
+    reported = -1.0;
+    success = (inputf != NULL && placesf != NULL && namesf != NULL);
 
+    if (success)
+    {
+      setvbuf (inputf, NULL, _IOFBF, LW_IO_BUFFER_SIZE);
+      setvbuf (placesf, NULL, _IOFBF, LW_IO_BUFFER_SIZE);
+      setvbuf (namesf, NULL, _IOFBF, LW_IO_BUFFER_SIZE);
+    }
+    else if (error != NULL)
+    {
+      *error = g_error_new (quark, LW_IO_COPY_ERROR, gettext("Could not split %s"), INPUT_NAMES_PLACES_PATH);
+    }
 
     //Start writing the child files
-    while (fgets(buffer, LW_IO_MAX_FGETS_LINE, inputf) != NULL &&
-           place_write_error != EOF &&
-           name_write_error  != EOF &&
-           *error == NULL)
+    while (success && fgets(buffer, LW_IO_MAX_FGETS_LINE, inputf) != NULL)
     {
       is_cancelled = (cancellable != NULL && g_cancellable_is_cancelled (cancellable));
-      if (is_cancelled) break;
+      if (is_cancelled) { success = FALSE; break; }
 
-      fraction = ((double) curpos) / ((double) end);
-      if (cb != NULL) cb (fraction, data);
+      if (end > 0) lw_io_report_progress (cb, data, ((gdouble) curpos) / ((gdouble) end), &reported);
 
-      if (placesf != NULL && g_regex_match (re_place, buffer, 0, NULL))
-        place_write_error = fputs(buffer, placesf);
-      if (namesf != NULL && g_regex_match(re_name, buffer, 0, NULL))
-        name_write_error =  fputs(buffer, namesf);
+      mask = lw_io_classify_names_places_line (buffer);
+      if ((mask & LW_IO_NAMES_PLACES_PLACE) && fputs(buffer, placesf) == EOF) success = FALSE;
+      if ((mask & LW_IO_NAMES_PLACES_NAME) && fputs(buffer, namesf) == EOF) success = FALSE;
       curpos += strlen(buffer);
+
+      if (!success && error != NULL)
+        *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not split %s"), INPUT_NAMES_PLACES_PATH);
     }
-    fraction = 1.0;
-    if (cb != NULL) cb (fraction, data);
+
+    if (success) lw_io_report_progress (cb, data, 1.0, &reported);
 
     //Cleanup
-    fclose(inputf);
-    fclose(placesf);
-    fclose(namesf);
-    g_regex_unref (re_place);
-    g_regex_unref (re_name);
+    if (inputf != NULL) fclose(inputf); inputf = NULL;
+    if (placesf != NULL && fclose(placesf) != 0) success = FALSE; placesf = NULL;
+    if (namesf != NULL && fclose(namesf) != 0) success = FALSE; namesf = NULL;
 
-    return (place_write_error != EOF && name_write_error != EOF);
+    return success;
 }
 
 
 //!
-//! @brief Decompresses a gzip file
+//! @brief Decompresses a gzip file.  Like gzip -d, concatenated members are
+//!        decompressed one after another and data after the last member that
+//!        isn't another member is ignored.
 //! @param SOURCE_PATH The path to the file that is gzipped
 //! @param TARGET_PATH The path to write the uncompressed file to
 //! @param cb A LwIoProgressCallback function to give progress feedback or NULL
@@ -657,41 +902,125 @@ lw_io_gunzip_file (const gchar           *SOURCE_PATH,
     if (error != NULL && *error != NULL) return FALSE;
 
     //Declarations
-    gzFile source;
+    GQuark quark;
+    FILE *source;
     FILE *target;
-    int read;
-    const int MAX = 1024;
-    char buffer[MAX];
-    gdouble fraction;
+    z_stream stream;
+    guint8 *inbuffer;
+    guint8 *outbuffer;
+    size_t read, written;
+    gdouble reported;
     size_t filesize, position;
-    position = 0;
+    gboolean success;
+    gboolean more_output;
+    gboolean is_cancelled;
+    gboolean completed;
+    gboolean member_output;
+    gboolean trailing;
+    int status;
 
-    source = gzopen (SOURCE_PATH, "rb");
-    if (source != NULL)
+    //Initializations
+    quark = g_quark_from_string (LW_IO_ERROR);
+    memset(&stream, 0, sizeof(z_stream));
+    completed = FALSE;
+    member_output = FALSE;
+    trailing = FALSE;
+    filesize = lw_io_get_filesize (SOURCE_PATH);
+    position = 0;
+    reported = -1.0;
+    status = Z_OK;
+    source = fopen(SOURCE_PATH, "rb");
+    target = fopen(TARGET_PATH, "wb");
+    inbuffer = g_malloc (LW_IO_BUFFER_SIZE);
+    outbuffer = g_malloc (LW_IO_BUFFER_SIZE);
+    success = (source != NULL && target != NULL);
+
+    //16 + MAX_WBITS tells zlib to expect a gzip header
+    if (!success || inflateInit2 (&stream, 16 + MAX_WBITS) != Z_OK)
     {
-      filesize = lw_io_get_filesize (SOURCE_PATH);
-
-      target = fopen(TARGET_PATH, "wb");
-      if (target != NULL)
+      if (error != NULL) *error = g_error_new (quark, LW_IO_DECOMPRESSION_ERROR, gettext("Could not decompress %s"), SOURCE_PATH);
+      success = FALSE;
+    }
+    else
+    {
+      while (success && (read = fread(inbuffer, sizeof(guint8), LW_IO_BUFFER_SIZE, source)) > 0)
       {
-        do {
-          read = gzread (source, buffer, MAX);
-          if (read > 0) 
+        is_cancelled = (cancellable != NULL && g_cancellable_is_cancelled (cancellable));
+        if (is_cancelled) { success = FALSE; break; }
+
+        position += read;
+        if (trailing) continue;
+        stream.next_in = inbuffer;
+        stream.avail_in = read;
+        more_output = FALSE;
+
+        while (success && (stream.avail_in > 0 || more_output))
+        {
+          //Concatenated gzip members are decompressed one after another
+          if (status == Z_STREAM_END && stream.avail_in > 0)
+          {
+            inflateReset (&stream);
+            member_output = FALSE;
+          }
+
+          stream.next_out = outbuffer;
+          stream.avail_out = LW_IO_BUFFER_SIZE;
+
+          status = inflate (&stream, Z_NO_FLUSH);
+          if (status == Z_DATA_ERROR && completed && !member_output)
           {
-            position += MAX;
-            if (position > filesize) position = filesize;
-            fraction = (gdouble) position / (gdouble) filesize;
-            if (cb != NULL) cb (fraction, data);
-            fwrite(buffer, sizeof(char), read, target);
+            //What follows the last member isn't gzip data
+            trailing = TRUE;
+            status = Z_STREAM_END;
+            break;
           }
-        } while (read > 0);
+          if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+          {
+            if (error != NULL) *error = g_error_new (quark, LW_IO_DECOMPRESSION_ERROR, gettext("Could not decompress %s"), SOURCE_PATH);
+            success = FALSE;
+            break;
+          }
+
+          if (status == Z_STREAM_END) completed = TRUE;
+          more_output = (stream.avail_out == 0);
+          written = LW_IO_BUFFER_SIZE - stream.avail_out;
+          if (written > 0) member_output = TRUE;
+          if (written > 0 && fwrite(outbuffer, sizeof(guint8), written, target) != written)
+          {
+            if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), TARGET_PATH);
+            success = FALSE;
+          }
+        }
+
+        if (filesize > 0) lw_io_report_progress (cb, data, (gdouble) position / (gdouble) filesize, &reported);
+      }
 
-        fclose(target); target = NULL;
+      //Trailing bytes too short to be rejected as a gzip header are ignored as well
+      if (status != Z_STREAM_END && completed && !member_output) status = Z_STREAM_END;
+
+      if (success && (ferror(source) != 0 || status != Z_STREAM_END))
+      {
+        if (error != NULL) *error = g_error_new (quark, LW_IO_DECOMPRESSION_ERROR, gettext("Could not decompress %s"), SOURCE_PATH);
+        success = FALSE;
       }
-      gzclose(source); source = NULL;
+
+      inflateEnd (&stream);
+    }
+
+    if (success) lw_io_report_progress (cb, data, 1.0, &reported);
+
+    //Cleanup
+    if (source != NULL) fclose(source); source = NULL;
+    if (target != NULL && fclose(target) != 0 && success)
+    {
+      if (error != NULL) *error = g_error_new (quark, LW_IO_WRITE_ERROR, gettext("Could not write %s"), TARGET_PATH);
+      success = FALSE;
     }
+    target = NULL;
+    g_free (inbuffer); inbuffer = NULL;
+    g_free (outbuffer); outbuffer = NULL;
 
-    return (error == NULL || *error == NULL);
+    return success;
 } 
 
 
@@ -725,22 +1054,11 @@ lw_io_get_filesize (const gchar *URI)
     g_assert (g_file_test (URI, G_FILE_TEST_IS_REGULAR));
 
     //Declarations
-    const int MAX_CHUNK = 128;
-    char buffer[MAX_CHUNK];
-    FILE *file;
-    size_t size;
-
-    //Initializations
-    file = fopen(URI, "rb");
-    size = 0;
+    GStatBuf info;
 
-    while (file != NULL && ferror(file) == 0 && feof(file) == 0)
-        size += fread(buffer, sizeof(char), MAX_CHUNK, file);
+    if (g_stat (URI, &info) != 0) return 0;
 
-    //Cleanup
-    fclose(file);
-
-    return size;
+    return (size_t) info.st_size;
 }
 
 
@@ -755,12 +1073,11 @@ gpointer _stdin_func (gpointer data)
     g_return_val_if_fail (data != NULL, NULL);
 
     //Declarations
-    const int MAX_CHUNK = 128;
-    char buffer[MAX_CHUNK];
+    gchar *buffer;
     size_t chunk;
     size_t curpos;
     size_t end;
-    double fraction;
+    gdouble reported;
     FILE *file;
     FILE *stream;
     LwIoProcessFdData* in;
@@ -771,31 +1088,30 @@ gpointer _stdin_func (gpointer data)
 
     //Initalizations
     in = data;
+    buffer = g_malloc (LW_IO_BUFFER_SIZE);
     chunk = 0;
     curpos = 0;
     end = lw_io_get_filesize (in->uri);
-    fraction = 0.0;
+    reported = -1.0;
     file = fopen(in->uri, "rb");
     stream = fdopen(in->fd, "ab");
     cancellable = in->cancellable;
 
-    while (file != NULL && ferror(file) == 0 && feof(file) == 0)
+    while (file != NULL && ferror(file) == 0 && feof(file) == 0 && ferror(stream) == 0)
     {
       is_cancelled = (cancellable != NULL && g_cancellable_is_cancelled (cancellable));
       if (is_cancelled) break;
 
-      fraction = ((double) curpos / (double) end);
-      if (in->cb != NULL) in->cb (fraction, in->data);
+      if (end > 0) lw_io_report_progress (in->cb, in->data, ((gdouble) curpos / (gdouble) end), &reported);
 
-      chunk = fread(buffer, sizeof(char), MAX_CHUNK, file);
+      chunk = fread(buffer, sizeof(gchar), LW_IO_BUFFER_SIZE, file);
       curpos += chunk;
-      chunk = fwrite(buffer, sizeof(char), chunk, stream);
-      fflush(stream);
+      chunk = fwrite(buffer, sizeof(gchar), chunk, stream);
     }
-    fraction = 1.0;
-    if (in->cb != NULL) in->cb (fraction, in->data);
+    fflush(stream);
+    lw_io_report_progress (in->cb, in->data, 1.0, &reported);
 
-    if (ferror(file) != 0)
+    if (file == NULL || ferror(file) != 0)
     {
       domain = g_quark_from_string (LW_IO_ERROR);
       message = gettext("Unable to read data from the input file.");
@@ -809,8 +1125,9 @@ gpointer _stdin_func (gpointer data)
     }
 
     //Cleanup
-    fclose(file);
+    if (file != NULL) fclose(file); file = NULL;
     fclose(stream);
+    g_free (buffer); buffer = NULL;
 
     return (in->error);
 }
@@ -824,8 +1141,7 @@ gpointer _stdin_func (gpointer data)
 gpointer _stdout_func (gpointer data)
 {
     //Declarations
-    const int MAX_CHUNK = 128;
-    char buffer[MAX_CHUNK];
+    gchar *buffer;
     size_t chunk;
     size_t curpos;
     FILE *file;
@@ -838,6 +1154,7 @@ gpointer _stdout_func (gpointer data)
 
     //Initalizations
     out = data;
+    buffer = g_malloc (LW_IO_BUFFER_SIZE);
     chunk = 1;
     curpos = 0;
     file = fopen(out->uri, "wb");
@@ -849,9 +1166,9 @@ gpointer _stdout_func (gpointer data)
       is_cancelled = (cancellable != NULL && g_cancellable_is_cancelled (cancellable));
       if (is_cancelled) break;
 
-      chunk = fread(buffer, sizeof(char), MAX_CHUNK, stream);
+      chunk = fread(buffer, sizeof(gchar), LW_IO_BUFFER_SIZE, stream);
       curpos += chunk;
-      chunk = fwrite(buffer, sizeof(char), chunk, file);
+      chunk = fwrite(buffer, sizeof(gchar), chunk, file);
     }
 
     if (ferror(stream) != 0)
@@ -860,7 +1177,7 @@ gpointer _stdout_func (gpointer data)
       message = gettext("Unable to read data from the external program's pipe.");
       out->error = g_error_new (domain, LW_IO_READ_ERROR, "%s", message);
     }
-    else if(ferror(stream) != 0)
+    else if(file == NULL || ferror(file) != 0)
     {
       domain = g_quark_from_string (LW_IO_ERROR);
       message = gettext("Unable to write the stream's output to a file.");
@@ -869,7 +1186,8 @@ gpointer _stdout_func (gpointer data)
 
     //Cleanup
     fclose(stream);
-    fclose(file);
+    if (file != NULL) fclose(file); file = NULL;
+    g_free (buffer); buffer = NULL;
 
     return (out->error);
 }
@@ -920,3 +1238,600 @@ lw_io_get_size_for_uri (const char *URI)
 }
 
 
+//!
+//! @brief Creates a bounded pipe for handing chunks of a file between threads
+//! @param capacity The number of queued bytes after which writers block
+//! @returns A new LwIoPipe that should be freed with lw_io_pipe_free
+//!
+LwIoPipe*
+lw_io_pipe_new (gsize capacity)
+{
+    //Declarations
+    LwIoPipe *pipe;
+
+    //Initializations
+    pipe = g_new0 (LwIoPipe, 1);
+    g_mutex_init (&pipe->mutex);
+    g_cond_init (&pipe->cond);
+    pipe->chunks = g_queue_new ();
+    pipe->capacity = capacity;
+
+    return pipe;
+}
+
+
+void
+lw_io_pipe_free (LwIoPipe *pipe)
+{
+    //Sanity checks
+    if (pipe == NULL) return;
+
+    //Declarations
+    GByteArray *chunk;
+
+    while ((chunk = g_queue_pop_head (pipe->chunks)) != NULL)
+    {
+      g_byte_array_unref (chunk); chunk = NULL;
+    }
+
+    g_queue_free (pipe->chunks); pipe->chunks = NULL;
+    g_mutex_clear (&pipe->mutex);
+    g_cond_clear (&pipe->cond);
+
+    g_free (pipe);
+}
+
+
+//!
+//! @brief Queues a chunk on the pipe, blocking while the pipe is full
+//! @param pipe The LwIoPipe to write to
+//! @param chunk A GByteArray the pipe takes ownership of
+//! @returns FALSE if the pipe was aborted and the chunk was dropped
+//!
+gboolean
+lw_io_pipe_push (LwIoPipe *pipe, GByteArray *chunk)
+{
+    //Sanity checks
+    g_return_val_if_fail (pipe != NULL, FALSE);
+    g_return_val_if_fail (chunk != NULL, FALSE);
+
+    //Declarations
+    gboolean success;
+
+    g_mutex_lock (&pipe->mutex);
+
+    //A single chunk larger than the capacity is still let through
+    while (pipe->aborted == FALSE && pipe->length > 0 && pipe->length + chunk->len > pipe->capacity)
+    {
+      g_cond_wait (&pipe->cond, &pipe->mutex);
+    }
+
+    success = (pipe->aborted == FALSE);
+
+    if (success)
+    {
+      pipe->length += chunk->len;
+      g_queue_push_tail (pipe->chunks, chunk);
+      g_cond_broadcast (&pipe->cond);
+    }
+
+    g_mutex_unlock (&pipe->mutex);
+
+    if (!success) g_byte_array_unref (chunk);
+
+    return success;
+}
+
+
+//!
+//! @brief Takes the next chunk off of the pipe, blocking until one is available
+//! @param pipe The LwIoPipe to read from
+//! @returns A GByteArray to be freed with g_byte_array_unref or NULL once the
+//!          writer closed the pipe or any stage aborted it
+//!
+GByteArray*
+lw_io_pipe_pop (LwIoPipe *pipe)
+{
+    //Sanity checks
+    g_return_val_if_fail (pipe != NULL, NULL);
+
+    //Declarations
+    GByteArray *chunk;
+
+    //Initializations
+    chunk = NULL;
+
+    g_mutex_lock (&pipe->mutex);
+
+    while (pipe->aborted == FALSE && pipe->closed == FALSE && g_queue_is_empty (pipe->chunks))
+    {
+      g_cond_wait (&pipe->cond, &pipe->mutex);
+    }
+
+    if (pipe->aborted == FALSE)
+    {
+      chunk = g_queue_pop_head (pipe->chunks);
+      if (chunk != NULL)
+      {
+        pipe->length -= chunk->len;
+        g_cond_broadcast (&pipe->cond);
+      }
+    }
+
+    g_mutex_unlock (&pipe->mutex);
+
+    return chunk;
+}
+
+
+//!
+//! @brief Marks the end of the data written to the pipe
+//!
+void
+lw_io_pipe_close (LwIoPipe *pipe)
+{
+    g_return_if_fail (pipe != NULL);
+
+    g_mutex_lock (&pipe->mutex);
+    pipe->closed = TRUE;
+    g_cond_broadcast (&pipe->cond);
+    g_mutex_unlock (&pipe->mutex);
+}
+
+
+//!
+//! @brief Wakes up and stops both ends of the pipe.  Used when a stage fails
+//!        or the operation is cancelled.
+//!
+void
+lw_io_pipe_abort (LwIoPipe *pipe)
+{
+    g_return_if_fail (pipe != NULL);
+
+    g_mutex_lock (&pipe->mutex);
+    pipe->aborted = TRUE;
+    g_cond_broadcast (&pipe->cond);
+    g_mutex_unlock (&pipe->mutex);
+}
+
+
+gboolean
+lw_io_pipe_is_aborted (LwIoPipe *pipe)
+{
+    g_return_val_if_fail (pipe != NULL, TRUE);
+
+    //Declarations
+    gboolean aborted;
+
+    g_mutex_lock (&pipe->mutex);
+    aborted = pipe->aborted;
+    g_mutex_unlock (&pipe->mutex);
+
+    return aborted;
+}
+
+
+//!
+//! @brief Finishes a pipe stage by closing its output on success or aborting
+//!        both ends so the neighbouring stages stop too
+//!
+static gboolean
+lw_io_pipe_finish_stage (LwIoPipe *source, LwIoPipe *target, gboolean success)
+{
+    if (source != NULL && lw_io_pipe_is_aborted (source)) success = FALSE;
+
+    if (success)
+    {
+      lw_io_pipe_close (target);
+    }
+    else
+    {
+      if (source != NULL) lw_io_pipe_abort (source);
+      lw_io_pipe_abort (target);
+    }
+
+    return success;
+}
+
+
+struct _LwIoPipeWriteData {
+  LwIoPipe *pipe;
+  GByteArray *chunk;
+  GCancellable *cancellable;
+};
+typedef struct _LwIoPipeWriteData LwIoPipeWriteData;
+
+
+//!
+//! @brief Private function made to be used with lw_io_read_to_pipe.  Gathers
+//!        the small buffers libcurl hands over into pipe sized chunks.
+//!
+static size_t 
+_libcurl_pipe_write_func (void *ptr, size_t size, size_t nmemb, void *custom)
+{
+    //Declarations
+    LwIoPipeWriteData *writedata;
+    gboolean is_cancelled;
+    gboolean pushed;
+
+    //Initializations
+    writedata = (LwIoPipeWriteData*) custom;
+    is_cancelled = (writedata->cancellable != NULL && g_cancellable_is_cancelled (writedata->cancellable));
+    if (is_cancelled) return 0;
+
+    g_byte_array_append (writedata->chunk, ptr, size * nmemb);
+
+    if (writedata->chunk->len >= LW_IO_PIPE_CHUNK_SIZE)
+    {
+      pushed = lw_io_pipe_push (writedata->pipe, writedata->chunk);
+      writedata->chunk = g_byte_array_sized_new (LW_IO_PIPE_CHUNK_SIZE);
+      if (!pushed) return 0;
+    }
+
+    return size * nmemb;
+}
+
+
+static gpointer
+lw_io_curl_global_init (gpointer data)
+{
+    curl_global_init (CURL_GLOBAL_ALL);
+    return NULL;
+}
+
+
+//!
+//! @brief Reads a local file or downloads a url into a pipe.  Meant to be
+//!        run as the first stage of a streaming install on its own thread.
+//! @param SOURCE_PATH A local path or a url for libcurl
+//! @param target The LwIoPipe the raw bytes are written to
+//! @param cb A LwIoProgressCallback to use to give progress feedback or NULL
+//! @param data A gpointer to data to pass to the LwIoProgressCallback
+//! @param error A pointer to a GError object to write errors to or NULL
+//!
+gboolean
+lw_io_read_to_pipe (const gchar           *SOURCE_PATH,
+                    LwIoPipe              *target,
+                    LwIoProgressCallback   cb,
+                    gpointer               data,
+                    GCancellable          *cancellable,
+                    GError               **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (SOURCE_PATH != NULL, FALSE);
+    g_return_val_if_fail (target != NULL, FALSE);
+    if (error != NULL && *error != NULL) return lw_io_pipe_finish_stage (NULL, target, FALSE);
+
+    //Declarations
+    GQuark quark;
+    FILE *file;
+    GByteArray *chunk;
+    size_t position, filesize;
+    gboolean success;
+    gboolean is_cancelled;
+    CURL *curl;
+    CURLcode res;
+    LwIoPipeWriteData writedata;
+    LwIoProgressCallbackWithData cbwdata;
+    static GOnce curl_once = G_ONCE_INIT;
+
+    //Initializations
+    quark = g_quark_from_string (LW_IO_ERROR);
+    success = TRUE;
+
+    //File is located locally so read it
+    if (g_file_test (SOURCE_PATH, G_FILE_TEST_IS_REGULAR))
+    {
+      file = g_fopen (SOURCE_PATH, "rb");
+      if (file == NULL)
+      {
+        if (error != NULL) *error = g_error_new (quark, LW_IO_READ_ERROR, gettext("Could not open %s"), SOURCE_PATH);
+        return lw_io_pipe_finish_stage (NULL, target, FALSE);
+      }
+
+      filesize = lw_io_get_filesize (SOURCE_PATH);
+      position = 0;
+
+      while (success)
+      {
+        is_cancelled = (cancellable != NULL && g_cancellable_is_cancelled (cancellable));
+        if (is_cancelled) { success = FALSE; break; }
+
+        chunk = g_byte_array_sized_new (LW_IO_PIPE_CHUNK_SIZE);
+        g_byte_array_set_size (chunk, LW_IO_PIPE_CHUNK_SIZE);
+        g_byte_array_set_size (chunk, fread (chunk->data, sizeof(guint8), LW_IO_PIPE_CHUNK_SIZE, file));
+        if (chunk->len == 0) { g_byte_array_unref (chunk); break; }
+
+        position += chunk->len;
+        success = lw_io_pipe_push (target, chunk); chunk = NULL;
+        if (cb != NULL && filesize > 0) cb ((gdouble) position / (gdouble) filesize, data);
+      }
+
+      if (ferror (file) != 0)
+      {
+        if (error != NULL) *error = g_error_new (quark, LW_IO_READ_ERROR, gettext("Could not read %s"), SOURCE_PATH);
+        success = FALSE;
+      }
+
+      fclose (file); file = NULL;
+    }
+    //Download the file
+    else
+    {
+      //curl_global_init isn't thread safe and several installs can run at once
+      g_once (&curl_once, lw_io_curl_global_init, NULL);
+
+      curl = curl_easy_init ();
+      if (curl == NULL)
+      {
+        if (error != NULL) *error = g_error_new_literal (quark, LW_IO_DOWNLOAD_ERROR, gettext("Could not start the download"));
+        return lw_io_pipe_finish_stage (NULL, target, FALSE);
+      }
+
+      writedata.pipe = target;
+      writedata.chunk = g_byte_array_sized_new (LW_IO_PIPE_CHUNK_SIZE);
+      writedata.cancellable = cancellable;
+      cbwdata.cb = cb;
+      cbwdata.data = data;
+      cbwdata.cancellable = cancellable;
+
+      curl_easy_setopt (curl, CURLOPT_URL, SOURCE_PATH);
+      curl_easy_setopt (curl, CURLOPT_WRITEDATA, &writedata);
+      curl_easy_setopt (curl, CURLOPT_WRITEFUNCTION, _libcurl_pipe_write_func);
+
+      if (cb != NULL)
+      {
+        curl_easy_setopt (curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt (curl, CURLOPT_PROGRESSFUNCTION, _libcurl_update_progress);
+        curl_easy_setopt (curl, CURLOPT_PROGRESSDATA, &cbwdata);
+      }
+
+      res = curl_easy_perform (curl);
+      curl_easy_cleanup (curl); curl = NULL;
+
+      is_cancelled = (cancellable != NULL && g_cancellable_is_cancelled (cancellable));
+
+      if (res == CURLE_OK && writedata.chunk->len > 0)
+      {
+        success = lw_io_pipe_push (target, writedata.chunk);
+      }
+      else
+      {
+        g_byte_array_unref (writedata.chunk);
+        success = (res == CURLE_OK);
+
+        //Aborted pipes and cancellations are reported by whoever caused them
+        if (!success && !is_cancelled && !lw_io_pipe_is_aborted (target) && error != NULL)
+          *error = g_error_new_literal (quark, LW_IO_DOWNLOAD_ERROR, gettext(curl_easy_strerror(res)));
+      }
+      writedata.chunk = NULL;
+    }
+
+    return lw_io_pipe_finish_stage (NULL, target, success);
+}
+
+
+//!
+//! @brief Decompresses gzip data flowing through a pipe.  Like gzip -d,
+//!        concatenated members are decompressed one after another and data
+//!        after the last member that isn't another member is ignored.
+//! @param source The LwIoPipe to read compressed chunks from
+//! @param target The LwIoPipe to write the decompressed chunks to
+//! @param error A pointer to a GError object to write errors to or NULL
+//!
+gboolean
+lw_io_gunzip_pipe (LwIoPipe      *source,
+                   LwIoPipe      *target,
+                   GCancellable  *cancellable,
+                   GError       **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (source != NULL, FALSE);
+    g_return_val_if_fail (target != NULL, FALSE);
+    if (error != NULL && *error != NULL) return lw_io_pipe_finish_stage (source, target, FALSE);
+
+    //Declarations
+    GQuark quark;
+    z_stream stream;
+    GByteArray *chunk;
+    GByteArray *output;
+    gboolean success;
+    gboolean more_output;
+    gboolean completed;
+    gboolean member_output;
+    gboolean trailing;
+    int status;
+
+    //Initializations
+    quark = g_quark_from_string (LW_IO_ERROR);
+    memset(&stream, 0, sizeof(z_stream));
+    success = TRUE;
+    completed = FALSE;
+    member_output = FALSE;
+    trailing = FALSE;
+    status = Z_OK;
+
+    //16 + MAX_WBITS tells zlib to expect a gzip header
+    if (inflateInit2 (&stream, 16 + MAX_WBITS) != Z_OK)
+    {
+      if (error != NULL) *error = g_error_new_literal (quark, LW_IO_DECOMPRESSION_ERROR, gettext("Could not start decompressing"));
+      return lw_io_pipe_finish_stage (source, target, FALSE);
+    }
+
+    while (success && (chunk = lw_io_pipe_pop (source)) != NULL)
+    {
+      //The rest of the source is still drained so the stage before doesn't block
+      stream.next_in = chunk->data;
+      stream.avail_in = (trailing) ? 0 : chunk->len;
+      more_output = FALSE;
+
+      while (success && (stream.avail_in > 0 || more_output))
+      {
+        if (status == Z_STREAM_END && stream.avail_in > 0)
+        {
+          inflateReset (&stream);
+          member_output = FALSE;
+        }
+
+        output = g_byte_array_sized_new (LW_IO_PIPE_CHUNK_SIZE);
+        g_byte_array_set_size (output, LW_IO_PIPE_CHUNK_SIZE);
+        stream.next_out = output->data;
+        stream.avail_out = LW_IO_PIPE_CHUNK_SIZE;
+
+        status = inflate (&stream, Z_NO_FLUSH);
+        if (status == Z_DATA_ERROR && completed && !member_output)
+        {
+          //What follows the last member isn't gzip data
+          g_byte_array_unref (output);
+          trailing = TRUE;
+          status = Z_STREAM_END;
+          break;
+        }
+        if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+        {
+          if (error != NULL) *error = g_error_new (quark, LW_IO_DECOMPRESSION_ERROR, gettext("Decompression failed: %s"), (stream.msg != NULL) ? stream.msg : "");
+          g_byte_array_unref (output);
+          success = FALSE;
+          break;
+        }
+
+        if (status == Z_STREAM_END) completed = TRUE;
+        more_output = (stream.avail_out == 0);
+        g_byte_array_set_size (output, LW_IO_PIPE_CHUNK_SIZE - stream.avail_out);
+        if (output->len > 0) member_output = TRUE;
+
+        if (output->len > 0)
+          success = lw_io_pipe_push (target, output);
+        else
+          g_byte_array_unref (output);
+        output = NULL;
+      }
+
+      g_byte_array_unref (chunk); chunk = NULL;
+    }
+
+    //Trailing bytes too short to be rejected as a gzip header are ignored as well
+    if (status != Z_STREAM_END && completed && !member_output) status = Z_STREAM_END;
+
+    if (success && status != Z_STREAM_END && !lw_io_pipe_is_aborted (source))
+    {
+      if (error != NULL) *error = g_error_new_literal (quark, LW_IO_DECOMPRESSION_ERROR, gettext("The compressed file ended early"));
+      success = FALSE;
+    }
+
+    inflateEnd (&stream);
+
+    return lw_io_pipe_finish_stage (source, target, success);
+}
+
+
+//!
+//! @brief Converts the encoding of text flowing through a pipe.  Multibyte
+//!        characters split across chunk boundaries are carried over to the
+//!        next chunk instead of seeking back in a file.
+//! @param source The LwIoPipe to read chunks in SOURCE_ENCODING from
+//! @param target The LwIoPipe to write chunks in TARGET_ENCODING to
+//! @param SOURCE_ENCODING The encoding of the source chunks
+//! @param TARGET_ENCODING The wanted encoding of the target chunks
+//! @param error A pointer to a GError object to write errors to or NULL
+//!
+gboolean
+lw_io_convert_pipe_encoding (LwIoPipe      *source,
+                             LwIoPipe      *target,
+                             const gchar   *SOURCE_ENCODING,
+                             const gchar   *TARGET_ENCODING,
+                             GCancellable  *cancellable,
+                             GError       **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (source != NULL, FALSE);
+    g_return_val_if_fail (target != NULL, FALSE);
+    if (error != NULL && *error != NULL) return lw_io_pipe_finish_stage (source, target, FALSE);
+
+    //Declarations
+    GQuark quark;
+    GIConv conv;
+    GByteArray *chunk;
+    GByteArray *carry;
+    GByteArray *output;
+    gchar *sptr, *tptr;
+    gsize source_bytes_left, target_bytes_left;
+    gsize skipped;
+    gboolean success;
+
+    //Initializations
+    quark = g_quark_from_string (LW_IO_ERROR);
+    conv = g_iconv_open (TARGET_ENCODING, SOURCE_ENCODING);
+    if (conv == (GIConv) -1)
+    {
+      if (error != NULL) *error = g_error_new (quark, LW_IO_ENCODING_CONVERSION_ERROR, gettext("Could not convert from %s to %s"), SOURCE_ENCODING, TARGET_ENCODING);
+      return lw_io_pipe_finish_stage (source, target, FALSE);
+    }
+    carry = g_byte_array_new ();
+    skipped = 0;
+    success = TRUE;
+
+    while (success && (chunk = lw_io_pipe_pop (source)) != NULL)
+    {
+      if (carry->len > 0)
+      {
+        g_byte_array_prepend (chunk, carry->data, carry->len);
+        g_byte_array_set_size (carry, 0);
+      }
+
+      sptr = (gchar*) chunk->data;
+      source_bytes_left = chunk->len;
+
+      while (success && source_bytes_left > 0)
+      {
+        output = g_byte_array_sized_new (LW_IO_PIPE_CHUNK_SIZE);
+        g_byte_array_set_size (output, LW_IO_PIPE_CHUNK_SIZE);
+        tptr = (gchar*) output->data;
+        target_bytes_left = LW_IO_PIPE_CHUNK_SIZE;
+
+        if (g_iconv (conv, &sptr, &source_bytes_left, &tptr, &target_bytes_left) == (gsize) -1)
+        {
+          //The chunk ends in the middle of a character
+          if (errno == EINVAL)
+          {
+            g_byte_array_append (carry, (guint8*) sptr, source_bytes_left);
+            source_bytes_left = 0;
+          }
+          //The source is corrupt so skip a byte and try again
+          else if (errno == EILSEQ)
+          {
+            sptr++;
+            source_bytes_left--;
+            skipped++;
+          }
+          else if (errno != E2BIG)
+          {
+            if (error != NULL) *error = g_error_new (quark, LW_IO_ENCODING_CONVERSION_ERROR, gettext("Could not convert from %s to %s"), SOURCE_ENCODING, TARGET_ENCODING);
+            success = FALSE;
+          }
+        }
+
+        g_byte_array_set_size (output, LW_IO_PIPE_CHUNK_SIZE - target_bytes_left);
+        if (output->len > 0)
+          success = lw_io_pipe_push (target, output);
+        else
+          g_byte_array_unref (output);
+        output = NULL;
+      }
+
+      g_byte_array_unref (chunk); chunk = NULL;
+    }
+
+    if (skipped > 0 || carry->len > 0)
+    {
+      fprintf(stderr, "The file you are converting may be corrupt! %" G_GSIZE_FORMAT " bytes were skipped.\n", skipped + carry->len);
+    }
+
+    //Cleanup
+    g_byte_array_unref (carry); carry = NULL;
+    g_iconv_close (conv);
+
+    return lw_io_pipe_finish_stage (source, target, success);
+}
+
+
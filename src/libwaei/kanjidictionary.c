@@ -33,10 +33,12 @@
 #include <stdio.h>
 
 #include <glib.h>
+#include <glib/gstdio.h>
 
 #include <libwaei/gettext.h>
 #include <libwaei/libwaei.h>
 #include <libwaei/dictionary-private.h>
+#include <libwaei/kanjidictionary-private.h>
 
 G_DEFINE_TYPE (LwKanjiDictionary, lw_kanjidictionary, LW_TYPE_DICTIONARY)
 
@@ -64,6 +66,10 @@ LwDictionary* lw_kanjidictionary_new (const gchar *FILENAME)
 static void 
 lw_kanjidictionary_init (LwKanjiDictionary *dictionary)
 {
+    dictionary->priv = LW_KANJIDICTIONARY_GET_PRIVATE (dictionary);
+    memset(dictionary->priv, 0, sizeof(LwKanjiDictionaryPrivate));
+
+    g_mutex_init (&dictionary->priv->mutex);
 }
 
 
@@ -93,6 +99,18 @@ lw_kanjidictionary_constructed (GObject *object)
 static void 
 lw_kanjidictionary_finalize (GObject *object)
 {
+    //Declarations
+    LwKanjiDictionary *dictionary;
+    LwKanjiDictionaryPrivate *priv;
+
+    //Initalizations
+    dictionary = LW_KANJIDICTIONARY (object);
+    priv = dictionary->priv;
+
+    if (priv->offsets != NULL) g_hash_table_unref (priv->offsets); priv->offsets = NULL;
+    if (priv->file != NULL) fclose (priv->file); priv->file = NULL;
+    g_mutex_clear (&priv->mutex);
+
     G_OBJECT_CLASS (lw_kanjidictionary_parent_class)->finalize (object);
 }
 
@@ -116,6 +134,8 @@ lw_kanjidictionary_class_init (LwKanjiDictionaryClass *klass)
     dictionary_class->compare = lw_kanjidictionary_compare;
     dictionary_class->installer_postprocess = lw_kanjidictionary_installer_postprocess;
 
+    g_type_class_add_private (object_class, sizeof (LwKanjiDictionaryPrivate));
+
     dictionary_class->patterns = g_new0 (gchar**, TOTAL_LW_QUERY_TYPES + 1);
     for (i = 0; i < TOTAL_LW_QUERY_TYPES; i++)
     {
@@ -192,7 +212,7 @@ lw_kanjidictionary_parse_result (LwDictionary *dictionary, LwResult *result, FIL
 
     //Get strokes
     result->strokes = NULL;
-    g_regex_match (lw_re[LW_RE_STROKES], ptr, 0, &match_info);
+    g_regex_match (lw_regex_get (LW_RE_STROKES), ptr, 0, &match_info);
     if (g_match_info_matches (match_info))
     {
       g_match_info_fetch_pos (match_info, 0, &start[LW_RE_STROKES], &end[LW_RE_STROKES]);
@@ -202,7 +222,7 @@ lw_kanjidictionary_parse_result (LwDictionary *dictionary, LwResult *result, FIL
 
     //Get frequency
     result->frequency = NULL;
-    g_regex_match (lw_re[LW_RE_FREQUENCY], ptr, 0, &match_info);
+    g_regex_match (lw_regex_get (LW_RE_FREQUENCY), ptr, 0, &match_info);
     if (g_match_info_matches (match_info))
     {
       g_match_info_fetch_pos (match_info, 0, &start[LW_RE_FREQUENCY], &end[LW_RE_FREQUENCY]);
@@ -213,7 +233,7 @@ lw_kanjidictionary_parse_result (LwDictionary *dictionary, LwResult *result, FIL
 
     //Get grade level
     result->grade = NULL;
-    g_regex_match (lw_re[LW_RE_GRADE], ptr, 0, &match_info);
+    g_regex_match (lw_regex_get (LW_RE_GRADE), ptr, 0, &match_info);
     if (g_match_info_matches (match_info))
     {
       g_match_info_fetch_pos (match_info, 0, &start[LW_RE_GRADE], &end[LW_RE_GRADE]);
@@ -223,7 +243,7 @@ lw_kanjidictionary_parse_result (LwDictionary *dictionary, LwResult *result, FIL
 
     //Get JLPT level
     result->jlpt = NULL;
-    g_regex_match (lw_re[LW_RE_JLPT], ptr, 0, &match_info);
+    g_regex_match (lw_regex_get (LW_RE_JLPT), ptr, 0, &match_info);
     if (g_match_info_matches (match_info))
     {
       g_match_info_fetch_pos (match_info, 0, &start[LW_RE_JLPT], &end[LW_RE_JLPT]);
@@ -496,3 +516,123 @@ lw_kanjidictionary_create_primary_tokens (LwDictionary *dictionary, LwQuery *que
     if (delimited != NULL) g_free (delimited); delimited = NULL;
 }
 
+
+
+//!
+//! @brief Reads the file offset of the line of every kanji of the dictionary.
+//!        The table is read again when the file changes, such as after an update.
+//!        The mutex of the dictionary must be held.
+//! @returns FALSE if the dictionary file couldn't be read
+//!
+static gboolean
+lw_kanjidictionary_load_offsets (LwKanjiDictionary *dictionary)
+{
+    //Declarations
+    LwKanjiDictionaryPrivate *priv;
+    gchar *path;
+    gchar *buffer;
+    GStatBuf info;
+    gunichar character;
+    gboolean line_start;
+    glong offset;
+
+    //Initializations
+    priv = dictionary->priv;
+    path = lw_dictionary_get_path (LW_DICTIONARY (dictionary));
+    if (path == NULL) return FALSE;
+    if (g_stat (path, &info) != 0)
+    {
+      g_free (path); path = NULL;
+      return FALSE;
+    }
+
+    if (priv->offsets != NULL && priv->mtime == (gint64) info.st_mtime)
+    {
+      g_free (path); path = NULL;
+      return TRUE;
+    }
+
+    if (priv->offsets != NULL) g_hash_table_unref (priv->offsets); priv->offsets = NULL;
+    if (priv->file != NULL) fclose (priv->file); priv->file = NULL;
+
+    priv->file = fopen (path, "r");
+    g_free (path); path = NULL;
+    if (priv->file == NULL) return FALSE;
+
+    priv->offsets = g_hash_table_new (g_direct_hash, g_direct_equal);
+    priv->mtime = (gint64) info.st_mtime;
+    buffer = (gchar*) malloc (LW_IO_MAX_FGETS_LINE);
+    line_start = TRUE;
+    offset = 0;
+
+    //Each line starts with the kanji it is about, so only the first character is read
+    while (fgets (buffer, LW_IO_MAX_FGETS_LINE, priv->file) != NULL)
+    {
+      if (line_start && *buffer != '#')
+      {
+        character = g_utf8_get_char_validated (buffer, -1);
+        if (character != (gunichar) -1 && character != (gunichar) -2 && character != 0)
+        {
+          if (!g_hash_table_lookup_extended (priv->offsets, GUINT_TO_POINTER (character), NULL, NULL))
+            g_hash_table_insert (priv->offsets, GUINT_TO_POINTER (character), GSIZE_TO_POINTER ((gsize) offset));
+        }
+      }
+      line_start = (strchr (buffer, '\n') != NULL);
+      offset = ftell (priv->file);
+    }
+
+    //Cleanup
+    free (buffer); buffer = NULL;
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Looks up the line of a single kanji without starting a search.  The file
+//!        offsets of the kanji are read the first time, after which a lookup is a
+//!        table lookup, a seek and the parse of one line.
+//! @param dictionary An LwKanjiDictionary
+//! @param character The kanji to look up
+//! @returns A new LwResult to be freed with lw_result_free or NULL if the kanji isn't in the dictionary
+//!
+LwResult*
+lw_kanjidictionary_lookup (LwDictionary *dictionary, gunichar character)
+{
+    //Sanity checks
+    g_return_val_if_fail (LW_IS_KANJIDICTIONARY (dictionary), NULL);
+
+    //Declarations
+    LwKanjiDictionaryPrivate *priv;
+    LwResult *result;
+    gpointer offset;
+    gboolean found;
+
+    //Initializations
+    priv = LW_KANJIDICTIONARY (dictionary)->priv;
+    result = NULL;
+    found = FALSE;
+
+    g_mutex_lock (&priv->mutex);
+
+    if (lw_kanjidictionary_load_offsets (LW_KANJIDICTIONARY (dictionary)) &&
+        g_hash_table_lookup_extended (priv->offsets, GUINT_TO_POINTER (character), NULL, &offset) &&
+        fseek (priv->file, (glong) GPOINTER_TO_SIZE (offset), SEEK_SET) == 0)
+    {
+      result = lw_result_new ();
+      if (result != NULL)
+      {
+        lw_dictionary_parse_result (dictionary, result, priv->file);
+        found = (result->kanji != NULL && g_utf8_get_char (result->kanji) == character);
+      }
+    }
+
+    g_mutex_unlock (&priv->mutex);
+
+    if (!found && result != NULL)
+    {
+      lw_result_free (result); result = NULL;
+    }
+
+    return result;
+}
@@ -34,8 +34,11 @@
 
 static LwMorphology *lw_morphology_new ();
 static void lw_morphology_free (LwMorphology *morphology);
+static GList* lw_morphologyengine_parse (LwMorphologyEngine*, mecab_lattice_t*, const gchar*);
 
 static LwMorphologyEngine *_engine = NULL;
+static gboolean _engine_loaded = FALSE; //!< Set once creating the default engine was tried, even if it failed
+static GMutex _engine_mutex;            //!< Guards _engine and _engine_loaded
 
 
 //!
@@ -91,9 +94,24 @@ lw_morphology_free (LwMorphology *morphology)
 
 #define PLAIN_COPULA "だ"
 
+#define LW_MORPHOLOGYENGINE_CACHE_SIZE 256
+
+struct _LwMorphologyCacheEntry {
+  gchar *key;
+  GList *list;
+};
+typedef struct _LwMorphologyCacheEntry LwMorphologyCacheEntry;
+
+static void lw_morphologyengine_cache_clear (LwMorphologyEngine*);
+
+
 //!
 //! @brief Initializes the Mecab analysis engine.
 //!
+//! One model and tagger are shared by every caller.  Each concurrent analysis
+//! gets its own lattice from a pool so callers no longer queue behind a
+//! single tagger.
+//!
 LwMorphologyEngine*
 lw_morphologyengine_new ()
 {
@@ -101,13 +119,17 @@ lw_morphologyengine_new ()
     static gchar *argv[] = {"mecab", NULL};
     static gboolean message_shown = FALSE;
     LwMorphologyEngine *engine;
+    const mecab_dictionary_info_t *info;
 
     //Initializations
     engine = g_new0 (LwMorphologyEngine, 1);
     if (engine != NULL)
     {
-      engine->mecab = mecab_new (sizeof(argv)/sizeof(gchar*)-1, argv);
       g_mutex_init (&engine->mutex);
+      g_queue_init (&engine->cache_queue);
+      engine->cache = g_hash_table_new (g_str_hash, g_str_equal);
+      engine->model = mecab_model_new (sizeof(argv)/sizeof(gchar*)-1, argv);
+      if (engine->model != NULL) engine->mecab = mecab_model_new_tagger (engine->model);
     }
 
     //Error checking
@@ -122,26 +144,48 @@ lw_morphologyengine_new ()
     else
     {
       message_shown = FALSE;
+      info = mecab_model_dictionary_info (engine->model);
+      engine->charset_is_utf8 = (info != NULL && info->charset != NULL &&
+                                 (g_ascii_strcasecmp (info->charset, "UTF-8") == 0 ||
+                                  g_ascii_strcasecmp (info->charset, "UTF8") == 0));
     }
 
     return engine;
 }
 
 
+//!
+//! @brief Gets the shared engine, creating it the first time it is asked for.
+//!        If Mecab can't be loaded it isn't tried again until the default
+//!        engine is freed.
+//!
 LwMorphologyEngine*
 lw_morphologyengine_get_default ()
 {
-  if (_engine == NULL)
+  LwMorphologyEngine *engine;
+
+  g_mutex_lock (&_engine_mutex);
+  if (!_engine_loaded)
   {
     _engine = lw_morphologyengine_new ();
+    _engine_loaded = TRUE;
   }
-  return _engine;
+  engine = _engine;
+  g_mutex_unlock (&_engine_mutex);
+
+  return engine;
 }
 
 gboolean
 lw_morphologyengine_has_default ()
 {
-  return (_engine != NULL);
+  gboolean has_default;
+
+  g_mutex_lock (&_engine_mutex);
+  has_default = (_engine != NULL);
+  g_mutex_unlock (&_engine_mutex);
+
+  return has_default;
 }
 
 
@@ -152,21 +196,183 @@ lw_morphologyengine_free (LwMorphologyEngine *engine)
 
     if (engine != NULL)
     {
-      if (engine == _engine) _engine = NULL;
+      g_mutex_lock (&_engine_mutex);
+      if (engine == _engine)
+      {
+        _engine = NULL;
+        _engine_loaded = FALSE;
+      }
+      g_mutex_unlock (&_engine_mutex);
+      lw_morphologyengine_cache_clear (engine);
+      if (engine->cache != NULL) g_hash_table_unref (engine->cache); engine->cache = NULL;
+      g_slist_free_full (engine->lattices, (GDestroyNotify) mecab_lattice_destroy); engine->lattices = NULL;
       if (engine->mecab != NULL) mecab_destroy (engine->mecab);
+      if (engine->model != NULL) mecab_model_destroy (engine->model);
       g_mutex_clear (&engine->mutex);
     }
     g_free (engine);
 }
 
 
+//!
+//! @brief Takes an idle lattice from the pool or creates a new one
+//!
+static mecab_lattice_t*
+lw_morphologyengine_take_lattice (LwMorphologyEngine *engine)
+{
+    mecab_lattice_t *lattice;
+
+    lattice = NULL;
+
+    g_mutex_lock (&engine->mutex);
+    if (engine->lattices != NULL)
+    {
+      lattice = engine->lattices->data;
+      engine->lattices = g_slist_delete_link (engine->lattices, engine->lattices);
+    }
+    g_mutex_unlock (&engine->mutex);
+
+    if (lattice == NULL) lattice = mecab_model_new_lattice (engine->model);
+
+    return lattice;
+}
+
+
+//!
+//! @brief Gives a lattice back to the pool once an analysis is done with it
+//!
+static void
+lw_morphologyengine_return_lattice (LwMorphologyEngine *engine, mecab_lattice_t *lattice)
+{
+    mecab_lattice_clear (lattice);
+
+    g_mutex_lock (&engine->mutex);
+    engine->lattices = g_slist_prepend (engine->lattices, lattice);
+    g_mutex_unlock (&engine->mutex);
+}
+
+
+//!
+//! @brief Deep copies a list of LwMorphology objects
+//!
+static GList*
+lw_morphologylist_copy (GList *list)
+{
+    //Declarations
+    GList *copy;
+    GList *link;
+    LwMorphology *morphology;
+    LwMorphology *temp;
+
+    //Initializations
+    copy = NULL;
+
+    for (link = list; link != NULL; link = link->next)
+    {
+      morphology = LW_MORPHOLOGY (link->data);
+      temp = lw_morphology_new ();
+      temp->word = g_strdup (morphology->word);
+      temp->base_form = g_strdup (morphology->base_form);
+      temp->explanation = g_strdup (morphology->explanation);
+      copy = g_list_prepend (copy, temp);
+    }
+
+    return g_list_reverse (copy);
+}
+
+
+static void
+lw_morphologyengine_cache_entry_free (LwMorphologyCacheEntry *entry)
+{
+    if (entry == NULL) return;
+
+    g_free (entry->key); entry->key = NULL;
+    lw_morphologylist_free (entry->list); entry->list = NULL;
+    g_free (entry);
+}
+
+
+static void
+lw_morphologyengine_cache_clear (LwMorphologyEngine *engine)
+{
+    LwMorphologyCacheEntry *entry;
+
+    if (engine->cache != NULL) g_hash_table_remove_all (engine->cache);
+    while ((entry = g_queue_pop_head (&engine->cache_queue)) != NULL)
+    {
+      lw_morphologyengine_cache_entry_free (entry);
+    }
+}
+
+
+//!
+//! @brief Looks up a previous analysis, marking it as the most recently used
+//! @param list Set to a copy of the cached list that should be freed with lw_morphologylist_free
+//! @returns Returns true if the input was in the cache
+//!
+static gboolean
+lw_morphologyengine_cache_lookup (LwMorphologyEngine *engine, const gchar *INPUT, GList **list)
+{
+    //Declarations
+    GList *link;
+    LwMorphologyCacheEntry *entry;
+
+    //Initializations
+    *list = NULL;
+
+    g_mutex_lock (&engine->mutex);
+    link = g_hash_table_lookup (engine->cache, INPUT);
+    if (link != NULL)
+    {
+      g_queue_unlink (&engine->cache_queue, link);
+      g_queue_push_head_link (&engine->cache_queue, link);
+      entry = link->data;
+      *list = lw_morphologylist_copy (entry->list);
+    }
+    g_mutex_unlock (&engine->mutex);
+
+    return (link != NULL);
+}
+
+
+//!
+//! @brief Stores a copy of an analysis, evicting the least recently used one when full
+//!
+static void
+lw_morphologyengine_cache_insert (LwMorphologyEngine *engine, const gchar *INPUT, GList *list)
+{
+    //Declarations
+    LwMorphologyCacheEntry *entry;
+
+    g_mutex_lock (&engine->mutex);
+    if (g_hash_table_lookup (engine->cache, INPUT) == NULL)
+    {
+      entry = g_new0 (LwMorphologyCacheEntry, 1);
+      entry->key = g_strdup (INPUT);
+      entry->list = lw_morphologylist_copy (list);
+      g_queue_push_head (&engine->cache_queue, entry);
+      g_hash_table_insert (engine->cache, entry->key, engine->cache_queue.head);
+
+      while (g_queue_get_length (&engine->cache_queue) > LW_MORPHOLOGYENGINE_CACHE_SIZE)
+      {
+        entry = g_queue_pop_tail (&engine->cache_queue);
+        g_hash_table_remove (engine->cache, entry->key);
+        lw_morphologyengine_cache_entry_free (entry);
+      }
+    }
+    g_mutex_unlock (&engine->mutex);
+}
+
+
 //!
 //! @brief Convert string from UTF-8 to Mecab's charset.
 //!
 static gchar*
 lw_morphologyengine_encode_to_mecab (LwMorphologyEngine *engine, const gchar *WORD, gint nbytes)
 {
-    const mecab_dictionary_info_t *info = mecab_dictionary_info (engine->mecab);
+    if (engine->charset_is_utf8) return (nbytes < 0) ? g_strdup (WORD) : g_strndup (WORD, nbytes);
+
+    const mecab_dictionary_info_t *info = mecab_model_dictionary_info (engine->model);
     gsize bytes_read, bytes_written;
     return g_convert (WORD, nbytes, info->charset, "UTF-8", &bytes_read, &bytes_written, NULL);
 }
@@ -177,7 +383,9 @@ lw_morphologyengine_encode_to_mecab (LwMorphologyEngine *engine, const gchar *WO
 static gchar*
 lw_morphologyengine_decode_from_mecab (LwMorphologyEngine *engine, const gchar *word, gint nbytes)
 {
-    const mecab_dictionary_info_t *info = mecab_dictionary_info (engine->mecab);
+    if (engine->charset_is_utf8) return (nbytes < 0) ? g_strdup (word) : g_strndup (word, nbytes);
+
+    const mecab_dictionary_info_t *info = mecab_model_dictionary_info (engine->model);
     gsize bytes_read, bytes_written;
     return g_convert (word, nbytes, "UTF-8", info->charset, &bytes_read, &bytes_written, NULL);
 }
@@ -186,12 +394,45 @@ lw_morphologyengine_decode_from_mecab (LwMorphologyEngine *engine, const gchar *
 //!
 //! @brief Morphological analysis of input using Mecab
 //!
+//! Results are served from a bounded LRU cache when the same input was
+//! analyzed recently.  The returned list should be freed with lw_morphologylist_free.
+//!
 GList*
 lw_morphologyengine_analyze (LwMorphologyEngine *engine, const gchar *INPUT_RAW)
 {
     if (engine == NULL) return NULL;
     g_return_val_if_fail (INPUT_RAW != NULL, NULL);
 
+    //Declarations
+    mecab_lattice_t *lattice;
+    GList *list;
+
+    //Initializations
+    list = NULL;
+
+    if (lw_morphologyengine_cache_lookup (engine, INPUT_RAW, &list)) return list;
+
+    lattice = lw_morphologyengine_take_lattice (engine);
+    if (lattice == NULL) return NULL;
+
+    list = lw_morphologyengine_parse (engine, lattice, INPUT_RAW);
+
+    lw_morphologyengine_return_lattice (engine, lattice);
+
+    //A failed analysis is tried again the next time instead of being remembered
+    if (list != NULL) lw_morphologyengine_cache_insert (engine, INPUT_RAW, list);
+
+    return list;
+}
+
+
+//!
+//! @brief Runs Mecab over the input with a lattice owned by the calling thread
+//! @returns The words of the input in order, or NULL if any of it couldn't be analyzed
+//!
+static GList*
+lw_morphologyengine_parse (LwMorphologyEngine *engine, mecab_lattice_t *lattice, const gchar *INPUT_RAW)
+{
     const mecab_node_t *node;
     gchar **fields = NULL, *surface = NULL;
     gchar *temp;
@@ -199,12 +440,13 @@ lw_morphologyengine_analyze (LwMorphologyEngine *engine, const gchar *INPUT_RAW)
     LwMorphology *morphology = NULL;
     GList *list = NULL;
 
-    g_mutex_lock (&engine->mutex);
-
     input = lw_morphologyengine_encode_to_mecab (engine, INPUT_RAW, -1);
     if (!input)
       goto fail;
-    node = mecab_sparse_tonode(engine->mecab, input);
+    mecab_lattice_set_sentence (lattice, input);
+    if (!mecab_parse_lattice (engine->mecab, lattice))
+      goto fail;
+    node = mecab_lattice_get_bos_node (lattice);
 
 #define FLUSH_ITEM                                                                            \
         do {                                                                                  \
@@ -310,21 +552,19 @@ lw_morphologyengine_analyze (LwMorphologyEngine *engine, const gchar *INPUT_RAW)
 
     g_free(input);
 
-    g_mutex_unlock (&engine->mutex);
-
     list = g_list_reverse(list);
 
     return list;
 
 fail:
-    g_mutex_unlock (&engine->mutex);
-
     if (morphology != NULL) lw_morphology_free (morphology);
     if (fields != NULL) g_strfreev (fields);
     if (surface != NULL) g_free (surface);
     if (input != NULL) g_free (input);
+    //A partial analysis is dropped so that it is never cached as a whole one
+    if (list != NULL) lw_morphologylist_free (list); list = NULL;
 
-    return list;
+    return NULL;
 }
 
 
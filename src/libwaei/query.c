@@ -376,24 +376,22 @@ lw_query_tokenlist_build_romaji_supplimentary (LwQuery      *query,
     gboolean hiragana_to_katakana;
     gboolean is_romaji;
     gchar *supplimentary;
-    const gint LENGTH = 100;
-    gchar buffer[LENGTH];
+    gchar *kana;
     gchar *temp;
-    gboolean convertable;
 
     //Initializations
     romaji_to_furigana = query->flags & LW_QUERY_FLAG_ROMAJI_TO_FURIGANA;
     hiragana_to_katakana = query->flags & LW_QUERY_FLAG_HIRAGANA_TO_KATAKANA;
     is_romaji = lw_util_is_romaji_str (TOKEN);
     supplimentary = g_strdup (TOKEN);
-    buffer[0] = '\0';
     *new_type = LW_QUERY_TYPE_ROMAJI;
-    convertable = lw_util_str_roma_to_hira (TOKEN, buffer, LENGTH);
+    kana = NULL;
+    if (romaji_to_furigana && is_romaji) kana = lw_util_romaji_to_kana (TOKEN, LW_KANA_SCRIPT_HIRAGANA);
     
-    if (romaji_to_furigana && is_romaji && convertable)
+    if (kana != NULL)
     {
       *new_type = LW_QUERY_TYPE_MIX;
-      temp = g_strjoin (LW_QUERY_DELIMITOR_SUPPLIMENTARY_STRING, supplimentary, buffer, NULL);
+      temp = g_strjoin (LW_QUERY_DELIMITOR_SUPPLIMENTARY_STRING, supplimentary, kana, NULL);
       g_free (supplimentary); supplimentary = temp; temp = NULL;
 
 #ifdef WITH_MECAB
@@ -422,17 +420,18 @@ lw_query_tokenlist_build_romaji_supplimentary (LwQuery      *query,
       }
 #endif
     }
-    else
+    if (hiragana_to_katakana && kana != NULL && lw_util_is_hiragana_str (kana))
     {
-      buffer[0] = '\0';
-    }
-    if (hiragana_to_katakana && buffer[0] != '\0' && lw_util_is_hiragana_str (buffer))
-    {
-      lw_util_str_shift_hira_to_kata (buffer);
-      temp = g_strjoin (LW_QUERY_DELIMITOR_SUPPLIMENTARY_STRING, supplimentary, buffer, NULL);
-      g_free (supplimentary); supplimentary = temp; temp = NULL;
+      g_free (kana); kana = lw_util_romaji_to_kana (TOKEN, LW_KANA_SCRIPT_KATAKANA);
+      if (kana != NULL)
+      {
+        temp = g_strjoin (LW_QUERY_DELIMITOR_SUPPLIMENTARY_STRING, supplimentary, kana, NULL);
+        g_free (supplimentary); supplimentary = temp; temp = NULL;
+      }
     }
 
+    if (kana != NULL) g_free (kana); kana = NULL;
+
     return supplimentary;
 }
 
@@ -33,18 +33,13 @@
 #include <libwaei/libwaei.h>
 
 
-static int _regex_expressions_reference_count = 0; //!< Internal reference count for the regexes
+static GMutex _regex_mutex;      //!< Guards compiling and freeing the regexes
+static gint _regex_compiled = 0; //!< Set once the regexes are compiled and cleared when they are freed
 GRegex *lw_re[LW_RE_TOTAL + 1]; //!< Globally accessable pre-compiled regexes
 
-//!
-//! @brief Initializes often used prebuilt regex expressions
-//!
-void 
-lw_regex_initialize ()
+static void
+lw_regex_compile ()
 {
-    if (_regex_expressions_reference_count > 0) return;
-    _regex_expressions_reference_count++;
-
     //Declarations
     GError *error;
     int i;
@@ -87,22 +82,73 @@ lw_regex_initialize ()
 
 
 //!
-//! @brief Frees often used prebuilt regex expressions
+//! @brief Compiles the regexes unless they already are
+//!
+static void
+lw_regex_ensure ()
+{
+    if (g_atomic_int_get (&_regex_compiled)) return;
+
+    g_mutex_lock (&_regex_mutex);
+    if (!_regex_compiled)
+    {
+      lw_regex_compile ();
+      g_atomic_int_set (&_regex_compiled, 1);
+    }
+    g_mutex_unlock (&_regex_mutex);
+}
+
+
+//!
+//! @brief Initializes often used prebuilt regex expressions.  This no longer
+//!        needs to be called at startup since lw_regex_get compiles them on
+//!        first use.
 //!
 void 
-lw_regex_free ()
+lw_regex_initialize ()
+{
+    lw_regex_ensure ();
+}
+
+
+//!
+//! @brief Gets one of the prebuilt regexes, compiling them the first time
+//! @param INDEX The LwRegexDataIndex of the regex
+//! @returns A GRegex owned by libwaei
+//!
+GRegex*
+lw_regex_get (LwRegexDataIndex INDEX)
 {
-    if (_regex_expressions_reference_count < 1) return;
-    _regex_expressions_reference_count--;
+    g_return_val_if_fail (INDEX < LW_RE_TOTAL, NULL);
+
+    lw_regex_ensure ();
+
+    return lw_re[INDEX];
+}
+
 
+//!
+//! @brief Frees often used prebuilt regex expressions.  They are compiled
+//!        again if asked for after, but this shouldn't be called while other
+//!        threads could still be using them.
+//!
+void 
+lw_regex_free ()
+{
     //Declarations
     int i;
 
-    //Setup the built in regexes
-    for (i = 0; i < LW_RE_TOTAL; i++)
+    g_mutex_lock (&_regex_mutex);
+
+    if (_regex_compiled)
     {
-      g_regex_unref (lw_re[i]);
-      lw_re[i] = NULL;
+      for (i = 0; i < LW_RE_TOTAL; i++)
+      {
+        if (lw_re[i] != NULL) g_regex_unref (lw_re[i]);
+        lw_re[i] = NULL;
+      }
+      g_atomic_int_set (&_regex_compiled, 0);
     }
-}
 
+    g_mutex_unlock (&_regex_mutex);
+}
@@ -73,6 +73,10 @@ lw_result_free (LwResult *result)
 void 
 lw_result_init (LwResult *result)
 {
+    result->similar = NULL;
+    result->spans = NULL;
+    result->text = (gchar*) malloc (LW_IO_MAX_FGETS_LINE);
+    result->length = LW_IO_MAX_FGETS_LINE;
     lw_result_clear (result);
 }
 
@@ -86,18 +90,29 @@ lw_result_init (LwResult *result)
 void 
 lw_result_deinit (LwResult *result)
 {
+    g_list_free_full (result->similar, (GDestroyNotify) lw_result_free); result->similar = NULL;
+    if (result->spans != NULL) g_array_free (result->spans, TRUE); result->spans = NULL;
+    if (result->text != NULL) free (result->text); result->text = NULL;
+    result->length = 0;
 }
 
 void 
 lw_result_clear (LwResult *result)
 {
     //A place for a copy of the raw string
+    if (result->length < LW_IO_MAX_FGETS_LINE)
+    {
+      result->text = (gchar*) realloc (result->text, LW_IO_MAX_FGETS_LINE);
+      result->length = LW_IO_MAX_FGETS_LINE;
+    }
     result->text[0] = '\0';
 
     result->relevance = LW_RELEVANCE_UNSET;
+    if (result->spans != NULL) g_array_set_size (result->spans, 0);
     
     //General formatting
     result->def_start[0] = NULL;
+    result->number[0] = NULL;
     result->def_total = 0;
     result->kanji_start = NULL;
     result->furigana_start = NULL;
@@ -133,3 +148,351 @@ lw_result_is_similar (LwResult *result1, LwResult *result2)
     return (same_first_def && same_def_totals);
 }
 
+
+//!
+//! @brief Checks if two parsed results hold the same entry, field for field
+//! @returns TRUE if nothing would be lost by dropping one of them
+//!
+gboolean
+lw_result_is_identical (LwResult *result1, LwResult *result2)
+{
+    //Declarations
+    gint i;
+
+    if (result1 == NULL || result2 == NULL) return FALSE;
+
+    if (g_strcmp0 (result1->kanji_start, result2->kanji_start) != 0) return FALSE;
+    if (g_strcmp0 (result1->furigana_start, result2->furigana_start) != 0) return FALSE;
+    if (g_strcmp0 (result1->classification_start, result2->classification_start) != 0) return FALSE;
+    if (result1->important != result2->important) return FALSE;
+    if (result1->def_total != result2->def_total) return FALSE;
+
+    for (i = 0; result1->def_start[i] != NULL || result2->def_start[i] != NULL; i++)
+    {
+      if (g_strcmp0 (result1->def_start[i], result2->def_start[i]) != 0) return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Builds the key used to collapse results that share a headword
+//! @param result A parsed LwResult
+//! @returns A newly allocated "kanji\tfurigana" string to be freed with g_free or NULL if the result has no headword
+//!
+gchar*
+lw_result_build_headword_key (LwResult *result)
+{
+    //Sanity checks
+    g_return_val_if_fail (result != NULL, NULL);
+    if (result->kanji_start == NULL) return NULL;
+
+    //Declarations
+    const gchar *furigana;
+
+    //Initializations
+    furigana = result->furigana_start;
+    if (furigana == NULL) furigana = "";
+
+    return g_strjoin ("\t", result->kanji_start, furigana, NULL);
+}
+
+
+//!
+//! @brief Collapses a result into another one with the same headword
+//! @param result The result the sense block is added to
+//! @param similar A result that will be owned and freed by result
+//!
+void
+lw_result_add_similar (LwResult *result, LwResult *similar)
+{
+    //Sanity checks
+    g_return_if_fail (result != NULL);
+    g_return_if_fail (similar != NULL);
+    g_return_if_fail (result != similar);
+
+    result->similar = g_list_append (result->similar, similar);
+}
+
+
+//!
+//! @brief Moves a pointer into the text of a result to the same place in its reallocated text
+//!
+static gchar*
+lw_result_rebase (gchar *pointer, const gchar *old_text, gsize length, gchar *new_text)
+{
+    if (pointer == NULL || pointer < old_text || pointer >= old_text + length) return pointer;
+    return new_text + (pointer - old_text);
+}
+
+
+//!
+//! @brief Shrinks the text of a parsed result down to the bytes its fields
+//!        use.  Results kept by a search are compacted so that holding many of
+//!        them doesn't cost a whole line buffer each.
+//! @param result A parsed LwResult
+//!
+void
+lw_result_compact (LwResult *result)
+{
+    //Sanity checks
+    g_return_if_fail (result != NULL);
+
+    //Declarations
+    gchar *fields[16];
+    gchar *old_text;
+    gchar *new_text;
+    gsize used;
+    gsize end;
+    gint total;
+    gint i;
+
+    //Initializations
+    old_text = result->text;
+    used = strlen (result->text) + 1;
+    total = 0;
+
+    fields[total++] = result->kanji_start;
+    fields[total++] = result->furigana_start;
+    fields[total++] = result->classification_start;
+    fields[total++] = result->strokes;
+    fields[total++] = result->frequency;
+    fields[total++] = result->readings[0];
+    fields[total++] = result->readings[1];
+    fields[total++] = result->readings[2];
+    fields[total++] = result->meanings;
+    fields[total++] = result->grade;
+    fields[total++] = result->jlpt;
+    fields[total++] = result->kanji;
+    fields[total++] = result->radicals;
+
+    //The fields were split apart in place, so the text ends after the last one
+    for (i = 0; i < total; i++)
+    {
+      if (fields[i] == NULL || fields[i] < old_text || fields[i] >= old_text + result->length) continue;
+      end = (fields[i] - old_text) + strlen (fields[i]) + 1;
+      if (end > used) used = end;
+    }
+    for (i = 0; result->def_start[i] != NULL; i++)
+    {
+      if (result->def_start[i] < old_text || result->def_start[i] >= old_text + result->length) continue;
+      end = (result->def_start[i] - old_text) + strlen (result->def_start[i]) + 1;
+      if (end > used) used = end;
+    }
+
+    if (used >= result->length) return;
+
+    new_text = (gchar*) realloc (old_text, used);
+    if (new_text == NULL) return;
+
+    result->kanji_start = lw_result_rebase (result->kanji_start, old_text, result->length, new_text);
+    result->furigana_start = lw_result_rebase (result->furigana_start, old_text, result->length, new_text);
+    result->classification_start = lw_result_rebase (result->classification_start, old_text, result->length, new_text);
+    result->strokes = lw_result_rebase (result->strokes, old_text, result->length, new_text);
+    result->frequency = lw_result_rebase (result->frequency, old_text, result->length, new_text);
+    result->readings[0] = lw_result_rebase (result->readings[0], old_text, result->length, new_text);
+    result->readings[1] = lw_result_rebase (result->readings[1], old_text, result->length, new_text);
+    result->readings[2] = lw_result_rebase (result->readings[2], old_text, result->length, new_text);
+    result->meanings = lw_result_rebase (result->meanings, old_text, result->length, new_text);
+    result->grade = lw_result_rebase (result->grade, old_text, result->length, new_text);
+    result->jlpt = lw_result_rebase (result->jlpt, old_text, result->length, new_text);
+    result->kanji = lw_result_rebase (result->kanji, old_text, result->length, new_text);
+    result->radicals = lw_result_rebase (result->radicals, old_text, result->length, new_text);
+    for (i = 0; result->def_start[i] != NULL; i++)
+    {
+      result->def_start[i] = lw_result_rebase (result->def_start[i], old_text, result->length, new_text);
+      result->number[i] = lw_result_rebase (result->number[i], old_text, result->length, new_text);
+    }
+
+    result->text = new_text;
+    result->length = used;
+}
+
+
+//!
+//! @brief Gets the bytes a result holds, including the results collapsed into it
+//!
+gsize
+lw_result_get_size (LwResult *result)
+{
+    //Sanity checks
+    g_return_val_if_fail (result != NULL, 0);
+
+    //Declarations
+    GList *link;
+    gsize size;
+
+    //Initializations
+    size = sizeof(LwResult) + result->length;
+    if (result->spans != NULL) size += result->spans->len * sizeof(LwResultSpan);
+
+    for (link = result->similar; link != NULL; link = link->next)
+      size += lw_result_get_size (LW_RESULT (link->data));
+
+    return size;
+}
+
+
+static gint
+lw_result_compare_spans (gconstpointer a, gconstpointer b)
+{
+    //Declarations
+    const LwResultSpan *span1;
+    const LwResultSpan *span2;
+
+    //Initializations
+    span1 = a;
+    span2 = b;
+
+    if (span1->start != span2->start) return span1->start - span2->start;
+    return span1->end - span2->end;
+}
+
+
+//!
+//! @brief Records where the low relevance regexes of every query type match a field
+//!
+static void
+lw_result_find_spans_in_field (LwResult *result, LwQuery *query, const gchar *FIELD)
+{
+    //Declarations
+    static const LwQueryType TYPES[] = { 
+      LW_QUERY_TYPE_KANJI, LW_QUERY_TYPE_FURIGANA, LW_QUERY_TYPE_ROMAJI, LW_QUERY_TYPE_MIX 
+    };
+    LwResultSpan span;
+    GMatchInfo *match_info;
+    GRegex *regex;
+    GList *link;
+    gint offset;
+    gint start;
+    gint end;
+    gint i;
+
+    //Initializations
+    offset = FIELD - result->text;
+
+    for (i = 0; i < G_N_ELEMENTS (TYPES); i++)
+    {
+      for (link = lw_query_regexgroup_get (query, TYPES[i], LW_RELEVANCE_LOW); link != NULL; link = link->next)
+      {
+        regex = link->data;
+        match_info = NULL;
+        if (regex != NULL && g_regex_match (regex, FIELD, 0, &match_info))
+        {
+          while (g_match_info_matches (match_info))
+          {
+            g_match_info_fetch_pos (match_info, 0, &start, &end);
+            if (end > start)
+            {
+              span.start = offset + start;
+              span.end = offset + end;
+              g_array_append_val (result->spans, span);
+            }
+            g_match_info_next (match_info, NULL);
+          }
+        }
+        if (match_info != NULL) g_match_info_free (match_info); match_info = NULL;
+      }
+    }
+}
+
+
+//!
+//! @brief Finds where a query matches the fields of a result so they can be
+//!        highlighted without searching them again
+//! @param result A parsed LwResult
+//! @param query The LwQuery the result was found with
+//!
+void
+lw_result_find_spans (LwResult *result, LwQuery *query)
+{
+    //Sanity checks
+    g_return_if_fail (result != NULL);
+    g_return_if_fail (query != NULL);
+
+    //Declarations
+    const gchar *fields[64];
+    gint total;
+    gint i;
+    gint j;
+
+    //Initializations
+    total = 0;
+    if (result->spans == NULL) result->spans = g_array_new (FALSE, FALSE, sizeof(LwResultSpan));
+    g_array_set_size (result->spans, 0);
+
+    fields[total++] = result->kanji_start;
+    fields[total++] = result->furigana_start;
+    fields[total++] = result->kanji;
+    fields[total++] = result->radicals;
+    fields[total++] = result->readings[0];
+    fields[total++] = result->readings[1];
+    fields[total++] = result->readings[2];
+    fields[total++] = result->meanings;
+    for (i = 0; result->def_start[i] != NULL && total < G_N_ELEMENTS (fields); i++)
+      fields[total++] = result->def_start[i];
+
+    for (i = 0; i < total; i++)
+    {
+      //Only fields that were parsed out of the text are searched, and only once
+      if (fields[i] == NULL || fields[i] < result->text || fields[i] >= result->text + result->length) continue;
+      for (j = 0; j < i && fields[j] != fields[i]; j++);
+      if (j < i) continue;
+
+      lw_result_find_spans_in_field (result, query, fields[i]);
+    }
+
+    //Dictionaries that aren't parsed into fields are matched as a whole
+    if (result->kanji_start == NULL && result->kanji == NULL && result->def_start[0] == NULL)
+      lw_result_find_spans_in_field (result, query, result->text);
+
+    g_array_sort (result->spans, lw_result_compare_spans);
+}
+
+
+//!
+//! @brief Iterates over the spans of a result that fall inside one of its fields
+//! @param result An LwResult that lw_result_find_spans was called on
+//! @param FIELD One of the fields of the result such as def_start[0]
+//! @param index Where to continue from.  Should be 0 for the first call.
+//! @param start Returns the byte offset in FIELD where the span starts
+//! @param end Returns the byte offset in FIELD where the span ends
+//! @returns FALSE once there are no more spans in the field
+//!
+gboolean
+lw_result_next_span (LwResult *result, const gchar *FIELD, gint *index, gint *start, gint *end)
+{
+    //Sanity checks
+    g_return_val_if_fail (result != NULL, FALSE);
+    g_return_val_if_fail (index != NULL, FALSE);
+    g_return_val_if_fail (start != NULL, FALSE);
+    g_return_val_if_fail (end != NULL, FALSE);
+    if (result->spans == NULL || FIELD == NULL) return FALSE;
+    if (FIELD < result->text || FIELD >= result->text + result->length) return FALSE;
+
+    //Declarations
+    LwResultSpan *span;
+    gint field_start;
+    gint field_end;
+
+    //Initializations
+    field_start = FIELD - result->text;
+    field_end = field_start + strlen (FIELD);
+
+    while (*index < result->spans->len)
+    {
+      span = &g_array_index (result->spans, LwResultSpan, *index);
+      (*index)++;
+
+      if (span->start >= field_end) return FALSE;
+      if (span->start >= field_start && span->end <= field_end)
+      {
+        *start = span->start - field_start;
+        *end = span->end - field_start;
+        return TRUE;
+      }
+    }
+
+    return FALSE;
+}
@@ -0,0 +1,72 @@
+#!/usr/bin/perl -w
+#
+# Compiles romaji.dat into the romaji-table.h transliteration trie used by
+# lw_util_romaji_to_kana ().  Each trie node has one child slot per romaji
+# character (a-z and the long vowel mark '-') and an index into the entry
+# table when a syllable ends at that node.
+#
+
+use strict;
+
+my @entries = ();
+my @nodes = ({ next => {}, entry => -1 });
+my $line = 0;
+
+sub slot {
+    my ($c) = @_;
+    return 26 if $c eq '-';
+    return ord($c) - ord('a');
+}
+
+while (<>) {
+    $line++;
+    chomp;
+    next if /^\s*(#|$)/;
+
+    my ($romaji, $hiragana, $katakana) = split /\s+/;
+    if (!defined $katakana || $romaji !~ /^[a-z-]+$/) {
+        die "Could not parse line $line: $_\n";
+    }
+
+    my $node = 0;
+    foreach my $c (split //, $romaji) {
+        my $s = slot($c);
+        if (!defined $nodes[$node]{next}{$s}) {
+            push @nodes, { next => {}, entry => -1 };
+            $nodes[$node]{next}{$s} = $#nodes;
+        }
+        $node = $nodes[$node]{next}{$s};
+    }
+    die "Duplicate romaji \"$romaji\" on line $line\n" if $nodes[$node]{entry} != -1;
+
+    push @entries, [$romaji, $hiragana, $katakana];
+    $nodes[$node]{entry} = $#entries;
+}
+
+print "/* Generated by romaji-table.pl from romaji.dat.  Do not edit. */\n\n";
+print "#ifndef LW_ROMAJI_TABLE_INCLUDED\n";
+print "#define LW_ROMAJI_TABLE_INCLUDED\n\n";
+print "#define LW_ROMAJI_TRIE_WIDTH 27\n\n";
+print "typedef struct {\n";
+print "  const gchar *romaji;\n";
+print "  const gchar *kana[2];\n";
+print "} LwRomajiEntry;\n\n";
+print "typedef struct {\n";
+print "  gint16 next[LW_ROMAJI_TRIE_WIDTH];\n";
+print "  gint16 entry;\n";
+print "} LwRomajiNode;\n\n";
+
+print "static const LwRomajiEntry lw_romaji_entries[] = {\n";
+foreach my $entry (@entries) {
+    printf "  { \"%s\", { \"%s\", \"%s\" } },\n", @$entry;
+}
+print "};\n\n";
+
+print "static const LwRomajiNode lw_romaji_trie[] = {\n";
+foreach my $node (@nodes) {
+    my @next = map { defined $node->{next}{$_} ? $node->{next}{$_} : 0 } (0..26);
+    printf "  { { %s }, %d },\n", join(", ", @next), $node->{entry};
+}
+print "};\n\n";
+
+print "#endif\n";
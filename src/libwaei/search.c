@@ -27,11 +27,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include <glib.h>
 
 #include <libwaei/libwaei.h>
 
+#define LW_SEARCH_TRACE_CHUNK 1024
+
 static void lw_search_init (LwSearch*, LwDictionary*, const gchar*, LwSearchFlags, GError**);
 static void lw_search_deinit (LwSearch*);
 
@@ -103,12 +106,17 @@ static void
 lw_search_init (LwSearch *search, LwDictionary* dictionary, const gchar* TEXT, LwSearchFlags flags, GError **error)
 {
     g_mutex_init (&search->mutex);
+    g_cond_init (&search->cond);
     search->status = LW_SEARCHSTATUS_IDLE;
     search->dictionary = dictionary;
     search->query = lw_query_new ();
     search->flags = flags;
     search->max = 500;
 
+    //Only edict style entries carry a kanji/furigana headword worth collapsing on
+    if (g_type_is_a (G_OBJECT_TYPE (dictionary), LW_TYPE_EDICTIONARY))
+      search->headwords = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
     lw_search_set_flags (search, flags);
 
     lw_dictionary_parse_query (search->dictionary, search->query, TEXT, error);
@@ -128,10 +136,12 @@ lw_search_deinit (LwSearch *search)
     lw_search_clear_results (search);
     lw_search_cleanup_search (search);
     lw_query_free (search->query);
+    if (search->headwords != NULL) g_hash_table_unref (search->headwords); search->headwords = NULL;
     if (lw_search_has_data (search))
       lw_search_free_data (search);
 
     g_mutex_clear (&search->mutex);
+    g_cond_clear (&search->cond);
 }
 
 
@@ -151,6 +161,8 @@ lw_search_clear_results (LwSearch *search)
       g_list_foreach (search->results[i], (GFunc) lw_result_free, NULL);
       g_list_free (search->results[i]); search->results[i] = NULL;
     }
+
+    if (search->headwords != NULL) g_hash_table_remove_all (search->headwords);
 }
 
 
@@ -189,6 +201,9 @@ lw_search_prepare_search (LwSearch* search)
     search->fd = lw_dictionary_open (LW_DICTIONARY (search->dictionary));
     search->status = LW_SEARCHSTATUS_SEARCHING;
     search->timestamp = g_get_monotonic_time ();
+    memset(&search->stats, 0, sizeof(LwSearchStats));
+    search->stats.io_wait = -1;
+    search->result_memory = 0;
 }
 
 
@@ -222,6 +237,7 @@ lw_search_cleanup_search (LwSearch* search)
     }
 
     search->status = LW_SEARCHSTATUS_FINISHING;
+    g_cond_broadcast (&search->cond);
 }
 
 
@@ -405,10 +421,19 @@ gboolean
 lw_search_parse_result (LwSearch *search)
 {
     gint bytes_read;
+    gint64 start;
 
+    start = g_get_monotonic_time ();
     bytes_read = lw_dictionary_parse_result (search->dictionary, search->result, search->fd);
+    search->stats.parse_time += g_get_monotonic_time () - start;
     search->current += bytes_read;
 
+    if (bytes_read > 0)
+    {
+      search->stats.lines_scanned++;
+      search->stats.bytes_read += bytes_read;
+    }
+
     return (bytes_read > 0 && search->status == LW_SEARCHSTATUS_SEARCHING);
 }
 
@@ -416,7 +441,43 @@ lw_search_parse_result (LwSearch *search)
 gboolean 
 lw_search_compare (LwSearch *search, const LwRelevance RELEVANCE)
 {
-    return lw_dictionary_compare (search->dictionary, search->query, search->result, RELEVANCE);
+    gboolean matches;
+    gint64 start;
+
+    start = g_get_monotonic_time ();
+    matches = lw_dictionary_compare (search->dictionary, search->query, search->result, RELEVANCE);
+    search->stats.compare_time[RELEVANCE] += g_get_monotonic_time () - start;
+
+    return matches;
+}
+
+
+//!
+//! @brief Gets the processor time used by the calling thread in microseconds or -1 if unsupported
+//!
+static gint64
+lw_search_get_thread_cpu_time ()
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    struct timespec time;
+
+    if (clock_gettime (CLOCK_THREAD_CPUTIME_ID, &time) == 0)
+      return ((gint64) time.tv_sec * G_GINT64_CONSTANT (1000000)) + (time.tv_nsec / 1000);
+#endif
+
+    return -1;
+}
+
+
+//!
+//! @brief Tracks the memory held by queued results.  The search must be locked.
+//!
+static void
+lw_search_add_result_memory (LwSearch *search, gssize delta)
+{
+    search->result_memory += delta;
+    if (search->result_memory > search->stats.peak_result_memory)
+      search->stats.peak_result_memory = search->result_memory;
 }
 
 
@@ -442,6 +503,87 @@ lw_search_get_relevance (LwSearch *search) {
 }
 
 
+//!
+//! @brief Checks if a result is an exact copy of a queued one or of one of
+//!        the results already collapsed into it
+//!
+static gboolean
+lw_search_is_duplicate (LwResult *existing, LwResult *result)
+{
+    //Declarations
+    GList *link;
+
+    if (lw_result_is_identical (existing, result)) return TRUE;
+    for (link = existing->similar; link != NULL; link = link->next)
+      if (lw_result_is_identical (LW_RESULT (link->data), result)) return TRUE;
+
+    return FALSE;
+}
+
+
+//!
+//! @brief Collapses the current result into a queued one with the same headword
+//!
+//! THIS IS A PRIVATE FUNCTION. Only exact copies are dropped.  Entries that
+//! share the kanji and reading are attached as an extra sense block.  If the
+//! new entry is more relevant and its relevance isn't full yet, the group is
+//! promoted to it.  A group is final once it is handed off, so a later entry
+//! with its headword starts a new one.  The search must be locked when this
+//! is called.  Only the entries that are kept are compacted and have their
+//! spans found, so dropped copies don't cost a second regex pass.
+//!
+//! @param search A LwSearch whose current result has been matched
+//! @param relevance The relevance of the current result
+//! @return Returns true if the current result was consumed
+//!
+static gboolean
+lw_search_collapse_result (LwSearch *search, LwRelevance relevance)
+{
+    //Declarations
+    LwResult *existing;
+    gchar *key;
+
+    if (search->headwords == NULL) return FALSE;
+
+    //Initializations
+    key = lw_result_build_headword_key (search->result);
+    if (key == NULL) return FALSE;
+    existing = g_hash_table_lookup (search->headwords, key);
+
+    if (existing == NULL)
+    {
+      g_hash_table_insert (search->headwords, key, search->result);
+      return FALSE;
+    }
+
+    g_free (key); key = NULL;
+
+    if (lw_search_is_duplicate (existing, search->result))
+    {
+      return TRUE;
+    }
+
+    if (relevance > existing->relevance && search->total_results[relevance] < search->max)
+    {
+      search->results[existing->relevance] = g_list_remove (search->results[existing->relevance], existing);
+      search->total_results[existing->relevance]--;
+      existing->relevance = relevance;
+      search->results[relevance] = g_list_append (search->results[relevance], existing);
+      search->total_results[relevance]++;
+      if (relevance == LW_RELEVANCE_HIGH) g_cond_broadcast (&search->cond);
+    }
+
+    lw_result_compact (search->result);
+    if (search->flags & LW_SEARCH_FLAG_SPANS) lw_result_find_spans (search->result, search->query);
+    search->result->relevance = relevance;
+    lw_result_add_similar (existing, search->result);
+    lw_search_add_result_memory (search, lw_result_get_size (search->result));
+    search->result = lw_result_new ();
+
+    return TRUE;
+}
+
+
 //!
 //! @brief Preforms the brute work of the search
 //!
@@ -458,12 +600,23 @@ lw_search_stream_results_thread (gpointer data)
     //Declarations
     LwSearch *search;
     gboolean exact;
+    gboolean spans;
     gint relevance;
+    gint64 start;
+    gint64 cpu_start;
+    gint64 cpu_end;
+    gboolean tracing;
 
     //Initializations
     search = LW_SEARCH (data);
     g_return_val_if_fail (search != NULL && search->fd != NULL, NULL);
     exact = search->flags & LW_SEARCH_FLAG_EXACT;
+    spans = search->flags & LW_SEARCH_FLAG_SPANS;
+    start = g_get_monotonic_time ();
+    cpu_start = lw_search_get_thread_cpu_time ();
+    tracing = lw_trace_is_enabled ();
+
+    if (tracing) lw_trace_begin (LW_TRACE_CATEGORY_SEARCH, "scan", lw_dictionary_get_name (search->dictionary));
 
     lw_search_lock (search);
     search->status = LW_SEARCHSTATUS_SEARCHING;
@@ -472,6 +625,11 @@ lw_search_stream_results_thread (gpointer data)
     //reached or we reach the end of the file or a cancel request is recieved.
     while (lw_search_parse_result (search))
     {
+      if (tracing && search->stats.lines_scanned % LW_SEARCH_TRACE_CHUNK == 0)
+      {
+        lw_trace_end (LW_TRACE_CATEGORY_SEARCH, "scan");
+        lw_trace_begin (LW_TRACE_CATEGORY_SEARCH, "scan", NULL);
+      }
       //Give a chance for something else to run
       lw_search_unlock (search);
       if (search->status == LW_SEARCHSTATUS_SEARCHING && g_main_context_pending (NULL))
@@ -482,20 +640,37 @@ lw_search_stream_results_thread (gpointer data)
       //Results match, add to the text buffer
       if (lw_search_compare (search, LW_RELEVANCE_LOW))
       {
+        search->stats.lines_matched++;
         relevance = lw_search_get_relevance (search);
         if (search->total_results[relevance] < search->max)
         {
           if (!exact || (relevance == LW_RELEVANCE_HIGH && exact))
           {
+            if (lw_search_collapse_result (search, relevance)) continue;
+            lw_result_compact (search->result);
+            if (spans) lw_result_find_spans (search->result, search->query);
             search->total_results[relevance]++;
             search->result->relevance = relevance;
             search->results[relevance] = g_list_append (search->results[relevance], search->result);
+            lw_search_add_result_memory (search, lw_result_get_size (search->result));
             search->result = lw_result_new ();
+            //Only high relevance results can be taken before the search finishes
+            if (relevance == LW_RELEVANCE_HIGH) g_cond_broadcast (&search->cond);
           }
         }
       }
     }
 
+    if (tracing) lw_trace_end (LW_TRACE_CATEGORY_SEARCH, "scan");
+
+    //Nothing is collapsed after the scan, so the index isn't needed
+    if (search->headwords != NULL) g_hash_table_remove_all (search->headwords);
+
+    cpu_end = lw_search_get_thread_cpu_time ();
+    search->stats.elapsed = g_get_monotonic_time () - search->timestamp;
+    if (cpu_start >= 0 && cpu_end >= 0)
+      search->stats.io_wait = MAX (0, (g_get_monotonic_time () - start) - (cpu_end - cpu_start));
+
     lw_search_cleanup_search (search);
 
     lw_search_unlock (search);
@@ -531,6 +706,8 @@ lw_search_start (LwSearch *search, gboolean create_thread)
         g_warning ("Thread Creation Error: %s\n", error->message);
         g_error_free (error);
         error = NULL;
+        //Searching in place keeps anyone waiting on results from blocking forever
+        lw_search_stream_results_thread ((gpointer) search);
       }
     }
     else
@@ -566,24 +743,20 @@ lw_search_cancel (LwSearch *search)
 
 
 //!
-//! @brief Gets a result and removes a LwResult from the beginnig of a list of results
-//! @returns a LwResult that should be freed with lw_result_free
+//! @brief Removes the next result that can be handed off.  The search must be locked.
 //!
-LwResult* 
-lw_search_get_result (LwSearch *search)
+static LwResult*
+lw_search_take_result (LwSearch *search)
 {
-    //Sanity checks
-    g_return_val_if_fail (search != NULL, NULL);
-
     //Declarations
     LwResult *result;
     gint relevance;
     gint stop;
+    gchar *key;
 
     //Initializations
     result = NULL; 
-
-    lw_search_lock (search);
+    key = NULL;
 
     if (search->status == LW_SEARCHSTATUS_SEARCHING) stop = LW_RELEVANCE_HIGH;
     else stop = LW_RELEVANCE_LOW;
@@ -594,11 +767,75 @@ lw_search_get_result (LwSearch *search)
       {
         result = LW_RESULT (search->results[relevance]->data);
         search->results[relevance] = g_list_delete_link (search->results[relevance], search->results[relevance]);
+        search->result_memory -= lw_result_get_size (result);
+        //Once handed off the group is final and belongs to the caller
+        if (search->headwords != NULL && g_hash_table_size (search->headwords) > 0)
+        {
+          key = lw_result_build_headword_key (result);
+          if (key != NULL && g_hash_table_lookup (search->headwords, key) == result)
+            g_hash_table_remove (search->headwords, key);
+          if (key != NULL) g_free (key); key = NULL;
+        }
       }
     }
 
     if (result == NULL && search->status == LW_SEARCHSTATUS_FINISHING) search->status = LW_SEARCHSTATUS_IDLE;
 
+    return result;
+}
+
+
+//!
+//! @brief Gets a result and removes a LwResult from the beginnig of a list of results
+//! @returns a LwResult that should be freed with lw_result_free
+//!
+LwResult* 
+lw_search_get_result (LwSearch *search)
+{
+    //Sanity checks
+    g_return_val_if_fail (search != NULL, NULL);
+
+    //Declarations
+    LwResult *result;
+
+    lw_search_lock (search);
+    lw_trace_begin (LW_TRACE_CATEGORY_SEARCH, "take_result", NULL);
+    result = lw_search_take_result (search);
+    lw_trace_end (LW_TRACE_CATEGORY_SEARCH, "take_result");
+    lw_search_unlock (search);
+
+    return result;
+}
+
+
+//!
+//! @brief Blocks until the search produces a result that can be handed off
+//!
+//! This lets a consumer stream results straight out of a threaded search
+//! without polling it from a timeout.
+//!
+//! @returns a LwResult that should be freed with lw_result_free or NULL
+//!          once the search has finished and every result was taken
+//!
+LwResult* 
+lw_search_wait_result (LwSearch *search)
+{
+    //Sanity checks
+    g_return_val_if_fail (search != NULL, NULL);
+
+    //Declarations
+    LwResult *result;
+
+    lw_search_lock (search);
+
+    lw_trace_begin (LW_TRACE_CATEGORY_SEARCH, "wait_result", NULL);
+    while (search->status == LW_SEARCHSTATUS_SEARCHING && search->results[LW_RELEVANCE_HIGH] == NULL)
+    {
+      g_cond_wait (&search->cond, &search->mutex);
+    }
+    result = lw_search_take_result (search);
+    lw_trace_end (LW_TRACE_CATEGORY_SEARCH, "wait_result");
+
     lw_search_unlock (search);
 
     return result;
@@ -606,6 +843,24 @@ lw_search_get_result (LwSearch *search)
 
 
 
+//!
+//! @brief Copies the timing and throughput statistics of the last run of a search
+//! @param search The LwSearch to get the statistics of
+//! @param stats The LwSearchStats to copy them into
+//!
+void
+lw_search_get_stats (LwSearch *search, LwSearchStats *stats)
+{
+    //Sanity checks
+    g_return_if_fail (search != NULL);
+    g_return_if_fail (stats != NULL);
+
+    lw_search_lock (search);
+    *stats = search->stats;
+    lw_search_unlock (search);
+}
+
+
 //!
 //! @brief Tells if you should keep checking for results
 //!
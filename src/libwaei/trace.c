@@ -0,0 +1,212 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+//!
+//! @file trace.c
+//!
+//! @brief Opt-in timeline of search and install phases
+//!
+//! When the LIBWAEI_TRACE environment variable names a file, begin and end
+//! events are written to it in the Chrome trace event format.  The file is
+//! a JSON array that is only closed at exit, which chrome://tracing and
+//! Perfetto both accept, so a trace survives a crash up to the last flush.
+//!
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libwaei/libwaei.h>
+
+#define LW_TRACE_BUFFER_SIZE (256 * 1024)
+
+static FILE *_trace_file = NULL;
+static gint64 _trace_start = 0;
+static gint _trace_next_tid = 0;
+static GMutex _trace_mutex;
+static GPrivate _trace_tid = G_PRIVATE_INIT (NULL);
+
+
+static void
+lw_trace_close ()
+{
+    g_mutex_lock (&_trace_mutex);
+    if (_trace_file != NULL)
+    {
+      fputs ("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"libwaei\"}}\n]\n", _trace_file);
+      fclose (_trace_file);
+      _trace_file = NULL;
+    }
+    g_mutex_unlock (&_trace_mutex);
+}
+
+
+static gpointer
+lw_trace_open (gpointer data)
+{
+    //Declarations
+    const gchar *path;
+
+    //Initializations
+    path = g_getenv (LW_TRACE_ENVIRONMENT_VARIABLE);
+    if (path == NULL || *path == '\0') return NULL;
+
+    _trace_file = g_fopen (path, "w");
+    if (_trace_file == NULL)
+    {
+      g_warning ("Could not open the trace file %s\n", path);
+      return NULL;
+    }
+
+    setvbuf (_trace_file, NULL, _IOFBF, LW_TRACE_BUFFER_SIZE);
+    _trace_start = g_get_monotonic_time ();
+    fputs ("[\n", _trace_file);
+    atexit (lw_trace_close);
+
+    return _trace_file;
+}
+
+
+//!
+//! @brief Tells if tracing was turned on through LIBWAEI_TRACE
+//!
+gboolean
+lw_trace_is_enabled ()
+{
+    static GOnce once = G_ONCE_INIT;
+
+    return (g_once (&once, lw_trace_open, NULL) != NULL);
+}
+
+
+//!
+//! @brief Gives every thread that records events a small stable id
+//!
+static gint
+lw_trace_get_tid ()
+{
+    //Declarations
+    gint tid;
+
+    //Initializations
+    tid = GPOINTER_TO_INT (g_private_get (&_trace_tid));
+
+    if (tid == 0)
+    {
+      tid = g_atomic_int_add (&_trace_next_tid, 1) + 1;
+      g_private_set (&_trace_tid, GINT_TO_POINTER (tid));
+    }
+
+    return tid;
+}
+
+
+static void
+lw_trace_append_escaped (GString *json, const gchar *TEXT)
+{
+    const gchar *ptr;
+
+    for (ptr = TEXT; *ptr != '\0'; ptr++)
+    {
+      if (*ptr == '"' || *ptr == '\\')
+        g_string_append_printf (json, "\\%c", *ptr);
+      else if ((guchar) *ptr < 0x20)
+        g_string_append_printf (json, "\\u%04x", (guchar) *ptr);
+      else
+        g_string_append_c (json, *ptr);
+    }
+}
+
+
+static void
+lw_trace_write (const gchar *CATEGORY, const gchar *NAME, const gchar *DETAIL, gchar phase)
+{
+    //Declarations
+    GString *json;
+    gint64 timestamp;
+
+    //Initializations
+    timestamp = g_get_monotonic_time () - _trace_start;
+    json = g_string_sized_new (128);
+
+    g_string_append (json, "{\"name\":\"");
+    lw_trace_append_escaped (json, NAME);
+    g_string_append (json, "\",\"cat\":\"");
+    lw_trace_append_escaped (json, CATEGORY);
+    g_string_append_printf (json, "\",\"ph\":\"%c\",\"ts\":%" G_GINT64_FORMAT ",\"pid\":1,\"tid\":%d", phase, timestamp, lw_trace_get_tid ());
+    if (DETAIL != NULL)
+    {
+      g_string_append (json, ",\"args\":{\"detail\":\"");
+      lw_trace_append_escaped (json, DETAIL);
+      g_string_append (json, "\"}");
+    }
+    g_string_append (json, "},\n");
+
+    g_mutex_lock (&_trace_mutex);
+    if (_trace_file != NULL) fwrite (json->str, 1, json->len, _trace_file);
+    g_mutex_unlock (&_trace_mutex);
+
+    g_string_free (json, TRUE);
+}
+
+
+//!
+//! @brief Opens a span on the calling thread
+//! @param CATEGORY One of the LW_TRACE_CATEGORY names
+//! @param NAME The name of the span
+//! @param DETAIL Extra text shown with the span or NULL
+//!
+void
+lw_trace_begin (const gchar *CATEGORY, const gchar *NAME, const gchar *DETAIL)
+{
+    if (!lw_trace_is_enabled ()) return;
+
+    lw_trace_write (CATEGORY, NAME, DETAIL, 'B');
+}
+
+
+//!
+//! @brief Closes the last span opened with the same name on the calling thread
+//!
+void
+lw_trace_end (const gchar *CATEGORY, const gchar *NAME)
+{
+    if (!lw_trace_is_enabled ()) return;
+
+    lw_trace_write (CATEGORY, NAME, NULL, 'E');
+}
+
+
+//!
+//! @brief Writes out the buffered events
+//!
+void
+lw_trace_flush ()
+{
+    if (!lw_trace_is_enabled ()) return;
+
+    g_mutex_lock (&_trace_mutex);
+    if (_trace_file != NULL) fflush (_trace_file);
+    g_mutex_unlock (&_trace_mutex);
+}
@@ -38,6 +38,8 @@
 
 #include <libwaei/libwaei.h>
 
+#include "romaji-table.h"
+
 
 //!
 //! @brief Creates an allocated path to a file.  If the FILENAME is NULL,
@@ -440,482 +442,182 @@ lw_util_str_shift_kata_to_hira (char input[])
 
 
 //!
-//! @brief Gets the next hiragana equivalent char pointer in a string
-//!
-//! This function returns the hiragana equivalent and skips the romanji equivalent
-//! forward in the string.  This function is used for romaji->hiragana conversions.
-//!
-//! @param input The string to jump around
-//! @return where the next hiragana equivalent character would start
+//! @brief Returns the trie slot of a romaji character or -1 if it has none
 //!
-const char* 
-lw_util_next_hira_char_from_roma (const char *input)
+static gint
+lw_util_get_romaji_trie_slot (gchar c)
 {
-    const char *input_ptr;
-    input_ptr = input;
+    c = g_ascii_tolower (c);
 
-    int total_n = 0;
-
-    //Cautiously up a character
-    if (*input_ptr == 'n')
-      total_n++;
-    if (*input_ptr != '\0')
-      input_ptr++;
-    if (*input_ptr == '\0')
-      return input_ptr;
-
-    //Loop until we hit a hiragana character ending
-    while ( (
-            //General conditional for hiragana processing
-              *(input_ptr    ) != '\0' &&
-              *(input_ptr - 1) != 'a'  &&
-              *(input_ptr - 1) != 'i'  &&
-              *(input_ptr - 1) != 'u'  &&
-              *(input_ptr - 1) != 'e'  &&
-              *(input_ptr - 1) != 'o'  &&
-              *(input_ptr - 1) != *input_ptr  &&
-              *(input_ptr - 1) != '-'  &&
-              total_n < 3
-            ) ||
-            //Special conditional for symbolic n processing
-            (
-              *(input_ptr    ) != '\0' &&
-              *(input_ptr - 1) == 'n'  &&
-              *(input_ptr    ) == 'n'  &&
-              total_n < 3
-            )
-          )
-    {
-      //Update the n count
-      if (*(input_ptr - 1) == 'n')
-        total_n++;
-      else
-        total_n = 0;
+    if (c >= 'a' && c <= 'z') return c - 'a';
+    if (c == '-') return 26;
 
+    return -1;
+}
 
-      if (*(input_ptr - 1) == 'n' &&
-              *(input_ptr) != 'a'  &&
-              *(input_ptr) != 'i'  &&
-              *(input_ptr) != 'u'  &&
-              *(input_ptr) != 'e'  &&
-              *(input_ptr) != 'o'  &&
-              *(input_ptr) != 'y'
-         )
-        break;
-
-      //Increment
-      input_ptr++;
-    }
-    if (*(input_ptr - 1) == 'n' &&
-            *(input_ptr) == 'n'
-       )
-      input_ptr++;
 
+static gboolean
+lw_util_is_romaji_vowel (gchar c)
+{
+    c = g_ascii_tolower (c);
 
-    return input_ptr;
+    return (c == 'a' || c == 'i' || c == 'u' || c == 'e' || c == 'o');
 }
 
 
 //!
-//! @brief Converts a romaji string to hiragana.
-//! @param input The source romaji string
-//! @param output The string to write the hiragana equivalent to
-//! @return Returns null on error/end
+//! @brief Rewrites macron and circumflex vowels as plain romaji
 //!
-gchar* 
-lw_util_roma_char_to_hira (const gchar *input, gchar *output)
+//! Hepburn long vowels become a doubled vowel for hiragana output (ō → ou)
+//! and a vowel followed by the long vowel mark for katakana output (ō → o-).
+//!
+//! @param TEXT The romaji string to expand
+//! @param script The kana script the text will be converted to
+//! @returns A newly allocated string to be freed with g_free
+//!
+static gchar*
+lw_util_expand_romaji_long_vowels (const gchar *TEXT, LwKanaScript script)
 {
-    //Set up the input pointer
-    const char *input_ptr;
-    input_ptr = input;
+    //Declarations
+    static const gchar *HIRAGANA_LONG_VOWELS[] = { "aa", "ii", "uu", "ei", "ou" };
+    static const gchar *KATAKANA_LONG_VOWELS[] = { "a-", "i-", "u-", "e-", "o-" };
+    GString *expanded;
+    const gchar *ptr;
+    gunichar c;
+    gint index;
 
-    //Make sure the output pointer is initialized
-    output[0] = '\0';
-    
-    //Set up the buffer variables
-    char buffer[] = "           ";
-    char *buffer_ptr = buffer;
-
-    //Copy the next hiragana char written in romaji to the buffer
-    while ( 
-            (
-              *input_ptr != '\0' &&
-              *input_ptr != 'a'  &&
-              *input_ptr != 'i'  &&
-              *input_ptr != 'u'  &&
-              *input_ptr != 'e'  &&
-              *input_ptr != 'o'  &&
-              *input_ptr != '-'  && 
-              *input_ptr != *(input_ptr + 1)  && 
-              *(buffer_ptr + 1) == ' '                
-            ) 
-          )
-    {
-      *buffer_ptr = *input_ptr;
-      input_ptr++;
-      buffer_ptr++;
-    }
-    *buffer_ptr = *input_ptr;
-    buffer_ptr++;
-    *buffer_ptr = '\0';
+    //Initializations
+    expanded = g_string_sized_new (strlen (TEXT) + 1);
 
-    //HACK!!!!!!!!!!!!!!!!
-    if (buffer[0] == 'n' &&
-              buffer[1] != 'a'  &&
-              buffer[1] != 'i'  &&
-              buffer[1] != 'u'  &&
-              buffer[1] != 'e'  &&
-              buffer[1] != 'o'  &&
-              buffer[1] != 'y'
-       )
+    for (ptr = TEXT; *ptr != '\0'; ptr = g_utf8_next_char (ptr))
     {
-       buffer[1] = '\0';
+      c = g_utf8_get_char (ptr);
+      switch (c)
+      {
+        case 0x0100: case 0x0101: case 0x00C2: case 0x00E2: index = 0; break;
+        case 0x012A: case 0x012B: case 0x00CE: case 0x00EE: index = 1; break;
+        case 0x016A: case 0x016B: case 0x00DB: case 0x00FB: index = 2; break;
+        case 0x0112: case 0x0113: case 0x00CA: case 0x00EA: index = 3; break;
+        case 0x014C: case 0x014D: case 0x00D4: case 0x00F4: index = 4; break;
+        default: index = -1; break;
+      }
+
+      if (index == -1)
+        g_string_append_unichar (expanded, c);
+      else if (script == LW_KANA_SCRIPT_KATAKANA)
+        g_string_append (expanded, KATAKANA_LONG_VOWELS[index]);
+      else
+        g_string_append (expanded, HIRAGANA_LONG_VOWELS[index]);
     }
-    else if ( buffer[0] != 'a'  &&
-              buffer[0] != 'i'  &&
-              buffer[0] != 'u'  &&
-              buffer[0] != 'e'  &&
-              buffer[0] != 'o'  &&
-              buffer[0] != 'n'  &&
-              strlen(input) == 1
-            )
+
+    return g_string_free (expanded, FALSE);
+}
+
+
+//!
+//! @brief Converts a whole romaji string to kana in a single pass
+//!
+//! Syllables are looked up by longest match in the trie generated from
+//! romaji.dat.  Doubled consonants become a sokuon and a lone n becomes
+//! the syllabic n.  There is no limit on the length of the text.
+//!
+//! @param TEXT The romaji string to convert
+//! @param script Whether to output hiragana or katakana
+//! @returns A newly allocated kana string to be freed with g_free or NULL if the text is not convertable
+//!
+gchar*
+lw_util_romaji_to_kana (const gchar *TEXT, LwKanaScript script)
+{
+    //Sanity checks
+    g_return_val_if_fail (TEXT != NULL, NULL);
+    g_return_val_if_fail (script >= 0 && script < LW_KANA_SCRIPT_TOTAL, NULL);
+
+    //Declarations
+    const gchar *SYLLABIC_N;
+    const gchar *SOKUON;
+    const LwRomajiNode *node;
+    gchar *romaji;
+    GString *kana;
+    const gchar *ptr;
+    const gchar *iter;
+    const gchar *end;
+    gint entry;
+    gint slot;
+    gchar c;
+    gchar next;
+
+    //Initializations
+    SYLLABIC_N = (script == LW_KANA_SCRIPT_KATAKANA) ? "ン" : "ん";
+    SOKUON = (script == LW_KANA_SCRIPT_KATAKANA) ? "ッ" : "っ";
+    romaji = lw_util_expand_romaji_long_vowels (TEXT, script);
+    kana = g_string_sized_new (strlen (romaji) * 3 + 1);
+    ptr = romaji;
+
+    while (*ptr != '\0')
     {
-       return NULL;
-    }
-    //HACK!!!!!!!!!!!!!!!!
+      c = g_ascii_tolower (ptr[0]);
+      next = g_ascii_tolower (ptr[1]);
 
+      //Syllabic n before a consonant, an apostrophe or the end of the text
+      if (c == 'n' && !lw_util_is_romaji_vowel (next) && next != 'y')
+      {
+        g_string_append (kana, SYLLABIC_N);
+        ptr++;
+        if (next == '\'')
+          ptr++;
+        else if (next == 'n' && !lw_util_is_romaji_vowel (ptr[1]) && g_ascii_tolower (ptr[1]) != 'y')
+          ptr++;
+        continue;
+      }
 
-    //Reset the buffer pointer
-    buffer_ptr = buffer;
+      //Sokuon from a doubled consonant such as kk, or from tch
+      if (g_ascii_isalpha (c) && !lw_util_is_romaji_vowel (c) && c != 'n' &&
+          (next == c || (c == 't' && next == 'c' && g_ascii_tolower (ptr[2]) == 'h')))
+      {
+        g_string_append (kana, SOKUON);
+        ptr++;
+        continue;
+      }
 
+      //Longest matching syllable
+      node = lw_romaji_trie;
+      entry = -1;
+      end = ptr;
+      for (iter = ptr; (slot = lw_util_get_romaji_trie_slot (*iter)) != -1 && node->next[slot] != 0; iter++)
+      {
+        node = &lw_romaji_trie[node->next[slot]];
+        if (node->entry != -1)
+        {
+          entry = node->entry;
+          end = iter + 1;
+        }
+      }
 
-    //
-    //Start main lookup for conversion
-    //
-
-    if (strcmp(buffer_ptr, "n") == 0)
-       strcpy(output, "ん");
-
-
-    else if (strlen(buffer_ptr) == 1 &&
-             buffer_ptr[0] != 'a'    &&
-             buffer_ptr[0] != 'i'    &&
-             buffer_ptr[0] != 'u'    &&
-             buffer_ptr[0] != 'e'    &&
-             buffer_ptr[0] != 'o'    &&
-             buffer_ptr[0] != '-'    &&
-             buffer_ptr[0] != 'y'    &&
-             input_ptr[1] != '\0'      )
-       strcpy(output, "っ");
-
-    else if (strcmp(buffer_ptr, "a") == 0)
-       strcpy(output, "あ");
-    else if (strcmp(buffer_ptr, "i") == 0)
-       strcpy(output, "い");
-    else if (strcmp(buffer_ptr, "u") == 0)
-       strcpy(output, "う");
-    else if (strcmp(buffer_ptr, "e") == 0)
-       strcpy(output, "え");
-    else if (strcmp(buffer_ptr, "o") == 0)
-       strcpy(output, "お");
-
-
-    else if (strcmp(buffer_ptr, "ka") == 0 || strcmp(buffer_ptr, "ca") == 0)
-       strcpy(output, "か");
-    else if (strcmp(buffer_ptr, "ki") == 0 || strcmp(buffer_ptr, "ci") == 0)
-       strcpy(output, "き");
-    else if (strcmp(buffer_ptr, "ku") == 0 || strcmp(buffer_ptr, "cu") == 0)
-       strcpy(output, "く");
-    else if (strcmp(buffer_ptr, "ke") == 0 || strcmp(buffer_ptr, "ce") == 0)
-       strcpy(output, "け");
-    else if (strcmp(buffer_ptr, "ko") == 0 || strcmp(buffer_ptr, "co") == 0)
-       strcpy(output, "こ");
-
-    else if (strcmp(buffer_ptr, "kya") == 0 || strcmp(buffer_ptr, "cya") == 0)
-       strcpy(output, "きゃ");
-    else if (strcmp(buffer_ptr, "kyu") == 0 || strcmp(buffer_ptr, "cyu") == 0)
-       strcpy(output, "きゅ");
-    else if (strcmp(buffer_ptr, "kyo") == 0 || strcmp(buffer_ptr, "cyo") == 0)
-       strcpy(output, "きょ");
-
-    else if (strcmp(buffer_ptr, "ga") == 0)
-       strcpy(output, "が");
-    else if (strcmp(buffer_ptr, "gi") == 0)
-       strcpy(output, "ぎ");
-    else if (strcmp(buffer_ptr, "gu") == 0)
-       strcpy(output, "ぐ");
-    else if (strcmp(buffer_ptr, "ge") == 0)
-       strcpy(output, "げ");
-    else if (strcmp(buffer_ptr, "go") == 0)
-       strcpy(output, "ご");
-
-    else if (strcmp(buffer_ptr, "gya") == 0)
-       strcpy(output, "ぎゃ");
-    else if (strcmp(buffer_ptr, "gyu") == 0)
-       strcpy(output, "ぎゅ");
-    else if (strcmp(buffer_ptr, "gyo") == 0)
-       strcpy(output, "ぎょ");
-
-
-    else if (strcmp(buffer_ptr, "sa") == 0)
-       strcpy(output, "さ");
-    else if (strcmp(buffer_ptr, "si") == 0 || strcmp(buffer_ptr, "shi") == 0)
-       strcpy(output, "し");
-    else if (strcmp(buffer_ptr, "su") == 0)
-       strcpy(output, "す");
-    else if (strcmp(buffer_ptr, "se") == 0)
-       strcpy(output, "せ");
-    else if (strcmp(buffer_ptr, "so") == 0)
-       strcpy(output, "そ");
-
-    else if (strcmp(buffer_ptr, "sya") == 0 || strcmp(buffer_ptr, "sha") == 0)
-       strcpy(output, "しゃ");
-    else if (strcmp(buffer_ptr, "syu") == 0 || strcmp(buffer_ptr, "shu") == 0)
-       strcpy(output, "しゅ");
-    else if (strcmp(buffer_ptr, "syo") == 0 || strcmp(buffer_ptr, "sho") == 0)
-       strcpy(output, "しょ");
-
-    else if (strcmp(buffer_ptr, "za") == 0)
-       strcpy(output, "ざ");
-    else if (strcmp(buffer_ptr, "zi") == 0 || strcmp(buffer_ptr, "ji") == 0)
-       strcpy(output, "じ");
-    else if (strcmp(buffer_ptr, "zu") == 0)
-       strcpy(output, "ず");
-    else if (strcmp(buffer_ptr, "ze") == 0)
-       strcpy(output, "ぜ");
-    else if (strcmp(buffer_ptr, "zo") == 0)
-       strcpy(output, "ぞ");
-
-    else if (strcmp(buffer_ptr, "zya") == 0 || strcmp(buffer_ptr, "jya") == 0
-                                            || strcmp(buffer_ptr, "ja" ) == 0 )
-       strcpy(output, "じゃ");
-    else if (strcmp(buffer_ptr, "zyu") == 0 || strcmp(buffer_ptr, "jyu") == 0
-                                            || strcmp(buffer_ptr, "ju" ) == 0 )
-       strcpy(output, "じゅ");
-    else if (strcmp(buffer_ptr, "zyo") == 0 || strcmp(buffer_ptr, "jyo") == 0
-                                            || strcmp(buffer_ptr, "jo" ) == 0 )
-       strcpy(output, "じょ");
-
-
-    else if (strcmp(buffer_ptr, "ta") == 0)
-       strcpy(output, "た");
-    else if (strcmp(buffer_ptr, "ti") == 0 || strcmp(buffer_ptr, "chi") == 0)
-       strcpy(output, "ち");
-    else if (strcmp(buffer_ptr, "tu") == 0 || strcmp(buffer_ptr, "tsu") == 0)
-       strcpy(output, "つ");
-    else if (strcmp(buffer_ptr, "te") == 0)
-       strcpy(output, "て");
-    else if (strcmp(buffer_ptr, "to") == 0)
-       strcpy(output, "と");
-
-    else if (strcmp(buffer_ptr, "tya") == 0 || strcmp(buffer_ptr, "cha") == 0)
-       strcpy(output, "ちゃ");
-    else if (strcmp(buffer_ptr, "tyu") == 0 || strcmp(buffer_ptr, "chu") == 0)
-       strcpy(output, "ちゅ");
-    else if (strcmp(buffer_ptr, "tyo") == 0 || strcmp(buffer_ptr, "cho") == 0)
-       strcpy(output, "ちょ");
-
-    else if (strcmp(buffer_ptr, "da") == 0)
-       strcpy(output, "だ");
-    else if (strcmp(buffer_ptr, "di") == 0)
-       strcpy(output, "ぢ");
-    else if (strcmp(buffer_ptr, "du") == 0 || strcmp(buffer_ptr, "dsu") == 0)
-       strcpy(output, "づ");
-    else if (strcmp(buffer_ptr, "de") == 0)
-       strcpy(output, "で");
-    else if (strcmp(buffer_ptr, "do") == 0)
-       strcpy(output, "ど");
-
-    else if (strcmp(buffer_ptr, "dya") == 0)
-       strcpy(output, "ぢゃ");
-    else if (strcmp(buffer_ptr, "dyu") == 0)
-       strcpy(output, "ぢゅ");
-    else if (strcmp(buffer_ptr, "dyo") == 0)
-       strcpy(output, "ぢょ");
-
-
-    else if (strcmp(buffer_ptr, "na") == 0)
-       strcpy(output, "な");
-    else if (strcmp(buffer_ptr, "ni") == 0)
-       strcpy(output, "に");
-    else if (strcmp(buffer_ptr, "nu") == 0)
-       strcpy(output, "ぬ");
-    else if (strcmp(buffer_ptr, "ne") == 0)
-       strcpy(output, "ね");
-    else if (strcmp(buffer_ptr, "no") == 0)
-       strcpy(output, "の");
-
-    else if (strcmp(buffer_ptr, "nya") == 0)
-       strcpy(output, "にゃ");
-    else if (strcmp(buffer_ptr, "nyu") == 0)
-       strcpy(output, "にゅ");
-    else if (strcmp(buffer_ptr, "nyo") == 0)
-       strcpy(output, "にょ");
-
-
-    else if (strcmp(buffer_ptr, "ha") == 0)
-       strcpy(output, "は");
-    else if (strcmp(buffer_ptr, "hi") == 0)
-       strcpy(output, "ひ");
-    else if (strcmp(buffer_ptr, "hu") == 0 || strcmp(buffer_ptr, "fu") == 0)
-       strcpy(output, "ふ");
-    else if (strcmp(buffer_ptr, "he") == 0)
-       strcpy(output, "へ");
-    else if (strcmp(buffer_ptr, "ho") == 0)
-       strcpy(output, "ほ");
-
-    else if (strcmp(buffer_ptr, "hya") == 0)
-       strcpy(output, "ひゃ");
-    else if (strcmp(buffer_ptr, "hyu") == 0)
-       strcpy(output, "ひゅ");
-    else if (strcmp(buffer_ptr, "hyo") == 0)
-       strcpy(output, "ひょ");
-   
-    else if (strcmp(buffer_ptr, "ba") == 0)
-       strcpy(output, "ば");
-    else if (strcmp(buffer_ptr, "bi") == 0)
-       strcpy(output, "び");
-    else if (strcmp(buffer_ptr, "bu") == 0)
-       strcpy(output, "ぶ");
-    else if (strcmp(buffer_ptr, "be") == 0)
-       strcpy(output, "べ");
-    else if (strcmp(buffer_ptr, "bo") == 0)
-       strcpy(output, "ぼ");
-
-    else if (strcmp(buffer_ptr, "bya") == 0)
-       strcpy(output, "びゃ");
-    else if (strcmp(buffer_ptr, "byu") == 0)
-       strcpy(output, "びゅ");
-    else if (strcmp(buffer_ptr, "byo") == 0)
-       strcpy(output, "びょ");
-
-    else if (strcmp(buffer_ptr, "pa") == 0)
-       strcpy(output, "ぱ");
-    else if (strcmp(buffer_ptr, "pi") == 0)
-       strcpy(output, "ぴ");
-    else if (strcmp(buffer_ptr, "pu") == 0)
-       strcpy(output, "ぷ");
-    else if (strcmp(buffer_ptr, "pe") == 0)
-       strcpy(output, "ぺ");
-    else if (strcmp(buffer_ptr, "po") == 0)
-       strcpy(output, "ぽ");
-
-    else if (strcmp(buffer_ptr, "pya") == 0)
-       strcpy(output, "ぴゃ");
-    else if (strcmp(buffer_ptr, "pyu") == 0)
-       strcpy(output, "ぴゅ");
-    else if (strcmp(buffer_ptr, "pyo") == 0)
-       strcpy(output, "ぴょ");
-
-
-    else if (strcmp(buffer_ptr, "ma") == 0)
-       strcpy(output, "ま");
-    else if (strcmp(buffer_ptr, "mi") == 0)
-       strcpy(output, "み");
-    else if (strcmp(buffer_ptr, "mu") == 0)
-       strcpy(output, "む");
-    else if (strcmp(buffer_ptr, "me") == 0)
-       strcpy(output, "め");
-    else if (strcmp(buffer_ptr, "mo") == 0)
-       strcpy(output, "も");
-
-    else if (strcmp(buffer_ptr, "mya") == 0)
-       strcpy(output, "みゃ");
-    else if (strcmp(buffer_ptr, "myu") == 0)
-       strcpy(output, "みゅ");
-    else if (strcmp(buffer_ptr, "myo") == 0)
-       strcpy(output, "みょ");
-
-
-    else if (strcmp(buffer_ptr, "ya") == 0)
-       strcpy(output, "や");
-    else if (strcmp(buffer_ptr, "yu") == 0)
-       strcpy(output, "ゆ");
-    else if (strcmp(buffer_ptr, "yo") == 0)
-       strcpy(output, "よ");
-
-
-    else if (strcmp(buffer_ptr, "ra") == 0 || strcmp(buffer_ptr, "la") == 0)
-       strcpy(output, "ら");
-    else if (strcmp(buffer_ptr, "ri") == 0 || strcmp(buffer_ptr, "li") == 0)
-       strcpy(output, "り");
-    else if (strcmp(buffer_ptr, "ru") == 0 || strcmp(buffer_ptr, "lu") == 0)
-       strcpy(output, "る");
-    else if (strcmp(buffer_ptr, "re") == 0 || strcmp(buffer_ptr, "le") == 0)
-       strcpy(output, "れ");
-    else if (strcmp(buffer_ptr, "ro") == 0 || strcmp(buffer_ptr, "lo") == 0)
-       strcpy(output, "ろ");
-
-    else if (strcmp(buffer_ptr, "rya") == 0 || strcmp(buffer_ptr, "lya") == 0)
-       strcpy(output, "りゃ");
-    else if (strcmp(buffer_ptr, "ryu") == 0 || strcmp(buffer_ptr, "lyu") == 0)
-       strcpy(output, "りゅ");
-    else if (strcmp(buffer_ptr, "ryo") == 0 || strcmp(buffer_ptr, "lyo") == 0)
-       strcpy(output, "りょ");
-
-
-    else if (strcmp(buffer_ptr, "wa") == 0)
-       strcpy(output, "わ");
-    else if (strcmp(buffer_ptr, "wi") == 0)
-       strcpy(output, "うぃ");
-    else if (strcmp(buffer_ptr, "we") == 0)
-       strcpy(output, "うぇ");
-    else if (strcmp(buffer_ptr, "wo") == 0)
-       strcpy(output, "を");
-
-    else if (strcmp(buffer_ptr, "va") == 0)
-       strcpy(output, "う゛ぁ");
-    else if (strcmp(buffer_ptr, "vi") == 0)
-       strcpy(output, "う゛ぃ");
-    else if (strcmp(buffer_ptr, "ve") == 0)
-       strcpy(output, "う゛ぇ");
-    else if (strcmp(buffer_ptr, "vo") == 0)
-       strcpy(output, "う゛ぉ");
-
-
-    else if (strcmp(buffer_ptr, "xa") == 0)
-       strcpy(output, "ぁ");
-    else if (strcmp(buffer_ptr, "xi") == 0)
-       strcpy(output, "ぃ");
-    else if (strcmp(buffer_ptr, "xu") == 0)
-       strcpy(output, "ぅ");
-    else if (strcmp(buffer_ptr, "xe") == 0)
-       strcpy(output, "ぇ");
-    else if (strcmp(buffer_ptr, "xo") == 0)
-       strcpy(output, "ぉ");
-
-
-    else if (strcmp(buffer_ptr, "fa") == 0)
-       strcpy(output, "ふぁ");
-    else if (strcmp(buffer_ptr, "fi") == 0)
-       strcpy(output, "ふぃ");
-    else if (strcmp(buffer_ptr, "fe") == 0)
-       strcpy(output, "ふぇ");
-    else if (strcmp(buffer_ptr, "fo") == 0)
-       strcpy(output, "ふぉ");
-   
+      if (entry == -1) break;
 
-    else if (strcmp(buffer_ptr, "-") == 0)
-       strcpy(output, "ー");
+      g_string_append (kana, lw_romaji_entries[entry].kana[script]);
+      ptr = end;
+    }
 
-    else
+    if (*ptr != '\0' || kana->len == 0)
     {
-      input_ptr = NULL;
-      return NULL;
+      g_string_free (kana, TRUE); kana = NULL;
     }
 
-    return output;
+    g_free (romaji); romaji = NULL;
+
+    return (kana != NULL) ? g_string_free (kana, FALSE) : NULL;
 }
 
 
 //!
-//! @brief Convenience function to convert romaji to hiragana
+//! @brief Convenience function to convert romaji to hiragana into a fixed buffer
 //!
-//! @param input The string to shift.
+//! @param input The string to convert.
 //! @param output the string to output the changes to.
-//! @param max The max length of the string to output to.
-//! @see lw_util_shift_kana_chars_in_str_by ()
-//! @see lw_util_str_shift_hira_to_kata ()
+//! @param max The size of the output buffer.
+//! @returns Returns true if the whole string was converted and fit in the buffer
+//! @see lw_util_romaji_to_kana ()
 //!
 gboolean 
 lw_util_str_roma_to_hira (const gchar* input, gchar* output, gint max)
@@ -923,32 +625,20 @@ lw_util_str_roma_to_hira (const gchar* input, gchar* output, gint max)
     //Sanity checks
     g_return_val_if_fail (input != NULL, FALSE);
     g_return_val_if_fail (output != NULL, FALSE);
+    g_return_val_if_fail (max > 0, FALSE);
 
     //Declarations
-    const gchar *input_ptr;
-    gchar *kana_ptr;
-    gint leftover;
+    gchar *kana;
+    gboolean converted;
 
     //Initializations
-    input_ptr = input;
-    kana_ptr = output;
-    *kana_ptr = '\0';
-    leftover = max;
-
-    //Try converting to hiragana
-    while (leftover-- > 0)
-    {
-      kana_ptr = lw_util_roma_char_to_hira (input_ptr, kana_ptr);
-      if (kana_ptr == NULL || input_ptr == NULL)
-        break;
-      input_ptr = lw_util_next_hira_char_from_roma (input_ptr);
-      if (kana_ptr == NULL || input_ptr == NULL)
-        break;
+    kana = lw_util_romaji_to_kana (input, LW_KANA_SCRIPT_HIRAGANA);
+    converted = (kana != NULL && g_strlcpy (output, kana, max) < (gsize) max);
 
-      kana_ptr = &kana_ptr[strlen(kana_ptr)];
-    }
+    if (!converted) *output = '\0';
+    if (kana != NULL) g_free (kana); kana = NULL;
 
-    return (input_ptr != NULL && strlen (input_ptr) == 0);
+    return converted;
 }
 
 
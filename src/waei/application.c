@@ -76,8 +76,6 @@ w_application_constructed (GObject *object)
     {
       G_OBJECT_CLASS (w_application_parent_class)->constructed (object);
     }
-
-    lw_regex_initialize ();
 }
 
 
@@ -95,6 +93,8 @@ w_application_finalize (GObject *object)
     if (priv->installable_dictionarylist != NULL) g_object_unref (priv->installable_dictionarylist); priv->installable_dictionarylist = NULL;
     if (priv->context != NULL) g_option_context_free (priv->context); priv->context = NULL;
     if (priv->arg_query_text_data != NULL) g_free(priv->arg_query_text_data); priv->arg_query_text_data = NULL;
+    if (priv->arg_batch_switch_data != NULL) g_free(priv->arg_batch_switch_data); priv->arg_batch_switch_data = NULL;
+    if (priv->arg_socket_switch_data != NULL) g_free(priv->arg_socket_switch_data); priv->arg_socket_switch_data = NULL;
     if (priv->preferences != NULL) lw_preferences_free (priv->preferences); priv->preferences = NULL;
 
     lw_regex_free ();
@@ -133,6 +133,9 @@ w_application_parse_args (WApplication *application, int *argc, char** argv[])
     //Reset the switches to their default state
     if (priv->arg_dictionary_switch_data != NULL) g_free (priv->arg_dictionary_switch_data); priv->arg_dictionary_switch_data = NULL;
     if (priv->arg_query_text_data != NULL) g_free (priv->arg_query_text_data); priv->arg_query_text_data = NULL;
+    if (priv->arg_batch_switch_data != NULL) g_free (priv->arg_batch_switch_data); priv->arg_batch_switch_data = NULL;
+    priv->arg_jobs_switch_data = 1;
+    if (priv->arg_socket_switch_data != NULL) g_free (priv->arg_socket_switch_data); priv->arg_socket_switch_data = NULL;
     priv->arg_version_switch = FALSE;
     error = NULL;
     if (priv->context != NULL) g_option_context_free (priv->context); priv->context = NULL;
@@ -151,7 +154,9 @@ w_application_parse_args (WApplication *application, int *argc, char** argv[])
            "  waei %s                 When you don't know a kanji character\n"
            "  waei -d Kanji %s           Find a kanji character in the kanji dictionary\n"
            "  waei -d Names %s       Look up a name in the names dictionary\n"
-           "  waei -d Places %s       Look up a place in the places dictionary"
+           "  waei -d Places %s       Look up a place in the places dictionary\n"
+           "  waei -b words.txt          Look up every line of words.txt in one run\n"
+           "  waei --serve               Keep waei loaded to answer --client searches"
          )
          , "にほん", "にほん", "日本", "日本", "日.語", "魚", "Miyabe", "Tokyo"
     );
@@ -161,8 +166,15 @@ w_application_parse_args (WApplication *application, int *argc, char** argv[])
       { "color", 'c', 0, G_OPTION_ARG_NONE, &(priv->arg_color_switch), gettext("Display results with color"), NULL },
       { "dictionary", 'd', 0, G_OPTION_ARG_STRING, &(priv->arg_dictionary_switch_data), gettext("Search using a chosen dictionary"), NULL },
       { "list", 'l', 0, G_OPTION_ARG_NONE, &(priv->arg_list_switch), gettext("Show available dictionaries for searches"), NULL },
-      { "install", 'i', 0, G_OPTION_ARG_STRING, &(priv->arg_install_switch_data), gettext("Install dictionary"), NULL },
+      { "install", 'i', 0, G_OPTION_ARG_STRING, &(priv->arg_install_switch_data), gettext("Install dictionaries, separated by commas"), NULL },
       { "uninstall", 'u', 0, G_OPTION_ARG_STRING, &(priv->arg_uninstall_switch_data), gettext("Uninstall dictionary"), NULL },
+      { "update", 'U', 0, G_OPTION_ARG_STRING, &(priv->arg_update_switch_data), gettext("Update installed dictionaries from their sources, separated by commas"), NULL },
+      { "batch", 'b', 0, G_OPTION_ARG_FILENAME, &(priv->arg_batch_switch_data), gettext("Search for each line of a file, or of stdin when FILE is -"), "FILE" },
+      { "jobs", 'j', 0, G_OPTION_ARG_INT, &(priv->arg_jobs_switch_data), gettext("Number of batch queries or dictionary installs to run in parallel"), "N" },
+      { "stats", 0, 0, G_OPTION_ARG_NONE, &(priv->arg_stats_switch), gettext("Print the startup time and where the time of the search went"), NULL },
+      { "serve", 0, 0, G_OPTION_ARG_NONE, &(priv->arg_serve_switch), gettext("Keep the dictionaries loaded and answer searches over a socket"), NULL },
+      { "client", 0, 0, G_OPTION_ARG_NONE, &(priv->arg_client_switch), gettext("Send the search to a running waei --serve"), NULL },
+      { "socket", 0, 0, G_OPTION_ARG_FILENAME, &(priv->arg_socket_switch_data), gettext("Socket used by --serve and --client"), "PATH" },
       { "version", 'v', 0, G_OPTION_ARG_NONE, &(priv->arg_version_switch), gettext("Check the waei version information"), NULL },
       { NULL }
     };
@@ -304,11 +316,13 @@ w_application_run (WApplication *application, int *argc, char **argv[])
     WApplicationPrivate *priv;
     GError *error;
     int resolution;
+    gint64 ready_time;
 
     //Initializations
     resolution = 0;
     priv = application->priv;
     error = NULL;
+    ready_time = g_get_monotonic_time ();
 
     //User wants to see what dictionaries are available
     if (priv->arg_list_switch)
@@ -326,6 +340,22 @@ w_application_run (WApplication *application, int *argc, char **argv[])
     else if (priv->arg_uninstall_switch_data != NULL)
       resolution = w_console_uninstall_dictionary (application, &error);
 
+    //User wants to refresh installed dictionaries
+    else if (priv->arg_update_switch_data != NULL)
+      resolution = w_console_update_dictionary (application, &error);
+
+    //User wants to keep waei loaded for other searches
+    else if (priv->arg_serve_switch)
+      resolution = w_server_run (application, &error);
+
+    //User wants to search for a list of queries
+    else if (priv->arg_batch_switch_data != NULL)
+      resolution = w_console_batch_search (application, &error);
+
+    //User wants a running server to do a search
+    else if (priv->arg_client_switch && priv->arg_query_text_data != NULL)
+      resolution = w_server_client_search (application, &error);
+
     //User wants to do a search
     else if (priv->arg_query_text_data != NULL)
       resolution = w_console_search (application, &error);
@@ -341,6 +371,13 @@ w_application_run (WApplication *application, int *argc, char **argv[])
       }
     }
 
+    //Startup is everything before the requested action, which libwaei only sets up as it needs it
+    if (priv->arg_stats_switch && priv->start_time > 0)
+    {
+      fprintf (stderr, "%-22s %10.3f ms\n", gettext("Startup:"), (gdouble) (ready_time - priv->start_time) / 1000.0);
+      fprintf (stderr, "%-22s %10.3f ms\n", gettext("Total:"), (gdouble) (g_get_monotonic_time () - priv->start_time) / 1000.0);
+    }
+
     //Cleanup
     w_application_handle_error (application, &error);
 
@@ -393,6 +430,33 @@ w_application_get_color_switch (WApplication *application)
 }
 
 
+gboolean
+w_application_get_serve_switch (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_serve_switch;
+}
+
+
+gboolean
+w_application_get_client_switch (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_client_switch;
+}
+
+
+gboolean
+w_application_get_stats_switch (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_stats_switch;
+}
+
+
 const gchar*
 w_application_get_dictionary_switch_data (WApplication *application)
 {
@@ -420,6 +484,24 @@ w_application_get_uninstall_switch_data (WApplication *application)
 }
 
 
+void
+w_application_set_start_time (WApplication *application, gint64 start_time)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  priv->start_time = start_time;
+}
+
+
+const gchar*
+w_application_get_update_switch_data (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_update_switch_data;
+}
+
+
 const gchar*
 w_application_get_query_text_data (WApplication *application)
 {
@@ -428,3 +510,29 @@ w_application_get_query_text_data (WApplication *application)
   return priv->arg_query_text_data;
 }
 
+
+const gchar*
+w_application_get_batch_switch_data (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_batch_switch_data;
+}
+
+
+gint
+w_application_get_jobs_switch_data (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_jobs_switch_data;
+}
+
+
+const gchar*
+w_application_get_socket_switch_data (WApplication *application)
+{
+  WApplicationPrivate *priv;
+  priv = application->priv;
+  return priv->arg_socket_switch_data;
+}
@@ -32,6 +32,11 @@
 
 #include <glib.h>
 
+#ifdef HAVE_CONFIG_H
+#include "../../config.h"
+#endif
+
+#include <waei/gettext.h>
 #include <waei/waei.h>
 
 gint 
@@ -93,40 +98,30 @@ w_console_update_progress_cb (LwDictionary *dictionary, gpointer data)
 }
 
 
-gboolean 
-w_console_append_result_timeout (gpointer data)
+//!
+//! @brief Prints the combined progress of several dictionaries installing at
+//!        once.  Called from the install threads, so printing is serialized.
+//!
+void 
+w_console_update_total_progress_cb (LwDictionary *dictionary, gpointer data)
 {
-  //Sanity checks
-  g_return_val_if_fail (data != NULL, FALSE);
-
-  //Declarations
-  LwSearch *search;
-  LwSearchStatus status;
-  WSearchData *sdata;
-  gint chunk;
-  gboolean keep_appending;
-
-  //Initializations
-  search = LW_SEARCH (data);
-  status = lw_search_get_status (search);
-  sdata = W_SEARCHDATA (lw_search_get_data (search));
-  chunk = 50;
-
-  if  (status != LW_SEARCHSTATUS_IDLE)
-  {
-    while (lw_search_has_results (search) && chunk-- > 0)
+    //Declarations
+    static GMutex mutex;
+    static gint previous_percent = -1;
+    WApplication *application;
+    LwDictionaryList *dictionarylist;
+    gint percent;
+
+    //Initializations
+    application = W_APPLICATION (data);
+    dictionarylist = w_application_get_installable_dictionarylist (application);
+    percent = (gint) (100.0 * lw_dictionarylist_installer_get_total_progress (dictionarylist));
+
+    g_mutex_lock (&mutex);
+    if (percent != previous_percent)
     {
-      w_console_append_result (sdata->application, search);
+      fprintf(stdout, "\r [%d%%] %s", percent, gettext("Installing dictionaries...")); fflush(stdout);
+      previous_percent = percent;
     }
-    keep_appending = TRUE;
-  }
-  else
-  {
-      w_console_no_result (sdata->application, search);
-      g_main_loop_quit (sdata->loop);
-      keep_appending = FALSE;
-  }
-
-  return keep_appending;
+    g_mutex_unlock (&mutex);
 }
-
@@ -38,18 +38,55 @@
 #include <waei/waei.h>
 
 
-static void w_console_append_edict_result (WApplication*, LwSearch*);
-static void w_console_append_kanjidict_result (WApplication*, LwSearch*);
-static void w_console_append_examplesdict_result (WApplication*, LwSearch*);
-static void w_console_append_unknowndict_result (WApplication*, LwSearch*);
+static void w_console_append_edict_result (LwResult*, gboolean, GString*);
+static void w_console_append_kanjidict_result (LwResult*, gboolean, GString*);
+static void w_console_append_examplesdict_result (LwResult*, gboolean, GString*);
+static void w_console_append_unknowndict_result (LwResult*, gboolean, GString*);
 
-void 
-w_console_append_result (WApplication *application, LwSearch *search)
+
+//!
+//! @brief Appends a field of a result, making where the search found the
+//!        query in it bold when colors are on
+//!
+static void
+w_console_append_field (LwResult *result, const gchar *FIELD, gboolean color_switch, GString *output)
 {
-    //Sanity checks
-    g_return_if_fail (application != NULL);
-    g_return_if_fail (search != NULL);
+    //Declarations
+    gint index;
+    gint start;
+    gint end;
+    gint written;
+
+    if (FIELD == NULL) return;
+
+    //Initializations
+    index = 0;
+    written = 0;
+
+    while (color_switch && lw_result_next_span (result, FIELD, &index, &start, &end))
+    {
+      if (end <= written) continue;
+      if (start < written) start = written;
+      g_string_append_len (output, FIELD + written, start - written);
+      g_string_append (output, "[1m");
+      g_string_append_len (output, FIELD + start, end - start);
+      g_string_append (output, "[22m");
+      written = end;
+    }
+    g_string_append (output, FIELD + written);
+}
 
+
+//!
+//! @brief Formats a result of a search into a string
+//! @param search The LwSearch the result came from
+//! @param result The LwResult to format
+//! @param color_switch Whether to color the result with escape sequences
+//! @param output The GString to append the formatted result to
+//!
+static void
+w_console_format_result_full (LwSearch *search, LwResult *result, gboolean color_switch, GString *output)
+{
     //Declarations
     GType type;
 
@@ -57,76 +94,184 @@ w_console_append_result (WApplication *application, LwSearch *search)
     type = G_OBJECT_TYPE (search->dictionary);
 
     if (g_type_is_a (type, LW_TYPE_EDICTIONARY))
-      w_console_append_edict_result (application, search);
+      w_console_append_edict_result (result, color_switch, output);
     else if (g_type_is_a (type, LW_TYPE_KANJIDICTIONARY))
-      w_console_append_kanjidict_result (application, search);
+      w_console_append_kanjidict_result (result, color_switch, output);
     else if (g_type_is_a (type, LW_TYPE_EXAMPLEDICTIONARY))
-      w_console_append_examplesdict_result (application, search);
+      w_console_append_examplesdict_result (result, color_switch, output);
     else if (g_type_is_a (type, LW_TYPE_UNKNOWNDICTIONARY))
-      w_console_append_unknowndict_result (application, search);
+      w_console_append_unknowndict_result (result, color_switch, output);
     else
       g_warning ("%s\n", gettext("This is an unknown dictionary type!"));
 }
 
 
+//!
+//! @brief Formats a result of a search into a string
+//! @param application The WApplication to get the output switches from
+//! @param search The LwSearch the result came from
+//! @param result The LwResult to format
+//! @param output The GString to append the formatted result to
+//!
+void
+w_console_format_result (WApplication *application, LwSearch *search, LwResult *result, GString *output)
+{
+    //Sanity checks
+    g_return_if_fail (application != NULL);
+    g_return_if_fail (search != NULL);
+    g_return_if_fail (result != NULL);
+    g_return_if_fail (output != NULL);
+
+    w_console_format_result_full (search, result, w_application_get_color_switch (application), output);
+}
+
+
+//!
+//! @brief Takes the next result from a search and formats it into a string
+//!        with colors set by the caller instead of the application
+//! @param search The LwSearch to take the result from
+//! @param color_switch Whether to color the result with escape sequences
+//! @param output The GString to append the formatted result to
+//! @returns Returns false if the search had no result ready
+//!
+gboolean
+w_console_append_result_to_string_full (LwSearch *search, gboolean color_switch, GString *output)
+{
+    //Sanity checks
+    g_return_val_if_fail (search != NULL, FALSE);
+    g_return_val_if_fail (output != NULL, FALSE);
+
+    //Declarations
+    LwResult *result;
+
+    //Initializations
+    result = lw_search_get_result (search);
+    if (result == NULL) return FALSE;
+
+    w_console_format_result_full (search, result, color_switch, output);
+
+    //Cleanup
+    lw_result_free (result);
+
+    return TRUE;
+}
+
+
+//!
+//! @brief Takes the next result from a search and formats it into a string
+//! @param application The WApplication to get the output switches from
+//! @param search The LwSearch to take the result from
+//! @param output The GString to append the formatted result to
+//! @returns Returns false if the search had no result ready
+//!
+gboolean
+w_console_append_result_to_string (WApplication *application, LwSearch *search, GString *output)
+{
+    //Sanity checks
+    g_return_val_if_fail (application != NULL, FALSE);
+
+    return w_console_append_result_to_string_full (search, w_application_get_color_switch (application), output);
+}
+
+
+void 
+w_console_append_result (WApplication *application, LwSearch *search)
+{
+    //Sanity checks
+    g_return_if_fail (application != NULL);
+    g_return_if_fail (search != NULL);
+
+    //Declarations
+    GString *output;
+
+    //Initializations
+    output = g_string_sized_new (512);
+
+    if (w_console_append_result_to_string (application, search, output))
+      fputs (output->str, stdout);
+
+    //Cleanup
+    g_string_free (output, TRUE);
+}
+
+
 //!
 //! @brief Not yet written
 //!
 static void 
-w_console_append_edict_result (WApplication *application, LwSearch *search)
+w_console_append_edict_result (LwResult *result, gboolean color_switch, GString *output)
 {
     //Definitions
-    LwResult *result;
-    gboolean color_switch;
+    LwResult *similar;
+    GList *link;
     gint cont;
 
     //Initializations
-    result = lw_search_get_result (search);
-    if (result == NULL) return;
-    color_switch = w_application_get_color_switch (application);
     cont = 0;
 
     //Kanji
     if (result->kanji_start)
     {
       if (color_switch)
-        printf("[32m%s", result->kanji_start);
-      else
-        printf("%s", result->kanji_start);
+        g_string_append (output, "[32m");
+      w_console_append_field (result, result->kanji_start, color_switch, output);
     }
     //Furigana
     if (result->furigana_start)
-      printf(" [%s]", result->furigana_start);
+    {
+      g_string_append (output, " [");
+      w_console_append_field (result, result->furigana_start, color_switch, output);
+      g_string_append_c (output, ']');
+    }
     //Other info
     if (result->classification_start)
     {
       if (color_switch)
-        printf(" [0m %s", result->classification_start);
+        g_string_append_printf (output, " [0m %s", result->classification_start);
       else
-        printf(" %s", result->classification_start);
+        g_string_append_printf (output, " %s", result->classification_start);
     }
     //Important Flag
     if (result->important)
     {
       if (color_switch)
-        printf(" [0m %s", "P");
+        g_string_append_printf (output, " [0m %s", "P");
       else
-        printf(" %s", "P");
+        g_string_append_printf (output, " %s", "P");
     }
 
-    printf("\n");
+    g_string_append_c (output, '\n');
     while (cont < result->def_total)
     {
       if (color_switch)
-        printf("[0m      [35m%s [0m%s\n", result->number[cont], result->def_start[cont]);
+        g_string_append_printf (output, "[0m      [35m%s [0m", result->number[cont]);
       else
-        printf("      %s %s\n", result->number[cont], result->def_start[cont]);
+        g_string_append_printf (output, "      %s ", result->number[cont]);
+      w_console_append_field (result, result->def_start[cont], color_switch, output);
+      g_string_append_c (output, '\n');
       cont++;
     }
-    printf("\n");
 
-    //Cleanup
-    lw_result_free (result);
+    //Sense blocks of entries collapsed into this one by the search
+    for (link = result->similar; link != NULL; link = link->next)
+    {
+      similar = LW_RESULT (link->data);
+      if (similar->classification_start)
+        g_string_append_printf (output, "    %s", similar->classification_start);
+      if (similar->important)
+        g_string_append_printf (output, " %s", "P");
+      g_string_append_c (output, '\n');
+      for (cont = 0; cont < similar->def_total; cont++)
+      {
+        if (color_switch)
+          g_string_append_printf (output, "[0m      [35m%s [0m", similar->number[cont]);
+        else
+          g_string_append_printf (output, "      %s ", similar->number[cont]);
+        w_console_append_field (similar, similar->def_start[cont], color_switch, output);
+        g_string_append_c (output, '\n');
+      }
+    }
+    g_string_append_c (output, '\n');
 }
 
 
@@ -134,76 +279,86 @@ w_console_append_edict_result (WApplication *application, LwSearch *search)
 //! @brief Not yet written
 //!
 static void 
-w_console_append_kanjidict_result (WApplication *application, LwSearch *search)
+w_console_append_kanjidict_result (LwResult *result, gboolean color_switch, GString *output)
 {
-    if (search == NULL) return;
-
     //Definitions
-    LwResult *result;
-    gboolean color_switch;
     gboolean line_started;
 
     //Initializations
-    result = lw_search_get_result (search);
-    if (result == NULL) return;
-    color_switch = w_application_get_color_switch (application);
     line_started = FALSE;
 
     //Kanji
     if (color_switch)
-      printf("[32;1m%s[0m\n", result->kanji);
+      g_string_append_printf (output, "[32;1m%s[0m\n", result->kanji);
     else
-      printf("%s\n", result->kanji);
+      g_string_append_printf (output, "%s\n", result->kanji);
 
     if (result->radicals)
-      printf("%s%s\n", gettext("Radicals:"), result->radicals);
+    {
+      g_string_append (output, gettext("Radicals:"));
+      w_console_append_field (result, result->radicals, color_switch, output);
+      g_string_append_c (output, '\n');
+    }
 
     if (result->strokes)
     {
       line_started = TRUE;
-      printf("%s%s", gettext("Stroke:"), result->strokes);
+      g_string_append_printf (output, "%s%s", gettext("Stroke:"), result->strokes);
     }
 
     if (result->frequency)
     {
       if (line_started)
-        printf(" ");
+        g_string_append_c (output, ' ');
       line_started = TRUE;
-      printf("%s%s", gettext("Freq:"), result->frequency);
+      g_string_append_printf (output, "%s%s", gettext("Freq:"), result->frequency);
     }
 
     if (result->grade)
     {
       if (line_started)
-        printf(" ");
+        g_string_append_c (output, ' ');
       line_started = TRUE;
-      printf("%s%s", gettext("Grade:"), result->grade);
+      g_string_append_printf (output, "%s%s", gettext("Grade:"), result->grade);
     }
 
     if (result->jlpt)
     {
       if (line_started)
-        printf(" ");
+        g_string_append_c (output, ' ');
       line_started = TRUE;
-      printf("%s%s", gettext("JLPT:"), result->jlpt);
+      g_string_append_printf (output, "%s%s", gettext("JLPT:"), result->jlpt);
     }
 
     if (line_started)
-      printf("\n");
+      g_string_append_c (output, '\n');
 
     if (result->readings[0])
-      printf("%s%s\n", gettext("Readings:"), result->readings[0]);
+    {
+      g_string_append (output, gettext("Readings:"));
+      w_console_append_field (result, result->readings[0], color_switch, output);
+      g_string_append_c (output, '\n');
+    }
     if (result->readings[1])
-      printf("%s%s\n", gettext("Name:"), result->readings[1]);
+    {
+      g_string_append (output, gettext("Name:"));
+      w_console_append_field (result, result->readings[1], color_switch, output);
+      g_string_append_c (output, '\n');
+    }
     if (result->readings[2])
-      printf("%s%s\n", gettext("Radical Name:"), result->readings[2]);
+    {
+      g_string_append (output, gettext("Radical Name:"));
+      w_console_append_field (result, result->readings[2], color_switch, output);
+      g_string_append_c (output, '\n');
+    }
 
     if (result->meanings)
-      printf("%s%s\n", gettext("Meanings:"), result->meanings);
-    printf("\n");
-
-    //Cleanup
-    lw_result_free (result);
+    {
+      g_string_append (output, gettext("Meanings:"));
+      w_console_append_field (result, result->meanings, color_switch, output);
+      g_string_append_c (output, '\n');
+    }
+    g_string_append_c (output, '\n');
 }
 
 
@@ -211,50 +366,36 @@ w_console_append_kanjidict_result (WApplication *application, LwSearch *search)
 //! @brief Not yet written
 //!
 static void 
-w_console_append_examplesdict_result (WApplication *application, LwSearch *search)
+w_console_append_examplesdict_result (LwResult *result, gboolean color_switch, GString *output)
 {
-    if (search == NULL) return;
-
-    //Definitions
-    LwResult *result;
-    gboolean color_switch;
-
-    //Initializations
-    result = lw_search_get_result (search);
-    if (result == NULL) return;
-    color_switch = w_application_get_color_switch (application);
-
     if (result->def_start[0] != NULL)
     {
       if (color_switch)
-        printf ("[32;1m%s[0m", gettext("E:\t"));
+        g_string_append_printf (output, "[32;1m%s[0m", gettext("E:\t"));
       else
-        printf ("%s", gettext("E:\t"));
-      printf ("%s", result->def_start[0]);
+        g_string_append (output, gettext("E:\t"));
+      w_console_append_field (result, result->def_start[0], color_switch, output);
     }
 
     if (result->kanji_start != NULL)
     {
       if (color_switch)
-        printf ("[32;1m%s[0m", gettext("\nJ:\t"));
+        g_string_append_printf (output, "[32;1m%s[0m", gettext("\nJ:\t"));
       else
-        printf ("%s", gettext("\nJ:\t"));
-      printf ("%s", result->kanji_start);
+        g_string_append (output, gettext("\nJ:\t"));
+      w_console_append_field (result, result->kanji_start, color_switch, output);
     }
 
     if (result->furigana_start != NULL)
     {
       if (color_switch)
-        printf("[32;1m%s[0m", gettext("\nD:\t"));
+        g_string_append_printf (output, "[32;1m%s[0m", gettext("\nD:\t"));
       else
-        printf("%s", gettext("\nD:\t"));
-      printf("%s", result->furigana_start);
+        g_string_append (output, gettext("\nD:\t"));
+      w_console_append_field (result, result->furigana_start, color_switch, output);
     }
 
-    printf("\n\n");
-
-    //Cleanup
-    lw_result_free (result);
+    g_string_append (output, "\n\n");
 }
 
 
@@ -262,21 +403,10 @@ w_console_append_examplesdict_result (WApplication *application, LwSearch *searc
 //! @brief Not yet written
 //!
 static void 
-w_console_append_unknowndict_result (WApplication *application, LwSearch *search)
+w_console_append_unknowndict_result (LwResult *result, gboolean color_switch, GString *output)
 {
-    if (search == NULL) return;
-
-    //Definitions
-    LwResult *result;
-
-    //Initializations
-    result = lw_search_get_result (search);
-    if (result == NULL) return;
-
-    printf("%s\n", result->text);
-
-    //Cleanup
-    lw_result_free (result);
+    w_console_append_field (result, result->text, color_switch, output);
+    g_string_append_c (output, '\n');
 }
 
 
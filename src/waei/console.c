@@ -33,6 +33,7 @@
 #include <string.h>
 
 #include <glib.h>
+#include <glib/gstdio.h>
 
 #ifdef HAVE_CONFIG_H
 #include "../../config.h"
@@ -41,6 +42,8 @@
 #include <waei/gettext.h>
 #include <waei/waei.h>
 
+#define W_CONSOLE_OUTPUT_BUFFER_SIZE (64 * 1024)
+
 
 //!
 //! @brief Uninstalls the named dictionary, deleting it.
@@ -86,7 +89,8 @@ w_console_uninstall_dictionary (WApplication* application, GError **error)
 
 
 //!
-//! @brief Installs the named dictionary, deleting it.
+//! @brief Installs the named dictionaries.  Several names can be given separated
+//!        by commas, in which case up to --jobs of them install at the same time.
 //!
 //! @param name A string of the name of the dictionary to install.
 //!
@@ -99,36 +103,73 @@ w_console_install_dictionary (WApplication *application, GError **error)
     //Declarations
     LwDictionaryList *dictionarylist;
     LwDictionary *dictionary;
+    GList *link;
+    GList *selected;
     gint resolution;
+    gint jobs;
     gulong signalid;
+    GCallback callback;
     const gchar *install_switch_data;
+    gchar **names;
+    gchar **nameiter;
 
     //Initializations
     install_switch_data = w_application_get_install_switch_data (application);
     dictionarylist = w_application_get_installable_dictionarylist (application);
-    dictionary = lw_dictionarylist_get_dictionary_fuzzy (dictionarylist, install_switch_data);
+    names = g_strsplit (install_switch_data, ",", -1);
+    jobs = w_application_get_jobs_switch_data (application);
+    selected = NULL;
     resolution = 0;
 
-    if (dictionary != NULL)
+    for (link = lw_dictionarylist_get_list (dictionarylist); link != NULL; link = link->next)
+      lw_dictionary_set_selected (LW_DICTIONARY (link->data), FALSE);
+
+    for (nameiter = names; *nameiter != NULL; nameiter++)
     {
-      printf(gettext("Installing %s Dictionary...\n"), lw_dictionary_get_name (dictionary));
-      signalid = g_signal_connect (G_OBJECT (dictionary), "progress-changed", G_CALLBACK (w_console_update_progress_cb), application);
-      lw_dictionary_install (dictionary, NULL, error);
-      if (g_signal_handler_is_connected (G_OBJECT (dictionary), signalid))
-        g_signal_handler_disconnect (G_OBJECT (dictionary), signalid);
-      if (*error == NULL) 
+      dictionary = lw_dictionarylist_get_dictionary_fuzzy (dictionarylist, g_strstrip (*nameiter));
+      if (dictionary == NULL)
       {
-        printf("\n%s\n", gettext("Installation complete."));
+        printf("\n%s was not found!\n\n", *nameiter);
+        w_console_print_installable_dictionaries (application);
+        resolution = 1;
+        goto errored;
       }
-      else
+      if (!lw_dictionary_is_selected (dictionary))
       {
-        printf ("\n%s\n", gettext("Installation failed!"));
+        lw_dictionary_set_selected (dictionary, TRUE);
+        selected = g_list_append (selected, dictionary);
       }
     }
+
+    //One dictionary shows its install stages, several show their combined progress
+    if (g_list_length (selected) > 1)
+      callback = G_CALLBACK (w_console_update_total_progress_cb);
+    else
+      callback = G_CALLBACK (w_console_update_progress_cb);
+
+    for (link = selected; link != NULL; link = link->next)
+    {
+      dictionary = LW_DICTIONARY (link->data);
+      printf(gettext("Installing %s Dictionary...\n"), lw_dictionary_get_name (dictionary));
+      g_signal_connect (G_OBJECT (dictionary), "progress-changed", callback, application);
+    }
+
+    lw_dictionarylist_install (dictionarylist, jobs, NULL, error);
+
+    for (link = selected; link != NULL; link = link->next)
+    {
+      dictionary = LW_DICTIONARY (link->data);
+      signalid = g_signal_handler_find (G_OBJECT (dictionary), G_SIGNAL_MATCH_FUNC | G_SIGNAL_MATCH_DATA, 0, 0, NULL, callback, application);
+      if (signalid != 0) g_signal_handler_disconnect (G_OBJECT (dictionary), signalid);
+    }
+
+    if (*error == NULL) 
+    {
+      printf("\n%s\n", gettext("Installation complete."));
+    }
     else
     {
-      printf("\n%s was not found!\n\n", install_switch_data);
-      w_console_print_installable_dictionaries (application);
+      printf ("\n%s\n", gettext("Installation failed!"));
     }
 
     if (*error != NULL)
@@ -136,6 +177,71 @@ w_console_install_dictionary (WApplication *application, GError **error)
       resolution = 1;
     }
 
+errored:
+    //Cleanup
+    if (selected != NULL) g_list_free (selected); selected = NULL;
+    if (names != NULL) g_strfreev (names); names = NULL;
+
+    return resolution;
+}
+
+
+//!
+//! @brief Updates the named installed dictionaries from their sources one
+//!        after the other, only writing what changed in them.
+//!
+gint 
+w_console_update_dictionary (WApplication *application, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return 1;
+
+    //Declarations
+    LwDictionaryList *dictionarylist;
+    LwDictionary *dictionary;
+    gint resolution;
+    gulong signalid;
+    const gchar *update_switch_data;
+    gchar **names;
+    gchar **nameiter;
+
+    //Initializations
+    update_switch_data = w_application_get_update_switch_data (application);
+    dictionarylist = w_application_get_installable_dictionarylist (application);
+    names = g_strsplit (update_switch_data, ",", -1);
+    resolution = 0;
+
+    for (nameiter = names; *nameiter != NULL && *error == NULL; nameiter++)
+    {
+      dictionary = lw_dictionarylist_get_dictionary_fuzzy (dictionarylist, g_strstrip (*nameiter));
+      if (dictionary == NULL)
+      {
+        printf("\n%s was not found!\n\n", *nameiter);
+        w_console_print_installable_dictionaries (application);
+        resolution = 1;
+        goto errored;
+      }
+
+      printf(gettext("Updating %s Dictionary...\n"), lw_dictionary_get_name (dictionary));
+      signalid = g_signal_connect (G_OBJECT (dictionary), "progress-changed", G_CALLBACK (w_console_update_progress_cb), application);
+      lw_dictionary_update (dictionary, NULL, error);
+      g_signal_handler_disconnect (G_OBJECT (dictionary), signalid);
+    }
+
+    if (*error == NULL) 
+    {
+      printf("\n%s\n", gettext("Update complete."));
+    }
+    else
+    {
+      printf ("\n%s\n", gettext("Update failed!"));
+      resolution = 1;
+    }
+
+errored:
+    //Cleanup
+    if (names != NULL) g_strfreev (names); names = NULL;
+
     return resolution;
 }
 
@@ -268,6 +374,40 @@ w_console_handle_error (WApplication* app, GError **error)
 }
 
 
+//!
+//! @brief Prints the timing and throughput statistics of a search to stderr
+//!
+void
+w_console_print_stats (WApplication *application, LwSearch *search)
+{
+    //Declarations
+    LwSearchStats stats;
+    gdouble seconds;
+
+    //Initializations
+    lw_search_get_stats (search, &stats);
+    seconds = (gdouble) stats.elapsed / 1000000.0;
+
+    fprintf (stderr, "\n");
+    fprintf (stderr, "%-22s %10.3f ms\n", gettext("Elapsed:"), (gdouble) stats.elapsed / 1000.0);
+    if (stats.io_wait >= 0)
+      fprintf (stderr, "%-22s %10.3f ms\n", gettext("Blocked on I/O:"), (gdouble) stats.io_wait / 1000.0);
+    fprintf (stderr, "%-22s %10.3f ms\n", gettext("Reading and parsing:"), (gdouble) stats.parse_time / 1000.0);
+    fprintf (stderr, "%-22s %10.3f ms\n", gettext("Comparing (low):"), (gdouble) stats.compare_time[LW_RELEVANCE_LOW] / 1000.0);
+    fprintf (stderr, "%-22s %10.3f ms\n", gettext("Comparing (medium):"), (gdouble) stats.compare_time[LW_RELEVANCE_MEDIUM] / 1000.0);
+    fprintf (stderr, "%-22s %10.3f ms\n", gettext("Comparing (high):"), (gdouble) stats.compare_time[LW_RELEVANCE_HIGH] / 1000.0);
+    fprintf (stderr, "%-22s %10" G_GINT64_FORMAT "\n", gettext("Lines scanned:"), stats.lines_scanned);
+    fprintf (stderr, "%-22s %10" G_GINT64_FORMAT "\n", gettext("Lines matched:"), stats.lines_matched);
+    fprintf (stderr, "%-22s %10" G_GINT64_FORMAT "\n", gettext("Bytes read:"), stats.bytes_read);
+    if (seconds > 0.0)
+    {
+      fprintf (stderr, "%-22s %10.0f\n", gettext("Lines per second:"), (gdouble) stats.lines_scanned / seconds);
+      fprintf (stderr, "%-22s %10.2f MiB/s\n", gettext("Throughput:"), (gdouble) stats.bytes_read / seconds / (1024.0 * 1024.0));
+    }
+    fprintf (stderr, "%-22s %10" G_GSIZE_FORMAT " KiB\n", gettext("Peak result memory:"), stats.peak_result_memory / 1024);
+}
+
+
 gint 
 w_console_search (WApplication *application, GError **error)
 {
@@ -275,9 +415,10 @@ w_console_search (WApplication *application, GError **error)
     if (error != NULL && *error != NULL) return FALSE;
 
     //Declarations
-    WSearchData *sdata;
     LwSearch *search;
+    LwResult *result;
     LwDictionaryList *dictionarylist;
+    GString *output;
 //    LwPreferences* preferences;
 
     const gchar* dictionary_switch_data;
@@ -291,7 +432,6 @@ w_console_search (WApplication *application, GError **error)
     char *message_relevant;
     LwDictionary *dictionary;
     gint resolution;
-    GMainLoop *loop;
     LwSearchFlags flags;
 
     //Initializations
@@ -305,6 +445,7 @@ w_console_search (WApplication *application, GError **error)
 
     dictionary = lw_dictionarylist_get_dictionary_fuzzy (dictionarylist, dictionary_switch_data);
     if (exact_switch) flags = flags | LW_SEARCH_FLAG_EXACT;
+    if (w_application_get_color_switch (application)) flags = flags | LW_SEARCH_FLAG_SPANS;
     if (dictionary == NULL) printf("dictionary equals zero! %s\n", dictionary_switch_data);
     search = lw_search_new (dictionary, query_text_data, flags, error);
     resolution = 0;
@@ -331,22 +472,23 @@ w_console_search (WApplication *application, GError **error)
       printf("\n");
     }
 
-    loop = g_main_loop_new (NULL, FALSE); 
-    sdata = w_searchdata_new (loop, application);
-    lw_search_set_data (search, sdata, LW_SEARCH_DATA_FREE_FUNC (w_searchdata_free));
-
-    //Print the results
+    //Print the results as the search thread produces them
+    output = g_string_sized_new (W_CONSOLE_OUTPUT_BUFFER_SIZE);
     lw_search_start (search, TRUE);
 
-    g_timeout_add_full (
-        G_PRIORITY_LOW,
-        100,
-        (GSourceFunc) w_console_append_result_timeout,
-        search,
-        NULL
-    );
+    while ((result = lw_search_wait_result (search)) != NULL)
+    {
+      w_console_format_result (application, search, result, output);
+      lw_result_free (result); result = NULL;
 
-    g_main_loop_run (loop);
+      if (output->len >= W_CONSOLE_OUTPUT_BUFFER_SIZE)
+      {
+        fwrite (output->str, 1, output->len, stdout);
+        g_string_truncate (output, 0);
+      }
+    }
+    fwrite (output->str, 1, output->len, stdout);
+    g_string_free (output, TRUE); output = NULL;
 
     //Print final header
     if (quiet_switch == FALSE)
@@ -365,9 +507,299 @@ w_console_search (WApplication *application, GError **error)
 
     lw_search_cancel (search);
 
+    if (w_application_get_stats_switch (application))
+      w_console_print_stats (application, search);
+
     //Cleanup
     lw_search_free (search);
-    g_main_loop_unref (loop);
+
+    return 0;
+}
+
+
+//!
+//! @brief A query of a batch search and the record it produced
+//!
+struct _WBatchItem {
+  gchar *query;
+  GString *output;
+  gboolean done;
+};
+typedef struct _WBatchItem WBatchItem;
+
+//!
+//! @brief State shared by every query of a batch search
+//!
+struct _WBatch {
+  WApplication *application;
+  LwDictionary *dictionary;
+  LwSearchFlags flags;
+  GMutex mutex;
+  GCond cond;
+};
+typedef struct _WBatch WBatch;
+
+
+static WBatchItem*
+w_console_batchitem_new (const gchar *QUERY)
+{
+    WBatchItem *item;
+
+    item = g_new0 (WBatchItem, 1);
+    item->query = g_strdup (QUERY);
+    item->output = g_string_sized_new (1024);
+    item->done = FALSE;
+
+    return item;
+}
+
+
+static void
+w_console_batchitem_free (WBatchItem *item)
+{
+    if (item == NULL) return;
+
+    g_free (item->query); item->query = NULL;
+    g_string_free (item->output, TRUE); item->output = NULL;
+    g_free (item);
+}
+
+
+//!
+//! @brief Searches for one query of a batch and formats its record
+//!
+//! A record starts with a "# query" line followed by the results in the
+//! same format as a single search.  The search runs synchronously in the
+//! calling thread against the dictionaries already loaded by the application.
+//!
+static void
+w_console_batch_search_query (WBatch *batch, WBatchItem *item)
+{
+    //Declarations
+    LwSearch *search;
+    GError *error;
+    gboolean quiet_switch;
+    gint total_results;
+    gint total_relevant_results;
+
+    //Initializations
+    error = NULL;
+    quiet_switch = w_application_get_quiet_switch (batch->application);
+    search = lw_search_new (batch->dictionary, item->query, batch->flags, &error);
+
+    g_string_append_printf (item->output, "# %s\n", item->query);
+
+    if (search != NULL)
+    {
+      lw_search_start (search, FALSE);
+      while (w_console_append_result_to_string (batch->application, search, item->output));
+
+      if (!quiet_switch)
+      {
+        total_results = lw_search_get_total_results (search);
+        total_relevant_results = lw_search_get_total_relevant_results (search);
+        if (total_results == 0)
+        {
+          g_string_append_printf (item->output, "%s\n\n", gettext("No results found!"));
+        }
+        else
+        {
+          g_string_append_printf (item->output, ngettext("Found %d result", "Found %d results", total_results), total_results);
+          if (total_relevant_results != total_results)
+            g_string_append_printf (item->output, ngettext("(%d Relevant)", "(%d Relevant)", total_relevant_results), total_relevant_results);
+          g_string_append (item->output, "\n\n");
+        }
+      }
+
+      lw_search_free (search); search = NULL;
+    }
+
+    if (error != NULL)
+    {
+      g_string_append_printf (item->output, "# Error: %s\n\n", error->message);
+      g_error_free (error); error = NULL;
+    }
+}
+
+
+static void
+w_console_batch_search_thread (gpointer data, gpointer user_data)
+{
+    //Declarations
+    WBatchItem *item;
+    WBatch *batch;
+
+    //Initializations
+    item = data;
+    batch = user_data;
+
+    w_console_batch_search_query (batch, item);
+
+    g_mutex_lock (&batch->mutex);
+    item->done = TRUE;
+    g_cond_broadcast (&batch->cond);
+    g_mutex_unlock (&batch->mutex);
+}
+
+
+//!
+//! @brief Waits for the oldest pending query and writes its record out
+//!
+static void
+w_console_batch_flush_head (WBatch *batch, GQueue *pending)
+{
+    //Declarations
+    WBatchItem *item;
+
+    //Initializations
+    item = g_queue_pop_head (pending);
+    if (item == NULL) return;
+
+    g_mutex_lock (&batch->mutex);
+    while (!item->done)
+    {
+      g_cond_wait (&batch->cond, &batch->mutex);
+    }
+    g_mutex_unlock (&batch->mutex);
+
+    fputs (item->output->str, stdout);
+
+    w_console_batchitem_free (item);
+}
+
+
+//!
+//! @brief Reads a whole line of any length from a file
+//! @param file The FILE to read from
+//! @param line A GString that is replaced with the line including its newline
+//! @returns FALSE at the end of the file
+//!
+static gboolean
+w_console_read_line (FILE *file, GString *line)
+{
+    //Declarations
+    gchar buffer[LW_IO_MAX_FGETS_LINE];
+
+    g_string_truncate (line, 0);
+
+    while (fgets (buffer, LW_IO_MAX_FGETS_LINE, file) != NULL)
+    {
+      g_string_append (line, buffer);
+      if (line->len > 0 && line->str[line->len - 1] == '\n') break;
+    }
+
+    return (line->len > 0);
+}
+
+
+//!
+//! @brief Searches for every newline separated query in a file or stdin
+//!
+//! The dictionary list, regexes and preferences are loaded once and shared
+//! by every query.  With --jobs greater than one, queries are searched in
+//! parallel but their records are still written out in input order.
+//!
+gint
+w_console_batch_search (WApplication *application, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return 1;
+
+    //Declarations
+    LwDictionaryList *dictionarylist;
+    LwDictionary *dictionary;
+    const gchar *dictionary_switch_data;
+    const gchar *batch_switch_data;
+    GString *line;
+    gchar *query;
+    FILE *file;
+    WBatch batch;
+    WBatchItem *item;
+    GThreadPool *pool;
+    GQueue pending;
+    gint jobs;
+    gint window;
+
+    //Initializations
+    dictionarylist = w_application_get_installed_dictionarylist (application);
+    dictionary_switch_data = w_application_get_dictionary_switch_data (application);
+    batch_switch_data = w_application_get_batch_switch_data (application);
+    jobs = w_application_get_jobs_switch_data (application);
+    if (jobs < 1) jobs = 1;
+    window = jobs * 4;
+    dictionary = lw_dictionarylist_get_dictionary_fuzzy (dictionarylist, dictionary_switch_data);
+    pool = NULL;
+    line = NULL;
+    g_queue_init (&pending);
+
+    if (dictionary == NULL)
+    {
+      fprintf (stderr, gettext("Requested dictionary not found!\n"));
+      return 1;
+    }
+
+    if (strcmp (batch_switch_data, "-") == 0)
+      file = stdin;
+    else
+      file = g_fopen (batch_switch_data, "r");
+
+    if (file == NULL)
+    {
+      *error = g_error_new (g_quark_from_string (LW_IO_ERROR), LW_IO_READ_ERROR, gettext("Could not open %s"), batch_switch_data);
+      return 1;
+    }
+
+    batch.application = application;
+    batch.dictionary = dictionary;
+    batch.flags = 0;
+    if (w_application_get_exact_switch (application)) batch.flags |= LW_SEARCH_FLAG_EXACT;
+    if (w_application_get_color_switch (application)) batch.flags |= LW_SEARCH_FLAG_SPANS;
+    g_mutex_init (&batch.mutex);
+    g_cond_init (&batch.cond);
+
+    if (jobs > 1)
+    {
+      pool = g_thread_pool_new (w_console_batch_search_thread, &batch, jobs, TRUE, error);
+      if (pool == NULL) w_console_handle_error (application, error);
+    }
+
+    line = g_string_sized_new (LW_IO_MAX_FGETS_LINE);
+
+    while (w_console_read_line (file, line))
+    {
+      query = g_strstrip (line->str);
+      if (*query == '\0') continue;
+
+      item = w_console_batchitem_new (query);
+      g_queue_push_tail (&pending, item);
+
+      if (pool != NULL)
+      {
+        g_thread_pool_push (pool, item, NULL);
+        while (g_queue_get_length (&pending) >= window)
+        {
+          w_console_batch_flush_head (&batch, &pending);
+        }
+      }
+      else
+      {
+        w_console_batch_search_thread (item, &batch);
+        w_console_batch_flush_head (&batch, &pending);
+      }
+    }
+
+    while (!g_queue_is_empty (&pending))
+    {
+      w_console_batch_flush_head (&batch, &pending);
+    }
+    fflush (stdout);
+
+    //Cleanup
+    if (pool != NULL) g_thread_pool_free (pool, FALSE, TRUE); pool = NULL;
+    if (line != NULL) g_string_free (line, TRUE); line = NULL;
+    if (file != stdin) fclose (file); file = NULL;
+    g_mutex_clear (&batch.mutex);
+    g_cond_clear (&batch.cond);
 
     return 0;
 }
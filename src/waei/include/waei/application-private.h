@@ -16,13 +16,21 @@ struct _WApplicationPrivate {
   gboolean arg_list_switch;
   gboolean arg_version_switch;
   gboolean arg_color_switch;
+  gboolean arg_serve_switch;
+  gboolean arg_client_switch;
+  gboolean arg_stats_switch;
 
   gchar* arg_dictionary_switch_data;
   gchar* arg_install_switch_data;
   gchar* arg_uninstall_switch_data;
+  gchar* arg_update_switch_data;
   gchar* arg_query_text_data;
+  gchar* arg_batch_switch_data;
+  gint arg_jobs_switch_data;
+  gchar* arg_socket_switch_data;
 
   GOptionContext *context;
+  gint64 start_time;            //!< Monotonic time main was entered, for --stats
 };
 
 #define W_APPLICATION_GET_PRIVATE(object)(G_TYPE_INSTANCE_GET_PRIVATE ((object), W_TYPE_APPLICATION, WApplicationPrivate))
@@ -43,10 +43,18 @@ gboolean w_application_get_exact_switch (WApplication*);
 gboolean w_application_get_list_switch (WApplication*);
 gboolean w_application_get_version_switch (WApplication*);
 gboolean w_application_get_color_switch (WApplication*);
+gboolean w_application_get_serve_switch (WApplication*);
+gboolean w_application_get_client_switch (WApplication*);
+gboolean w_application_get_stats_switch (WApplication*);
 const gchar* w_application_get_dictionary_switch_data (WApplication*);
 const gchar* w_application_get_install_switch_data (WApplication*);
 const gchar* w_application_get_uninstall_switch_data (WApplication*);
+const gchar* w_application_get_update_switch_data (WApplication*);
 const gchar* w_application_get_query_text_data (WApplication*);
+const gchar* w_application_get_batch_switch_data (WApplication*);
+gint w_application_get_jobs_switch_data (WApplication*);
+void w_application_set_start_time (WApplication*, gint64);
+const gchar* w_application_get_socket_switch_data (WApplication*);
 
 G_END_DECLS
 
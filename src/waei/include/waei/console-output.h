@@ -2,6 +2,9 @@
 #define W_CONSOLE_OUTPUT_INCLUDED
 
 void w_console_append_result (WApplication*, LwSearch*);
+void w_console_format_result (WApplication*, LwSearch*, LwResult*, GString*);
+gboolean w_console_append_result_to_string (WApplication*, LwSearch*, GString*);
+gboolean w_console_append_result_to_string_full (LwSearch*, gboolean, GString*);
 void w_console_no_result (WApplication*, LwSearch*);
 
 #endif
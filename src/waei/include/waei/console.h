@@ -9,7 +9,10 @@ void w_console_print_installable_dictionaries (WApplication*);
 
 int w_console_install_dictionary (WApplication*, GError**);
 int w_console_uninstall_dictionary (WApplication*, GError**);
+int w_console_update_dictionary (WApplication*, GError**);
 int w_console_search (WApplication*, GError**);
+int w_console_batch_search (WApplication*, GError**);
+void w_console_print_stats (WApplication*, LwSearch*);
 
 #include "console-output.h"
 #include "console-callbacks.h"
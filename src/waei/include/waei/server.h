@@ -0,0 +1,12 @@
+#ifndef W_SERVER_INCLUDED
+#define W_SERVER_INCLUDED
+
+G_BEGIN_DECLS
+
+gchar* w_server_get_socket_path (WApplication*);
+gint w_server_run (WApplication*, GError**);
+gint w_server_client_search (WApplication*, GError**);
+
+G_END_DECLS
+
+#endif
@@ -5,5 +5,6 @@
 #include <waei/application.h>
 #include <waei/search-data.h>
 #include <waei/console.h>
+#include <waei/server.h>
 
 #endif
@@ -0,0 +1,507 @@
+/******************************************************************************
+    AUTHOR:
+    File written and Copyrighted by Zachary Dovel. All Rights Reserved.
+
+    LICENSE:
+    This file is part of gWaei.
+
+    gWaei is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    gWaei is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with gWaei.  If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+//!
+//! @file server.c
+//!
+//! @brief Lookup daemon and thin client over a Unix domain socket
+//!
+//! The daemon loads the dictionary list and regexes once and answers
+//! searches for as long as it runs.  Each message in either direction is
+//! a frame made of a 4 byte big endian payload length and the payload.
+//!
+//! A request payload is "dictionary\nflags\nquery" where dictionary may be
+//! empty for the default one and flags is a string of switch letters ('e'
+//! for exact, 'c' for colored output).  The results are formatted with the
+//! switches of the client, not those the server was started with.  A response payload is either "OK total relevant\n" followed
+//! by the formatted results or "ERROR message".  A client may send any
+//! number of requests over one connection.
+//!
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+
+#ifdef HAVE_CONFIG_H
+#include "../../config.h"
+#endif
+
+#ifdef G_OS_UNIX
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <glib-unix.h>
+#include <gio/gunixsocketaddress.h>
+#endif
+
+#include <waei/gettext.h>
+#include <waei/waei.h>
+
+#define W_SERVER_MAX_FRAME_SIZE (16 * 1024 * 1024)
+#define W_SERVER_MAX_THREADS 8
+
+
+//!
+//! @brief Gets the path of the socket the server listens on
+//! @returns A newly allocated path that should be freed with g_free
+//!
+gchar*
+w_server_get_socket_path (WApplication *application)
+{
+    //Declarations
+    const gchar *socket_switch_data;
+
+    //Initializations
+    socket_switch_data = w_application_get_socket_switch_data (application);
+
+    if (socket_switch_data != NULL)
+      return g_strdup (socket_switch_data);
+
+    return g_build_filename (g_get_user_runtime_dir (), "waei.socket", NULL);
+}
+
+
+#ifdef G_OS_UNIX
+
+//!
+//! @brief Reads one frame from a stream
+//! @returns The NUL terminated payload or NULL if the stream closed or errored
+//!
+static gchar*
+w_server_read_frame (GInputStream *stream, GError **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (stream != NULL, NULL);
+    if (error != NULL && *error != NULL) return NULL;
+
+    //Declarations
+    guint32 header;
+    gsize length;
+    gsize bytes_read;
+    gchar *payload;
+
+    //Initializations
+    bytes_read = 0;
+    payload = NULL;
+
+    if (!g_input_stream_read_all (stream, &header, sizeof(header), &bytes_read, NULL, error)) return NULL;
+    if (bytes_read == 0) return NULL;
+    if (bytes_read != sizeof(header))
+    {
+      *error = g_error_new (G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s", gettext("The connection was closed in the middle of a frame"));
+      return NULL;
+    }
+
+    length = GUINT32_FROM_BE (header);
+    if (length > W_SERVER_MAX_FRAME_SIZE)
+    {
+      *error = g_error_new (G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s", gettext("The frame is too large"));
+      return NULL;
+    }
+
+    payload = g_malloc (length + 1);
+    if (!g_input_stream_read_all (stream, payload, length, &bytes_read, NULL, error) || bytes_read != length)
+    {
+      if (*error == NULL)
+        *error = g_error_new (G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s", gettext("The connection was closed in the middle of a frame"));
+      g_free (payload); payload = NULL;
+      return NULL;
+    }
+    payload[length] = '\0';
+
+    return payload;
+}
+
+
+//!
+//! @brief Writes one frame to a stream
+//!
+static gboolean
+w_server_write_frame (GOutputStream *stream, const gchar *PAYLOAD, gsize length, GError **error)
+{
+    //Sanity checks
+    g_return_val_if_fail (stream != NULL, FALSE);
+    g_return_val_if_fail (PAYLOAD != NULL, FALSE);
+    if (error != NULL && *error != NULL) return FALSE;
+
+    //Declarations
+    guint32 header;
+
+    //Initializations
+    header = GUINT32_TO_BE ((guint32) length);
+
+    if (!g_output_stream_write_all (stream, &header, sizeof(header), NULL, NULL, error)) return FALSE;
+    if (!g_output_stream_write_all (stream, PAYLOAD, length, NULL, NULL, error)) return FALSE;
+
+    return g_output_stream_flush (stream, NULL, error);
+}
+
+
+//!
+//! @brief Searches for a request payload and builds the response payload
+//!
+static GString*
+w_server_handle_request (WApplication *application, const gchar *REQUEST)
+{
+    //Declarations
+    LwDictionaryList *dictionarylist;
+    LwDictionary *dictionary;
+    LwSearch *search;
+    LwSearchFlags flags;
+    GString *response;
+    GString *body;
+    GError *error;
+    gchar **fields;
+    gboolean color_switch;
+
+    //Initializations
+    dictionarylist = w_application_get_installed_dictionarylist (application);
+    fields = g_strsplit (REQUEST, "\n", 3);
+    response = g_string_sized_new (1024);
+    body = g_string_sized_new (1024);
+    error = NULL;
+    search = NULL;
+    flags = 0;
+
+    if (g_strv_length (fields) != 3)
+    {
+      g_string_append_printf (response, "ERROR %s", gettext("Malformed request"));
+      goto errored;
+    }
+
+    if (*fields[0] != '\0')
+      dictionary = lw_dictionarylist_get_dictionary_fuzzy (dictionarylist, fields[0]);
+    else
+      dictionary = lw_dictionarylist_get_dictionary_fuzzy (dictionarylist, NULL);
+    if (dictionary == NULL)
+    {
+      g_string_append_printf (response, "ERROR %s", gettext("Requested dictionary not found!"));
+      goto errored;
+    }
+
+    color_switch = (strchr (fields[1], 'c') != NULL);
+    if (strchr (fields[1], 'e') != NULL) flags |= LW_SEARCH_FLAG_EXACT;
+    if (color_switch) flags |= LW_SEARCH_FLAG_SPANS;
+
+    search = lw_search_new (dictionary, fields[2], flags, &error);
+    if (search == NULL)
+    {
+      g_string_append_printf (response, "ERROR %s", (error != NULL) ? error->message : gettext("Could not parse the query"));
+      goto errored;
+    }
+
+    lw_search_start (search, FALSE);
+    while (w_console_append_result_to_string_full (search, color_switch, body));
+
+    g_string_append_printf (response, "OK %d %d\n", lw_search_get_total_results (search), lw_search_get_total_relevant_results (search));
+    g_string_append_len (response, body->str, body->len);
+
+errored:
+
+    //Cleanup
+    if (search != NULL) lw_search_free (search); search = NULL;
+    if (error != NULL) g_error_free (error); error = NULL;
+    g_strfreev (fields); fields = NULL;
+    g_string_free (body, TRUE); body = NULL;
+
+    return response;
+}
+
+
+//!
+//! @brief Answers the requests of one client until it disconnects
+//!
+static gboolean
+w_server_run_cb (GThreadedSocketService *service, GSocketConnection *connection, GObject *source_object, gpointer data)
+{
+    //Declarations
+    WApplication *application;
+    GInputStream *input;
+    GOutputStream *output;
+    GString *response;
+    GError *error;
+    gchar *request;
+
+    //Initializations
+    application = W_APPLICATION (data);
+    input = g_io_stream_get_input_stream (G_IO_STREAM (connection));
+    output = g_io_stream_get_output_stream (G_IO_STREAM (connection));
+    error = NULL;
+
+    while ((request = w_server_read_frame (input, &error)) != NULL)
+    {
+      response = w_server_handle_request (application, request);
+      w_server_write_frame (output, response->str, response->len, &error);
+
+      g_free (request); request = NULL;
+      g_string_free (response, TRUE); response = NULL;
+
+      if (error != NULL) break;
+    }
+
+    if (error != NULL)
+    {
+      if (!w_application_get_quiet_switch (application))
+        fprintf (stderr, "%s\n", error->message);
+      g_error_free (error); error = NULL;
+    }
+
+    return TRUE;
+}
+
+
+static gboolean
+w_server_quit_cb (gpointer data)
+{
+    g_main_loop_quit ((GMainLoop*) data);
+
+    return FALSE;
+}
+
+
+//!
+//! @brief Checks if another server already answers on a socket path
+//!
+static gboolean
+w_server_is_listening (const gchar *PATH)
+{
+    //Declarations
+    GSocketClient *client;
+    GSocketAddress *address;
+    GSocketConnection *connection;
+
+    //Initializations
+    client = g_socket_client_new ();
+    address = g_unix_socket_address_new (PATH);
+    connection = g_socket_client_connect (client, G_SOCKET_CONNECTABLE (address), NULL, NULL);
+
+    //Cleanup
+    if (connection != NULL) g_object_unref (connection);
+    g_object_unref (address); address = NULL;
+    g_object_unref (client); client = NULL;
+
+    return (connection != NULL);
+}
+
+
+//!
+//! @brief Keeps waei loaded and answers searches from local clients
+//!
+gint
+w_server_run (WApplication *application, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return 1;
+
+    //Declarations
+    GSocketService *service;
+    GSocketAddress *address;
+    GMainLoop *loop;
+    gchar *path;
+    mode_t mask;
+    gboolean listening;
+    gint resolution;
+
+    //Initializations
+    path = w_server_get_socket_path (application);
+    service = NULL;
+    address = NULL;
+    loop = NULL;
+    resolution = 1;
+
+    //Load everything that can be shared between searches up front
+    if (lw_dictionarylist_get_total (w_application_get_installed_dictionarylist (application)) == 0)
+    {
+      fprintf (stderr, "%s\n", gettext("No dictionaries are installed!"));
+      goto errored;
+    }
+
+    if (w_server_is_listening (path))
+    {
+      *error = g_error_new (G_IO_ERROR, G_IO_ERROR_ADDRESS_IN_USE, gettext("A waei server is already listening on %s"), path);
+      goto errored;
+    }
+    g_unlink (path);
+
+    service = g_threaded_socket_service_new (W_SERVER_MAX_THREADS);
+    address = g_unix_socket_address_new (path);
+
+    //Bind under an owner only umask so the socket never exists with looser permissions
+    mask = umask (0077);
+    listening = g_socket_listener_add_address (G_SOCKET_LISTENER (service), address, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, NULL, NULL, error);
+    umask (mask);
+    if (!listening) goto errored;
+
+    g_signal_connect (G_OBJECT (service), "run", G_CALLBACK (w_server_run_cb), application);
+
+    loop = g_main_loop_new (NULL, FALSE);
+    g_unix_signal_add (SIGINT, w_server_quit_cb, loop);
+    g_unix_signal_add (SIGTERM, w_server_quit_cb, loop);
+
+    if (!w_application_get_quiet_switch (application))
+      printf (gettext("Listening on %s\n"), path);
+
+    g_socket_service_start (service);
+    g_main_loop_run (loop);
+    g_socket_service_stop (service);
+
+    g_socket_listener_close (G_SOCKET_LISTENER (service));
+    g_unlink (path);
+    resolution = 0;
+
+errored:
+
+    //Cleanup
+    if (loop != NULL) g_main_loop_unref (loop); loop = NULL;
+    if (address != NULL) g_object_unref (address); address = NULL;
+    if (service != NULL) g_object_unref (service); service = NULL;
+    g_free (path); path = NULL;
+
+    return resolution;
+}
+
+
+//!
+//! @brief Sends the query to a running server and prints its answer
+//!
+//! Falls back to searching in process when no server is listening.
+//!
+gint
+w_server_client_search (WApplication *application, GError **error)
+{
+    //Sanity check
+    if (error != NULL && *error != NULL) return 1;
+
+    //Declarations
+    GSocketClient *client;
+    GSocketAddress *address;
+    GSocketConnection *connection;
+    const gchar *dictionary_switch_data;
+    const gchar *query_text_data;
+    gboolean quiet_switch;
+    gchar *path;
+    gchar *request;
+    gchar *response;
+    gchar *body;
+    gint total_results;
+    gint total_relevant_results;
+    gint resolution;
+
+    //Initializations
+    dictionary_switch_data = w_application_get_dictionary_switch_data (application);
+    query_text_data = w_application_get_query_text_data (application);
+    quiet_switch = w_application_get_quiet_switch (application);
+    path = w_server_get_socket_path (application);
+    client = g_socket_client_new ();
+    address = g_unix_socket_address_new (path);
+    connection = g_socket_client_connect (client, G_SOCKET_CONNECTABLE (address), NULL, NULL);
+    request = NULL;
+    response = NULL;
+    resolution = 1;
+
+    if (connection == NULL)
+    {
+      if (!quiet_switch)
+        fprintf (stderr, gettext("No waei server is listening on %s.  Searching without it.\n"), path);
+      resolution = w_console_search (application, error);
+      goto errored;
+    }
+
+    request = g_strdup_printf ("%s\n%s%s\n%s",
+      (dictionary_switch_data != NULL) ? dictionary_switch_data : "",
+      (w_application_get_exact_switch (application)) ? "e" : "",
+      (w_application_get_color_switch (application)) ? "c" : "",
+      query_text_data
+    );
+
+    if (!w_server_write_frame (g_io_stream_get_output_stream (G_IO_STREAM (connection)), request, strlen (request), error))
+      goto errored;
+
+    response = w_server_read_frame (g_io_stream_get_input_stream (G_IO_STREAM (connection)), error);
+    if (response == NULL) goto errored;
+
+    if (strncmp (response, "ERROR ", strlen ("ERROR ")) == 0)
+    {
+      fprintf (stderr, "%s\n", response + strlen ("ERROR "));
+      goto errored;
+    }
+
+    body = strchr (response, '\n');
+    if (body == NULL || sscanf (response, "OK %d %d", &total_results, &total_relevant_results) != 2)
+    {
+      *error = g_error_new (G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s", gettext("The server sent a malformed response"));
+      goto errored;
+    }
+
+    fputs (body + 1, stdout);
+
+    if (!quiet_switch && total_results == 0)
+    {
+      printf ("%s\n\n", gettext("No results found!"));
+    }
+    else if (!quiet_switch)
+    {
+      printf (ngettext("Found %d result", "Found %d results", total_results), total_results);
+      if (total_relevant_results != total_results)
+        printf (ngettext("(%d Relevant)", "(%d Relevant)", total_relevant_results), total_relevant_results);
+      printf ("\n");
+    }
+
+    resolution = 0;
+
+errored:
+
+    //Cleanup
+    if (connection != NULL) g_object_unref (connection); connection = NULL;
+    g_object_unref (address); address = NULL;
+    g_object_unref (client); client = NULL;
+    g_free (request); request = NULL;
+    g_free (response); response = NULL;
+    g_free (path); path = NULL;
+
+    return resolution;
+}
+
+#else
+
+gint
+w_server_run (WApplication *application, GError **error)
+{
+    if (error != NULL && *error != NULL) return 1;
+
+    *error = g_error_new (G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "%s", gettext("The waei server needs Unix domain sockets"));
+
+    return 1;
+}
+
+
+gint
+w_server_client_search (WApplication *application, GError **error)
+{
+    return w_console_search (application, error);
+}
+
+#endif
@@ -46,6 +46,9 @@ main (int argc, char *argv[])
 {
     GObject *application;
     int resolution;
+    gint64 start_time;
+
+    start_time = g_get_monotonic_time ();
 
     setlocale(LC_ALL, "");
     bindtextdomain(GETTEXT_PACKAGE, GWAEI_LOCALEDIR);
@@ -55,6 +58,7 @@ main (int argc, char *argv[])
     g_type_init ();
 
     application = w_application_new ();
+    w_application_set_start_time (W_APPLICATION (application), start_time);
     resolution = w_application_run (W_APPLICATION (application), &argc, &argv);
 
     g_object_unref (application);